@@ -0,0 +1,288 @@
+/* Mixer micro-benchmark (ft2-mixbench, built by CMakeLists.txt)
+**
+** Runs every mixFuncTab entry (stereo/center, volume ramping on/off, 8-bit/16-bit,
+** 5 interpolation types, no loop/loop/bidi loop) on a synthetic voice and reports
+** the mixing cost in nanoseconds per output sample, and how many voices one CPU
+** core could mix in real-time at 44.1kHz, 48kHz and 96kHz.
+**
+** The sample data is generated from a fixed seed and every entry is timed several
+** times (the best run is kept), so that numbers can be compared between runs.
+** This only links the mixer, no video/audio output is opened.
+*/
+
+#define SDL_MAIN_HANDLED // plain main(), no SDL2main needed
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include "../ft2_audio.h"
+#include "../ft2_structs.h"
+#include "../ft2_config.h" // INTERPOLATION_*
+#include "../mixer/ft2_mix.h"
+#include "../mixer/ft2_cubic_spline.h"
+#include "../mixer/ft2_windowed_sinc.h"
+
+#define BENCH_SAMPLE_LENGTH 65536
+#define BENCH_LOOP_START 1024
+#define BENCH_LOOP_LENGTH 16384
+#define BENCH_SAMPLE_HZ 22050.0 // playback rate of the synthetic sample (resampling ratio ~0.23..0.5)
+#define BENCH_BLOCK_SAMPLES 1024 // samples per mixer call (a typical audio callback chunk)
+
+// the mixer needs these (normally found in ft2_audio.c/ft2_structs.c/ft2_video.c)
+audio_t audio;
+cpu_t cpu;
+
+void showErrorMsgBox(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+static const char *interpolationNames[5] = { "none", "sinc8", "linear", "sinc16", "cubic" };
+static const char *loopTypeNames[3] = { "noloop", "loop", "bidi" };
+static const uint32_t benchRates[3] = { 44100, 48000, 96000 };
+
+static int8_t *smpData8;
+static int16_t *smpData16;
+static int8_t leftEdgeTaps8[32];
+static int16_t leftEdgeTaps16[32];
+static uint32_t randSeed = 0x12345678;
+
+static int32_t getRandom(void)
+{
+	randSeed = (randSeed * 134775813) + 1;
+	return (int32_t)randSeed;
+}
+
+static bool setupSampleData(void)
+{
+	// same padding as real samples (ft2_header.h), so that all interpolation taps stay in bounds
+	smpData8 = (int8_t *)malloc(BENCH_SAMPLE_LENGTH + SAMPLE_PAD_LENGTH);
+	smpData16 = (int16_t *)malloc((BENCH_SAMPLE_LENGTH + SAMPLE_PAD_LENGTH) * sizeof (int16_t));
+	if (smpData8 == NULL || smpData16 == NULL)
+		return false;
+
+	for (int32_t i = 0; i < BENCH_SAMPLE_LENGTH + SAMPLE_PAD_LENGTH; i++)
+	{
+		const int32_t smp = getRandom() >> 16;
+		smpData8[i] = (int8_t)(smp >> 8);
+		smpData16[i] = (int16_t)smp;
+	}
+
+	for (int32_t i = 0; i < 32; i++)
+	{
+		leftEdgeTaps8[i] = smpData8[SMP_DAT_OFFSET + BENCH_LOOP_START + i - MAX_LEFT_TAPS];
+		leftEdgeTaps16[i] = smpData16[SMP_DAT_OFFSET + BENCH_LOOP_START + i - MAX_LEFT_TAPS];
+	}
+
+	return true;
+}
+
+static void setupVoice(voice_t *v, uint32_t outputRate, int32_t sample16Bit, int32_t interpolation, int32_t loopType)
+{
+	memset(v, 0, sizeof (voice_t));
+
+	const int32_t loopEnd = BENCH_LOOP_START + BENCH_LOOP_LENGTH;
+
+	v->base8 = smpData8 + SMP_DAT_OFFSET;
+	v->revBase8 = &v->base8[BENCH_LOOP_START + loopEnd];
+	v->leftEdgeTaps8 = leftEdgeTaps8 + MAX_LEFT_TAPS;
+	v->base16 = smpData16 + SMP_DAT_OFFSET;
+	v->revBase16 = &v->base16[BENCH_LOOP_START + loopEnd];
+	v->leftEdgeTaps16 = leftEdgeTaps16 + MAX_LEFT_TAPS;
+
+	v->loopType = (uint8_t)loopType;
+	v->sampleEnd = (loopType == LOOP_OFF) ? BENCH_SAMPLE_LENGTH : loopEnd;
+	v->loopStart = BENCH_LOOP_START;
+	v->loopLength = BENCH_LOOP_LENGTH;
+	v->delta = (intCPUWord_t)(((BENCH_SAMPLE_HZ / outputRate) * MIXER_FRAC_SCALE) + 0.5);
+	v->mixFuncOffset = (uint8_t)((sample16Bit * 15) + (interpolation * 3) + loopType);
+
+	// same LUT selection as updateVoices() (ft2_audio.c)
+	float *fSincLUTs[3];
+	if (interpolation == INTERPOLATION_SINC16)
+	{
+		fSincLUTs[0] = fKaiserSinc_16;
+		fSincLUTs[1] = fDownSample1_16;
+		fSincLUTs[2] = fDownSample2_16;
+	}
+	else
+	{
+		fSincLUTs[0] = fKaiserSinc_8;
+		fSincLUTs[1] = fDownSample1_8;
+		fSincLUTs[2] = fDownSample2_8;
+	}
+
+	if (v->delta <= (uintCPUWord_t)(1.1875 * MIXER_FRAC_SCALE))
+		v->fSincLUT = fSincLUTs[0];
+	else if (v->delta <= (uintCPUWord_t)(1.5 * MIXER_FRAC_SCALE))
+		v->fSincLUT = fSincLUTs[1];
+	else
+		v->fSincLUT = fSincLUTs[2];
+
+	v->fVolume = v->fCurrVolumeL = v->fCurrVolumeR = 0.5f;
+	v->active = true;
+}
+
+// returns nanoseconds per output sample (best of numRuns)
+static double benchMixFunc(mixFunc mixRoutine, const voice_t *voiceTemplate, bool volRamp, uint32_t numSamples, int32_t numRuns)
+{
+	voice_t v;
+	double dBestTime = -1.0;
+
+	const uint32_t numBlocks = (numSamples + (BENCH_BLOCK_SAMPLES-1)) / BENCH_BLOCK_SAMPLES;
+	const double dPerfFreqMulNs = 1000000000.0 / (double)SDL_GetPerformanceFrequency();
+
+	for (int32_t run = -1; run < numRuns; run++) // run -1 = warm-up
+	{
+		memcpy(&v, voiceTemplate, sizeof (voice_t));
+		memset(audio.fMixBufferL, 0, (BENCH_BLOCK_SAMPLES * 2) * sizeof (float));
+
+		const uint64_t time64 = SDL_GetPerformanceCounter();
+		for (uint32_t i = 0; i < numBlocks; i++)
+		{
+			if (!v.active) // non-looping sample ended, restart it
+				memcpy(&v, voiceTemplate, sizeof (voice_t));
+
+			if (volRamp) // keep ramping forever, but with (nearly) constant volume
+			{
+				v.fCurrVolumeL = v.fCurrVolumeR = 0.5f;
+				v.fVolumeLDelta = v.fVolumeRDelta = 1.0f / (1 << 24);
+				v.volumeRampLength = UINT32_MAX;
+			}
+
+			mixRoutine(&v, 0, BENCH_BLOCK_SAMPLES);
+		}
+		const double dTime = (SDL_GetPerformanceCounter() - time64) * dPerfFreqMulNs;
+
+		if (run >= 0 && (dBestTime < 0.0 || dTime < dBestTime))
+			dBestTime = dTime;
+	}
+
+	return dBestTime / (numBlocks * BENCH_BLOCK_SAMPLES);
+}
+
+static void printUsage(void)
+{
+	printf("Usage: ft2-mixbench [--samples <n>] [--runs <n>] [--no-avx2]\n\n" \
+	       "  --samples <n>   output samples mixed per measurement (default: 1048576)\n" \
+	       "  --runs <n>      measurements per mixer routine, the best one is kept (default: 5)\n" \
+	       "  --no-avx2       don't use the AVX2/FMA mixers even if the CPU supports them\n");
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t numSamples = 1 << 20;
+	int32_t numRuns = 5;
+	bool noAVX2 = false;
+
+	for (int32_t i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--samples") && i+1 < argc)
+		{
+			numSamples = (uint32_t)atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--runs") && i+1 < argc)
+		{
+			numRuns = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--no-avx2"))
+		{
+			noAVX2 = true;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (numSamples < BENCH_BLOCK_SAMPLES)
+		numSamples = BENCH_BLOCK_SAMPLES;
+
+	if (numRuns < 1)
+		numRuns = 1;
+
+	cpu.hasSSE = SDL_HasSSE();
+	cpu.hasSSE2 = SDL_HasSSE2();
+	cpu.hasAVX2 = noAVX2 ? false : SDL_HasAVX2();
+	cpu.hasFMA = cpuHasFMA();
+	selectMixFuncs();
+
+	// one allocation for both layouts (see MIXER_INTERLEAVED_BUFFER in ft2_mix.h)
+	audio.fMixBufferL = (float *)malloc((BENCH_BLOCK_SAMPLES * 2) * sizeof (float));
+	audio.fMixBufferR = audio.fMixBufferL + (MIXER_INTERLEAVED_BUFFER ? 1 : BENCH_BLOCK_SAMPLES);
+
+	if (audio.fMixBufferL == NULL ||
+		!setupSampleData() || !calcCubicSplineTable() || !calcWindowedSincTables())
+	{
+		fprintf(stderr, "Error: Not enough memory!\n");
+		return 1;
+	}
+
+#if MIXER_HAS_AVX2
+	const char *mixerName = (mixFuncTab == mixFuncTabAVX2) ? "AVX2/FMA" : "SSE2";
+#elif defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	const char *mixerName = "SSE2";
+#else
+	const char *mixerName = "C";
+#endif
+
+	printf("ft2-mixbench: %s mixers, %u samples per measurement, best of %d runs\n", mixerName, numSamples, numRuns);
+	printf("ns/smp = nanoseconds per output sample, voices = voices per CPU core in real-time\n\n");
+	printf("%-40s", "routine");
+	for (int32_t r = 0; r < 3; r++)
+		printf(" | %6.1fkHz: ns/smp  voices", benchRates[r] / 1000.0);
+	printf("\n");
+
+	// same order/indexing as in mixFuncTab (see doChannelMixing() in ft2_audio.c)
+	for (int32_t center = 0; center < 2; center++)
+	{
+		for (int32_t ramp = 0; ramp < 2; ramp++)
+		{
+			for (int32_t bit16 = 0; bit16 < 2; bit16++)
+			{
+				for (int32_t interpolation = 0; interpolation < 5; interpolation++)
+				{
+					for (int32_t loopType = 0; loopType < 3; loopType++)
+					{
+						char name[64];
+						sprintf(name, "%s %s %s %s %s", center ? "center" : "stereo", ramp ? "ramp" : "noramp",
+							bit16 ? "16-bit" : "8-bit", interpolationNames[interpolation], loopTypeNames[loopType]);
+						printf("%-40s", name);
+
+						for (int32_t r = 0; r < 3; r++)
+						{
+							voice_t v;
+							setupVoice(&v, benchRates[r], bit16, interpolation, loopType);
+
+							const mixFunc mixRoutine = mixFuncTab[(center * (3*5*2*2)) + (ramp * (3*5*2)) + v.mixFuncOffset];
+							const double dNsPerSample = benchMixFunc(mixRoutine, &v, !!ramp, numSamples, numRuns);
+							const double dVoicesPerCore = 1000000000.0 / (dNsPerSample * benchRates[r]);
+
+							printf(" |         %8.2f %7.0f", dNsPerSample, dVoicesPerCore);
+						}
+
+						printf("\n");
+						fflush(stdout);
+					}
+				}
+			}
+		}
+	}
+
+	freeCubicSplineTable();
+	freeWindowedSincTables();
+	free(audio.fMixBufferL);
+	free(smpData8);
+	free(smpData16);
+
+	return 0;
+}
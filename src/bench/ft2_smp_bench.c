@@ -0,0 +1,242 @@
+/* Sample conversion kernel test/benchmark (ft2-smpbench, built by CMakeLists.txt)
+**
+** Runs every kernel in ft2_smp_kernels.h (C, SSE2 and AVX2 versions, if supported by the
+** CPU) on random data and checks that the output is byte-exact against the C versions.
+** Lengths that aren't a multiple of the vector size, unaligned buffers and in-place
+** conversion are tested as well. Then each kernel is timed and the throughput is printed.
+**
+** Returns 0 if all kernels give the same output, 1 otherwise ("--check" skips the timing).
+*/
+
+#define SDL_MAIN_HANDLED // plain main(), no SDL2main needed
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "../ft2_structs.h"
+#include "../ft2_smp_kernels.h"
+
+#define BENCH_BUFFER_BYTES (1 << 22) // 4MB of sample data per kernel call
+#define BENCH_OFFSET 3 // extra bytes for misaligned buffers
+
+// the kernel selection needs this (normally found in ft2_structs.c)
+cpu_t cpu;
+
+enum
+{
+	KERNEL_DELTA_DECODE8,
+	KERNEL_DELTA_DECODE16,
+	KERNEL_DELTA_DECODE_STEREO8,
+	KERNEL_DELTA_DECODE_STEREO16,
+	KERNEL_DELTA_ENCODE8,
+	KERNEL_DELTA_ENCODE16,
+	KERNEL_FLIP_SIGN8,
+	KERNEL_FLIP_SIGN16,
+	KERNEL_FLIP_SIGN_STEREO8,
+	KERNEL_FLIP_SIGN_STEREO16,
+
+	NUM_KERNELS
+};
+
+static const char *kernelNames[NUM_KERNELS] =
+{
+	"deltaDecode8", "deltaDecode16", "deltaDecodeStereo8", "deltaDecodeStereo16",
+	"deltaEncode8", "deltaEncode16",
+	"flipSign8", "flipSign16", "flipSignStereo8", "flipSignStereo16"
+};
+
+static uint8_t *srcData, *dstData;
+static uint32_t randSeed = 0x12345678;
+
+static uint8_t getRandomByte(void)
+{
+	randSeed = (randSeed * 134775813) + 1;
+	return (uint8_t)(randSeed >> 24);
+}
+
+/* Runs kernel 'k' on 'bytes' bytes of 'buf' (at an offset, to test unaligned buffers).
+** Stereo kernels use the first half as left channel and the second half as right channel.
+** Delta encoding and sign flipping are in place, and so is delta decoding if 'inPlace' is set.
+*/
+static void runKernel(const smpKernels_t *kernels, int32_t k, uint8_t *buf, const uint8_t *src, int32_t bytes, bool inPlace)
+{
+	const int8_t *src8 = inPlace ? (const int8_t *)buf : (const int8_t *)src;
+	int8_t *dst8 = (int8_t *)buf;
+	int16_t *dst16 = (int16_t *)buf;
+
+	switch (k)
+	{
+		case KERNEL_DELTA_DECODE8: kernels->deltaDecode8(dst8, src8, bytes); break;
+		case KERNEL_DELTA_DECODE16: kernels->deltaDecode16(dst16, src8, bytes >> 1); break;
+		case KERNEL_DELTA_DECODE_STEREO8: kernels->deltaDecodeStereo8(dst8, src8, src8 + (bytes >> 1), bytes >> 1); break;
+		case KERNEL_DELTA_DECODE_STEREO16: kernels->deltaDecodeStereo16(dst16, src8, src8 + ((bytes >> 2) << 1), bytes >> 2); break;
+		case KERNEL_DELTA_ENCODE8: kernels->deltaEncode8(dst8, bytes); break;
+		case KERNEL_DELTA_ENCODE16: kernels->deltaEncode16(dst16, bytes >> 1); break;
+		case KERNEL_FLIP_SIGN8: kernels->flipSign8(dst8, bytes); break;
+		case KERNEL_FLIP_SIGN16: kernels->flipSign16(dst16, bytes >> 1); break;
+		case KERNEL_FLIP_SIGN_STEREO8: kernels->flipSignStereo8(dst8, dst8, dst8 + (bytes >> 1), bytes >> 1); break;
+		case KERNEL_FLIP_SIGN_STEREO16: kernels->flipSignStereo16(dst16, dst16, dst16 + (bytes >> 2), bytes >> 2); break;
+		default: break;
+	}
+}
+
+static bool kernelIsInPlace(int32_t k)
+{
+	return k >= KERNEL_DELTA_ENCODE8;
+}
+
+static bool checkKernel(const smpKernels_t *kernels, int32_t k, int32_t bytes, int32_t offset, bool inPlace)
+{
+	static uint8_t refBuf[4096+BENCH_OFFSET], testBuf[4096+BENCH_OFFSET], testSrc[4096+BENCH_OFFSET];
+
+	// 16-bit 'dst' buffers must be 2-byte aligned
+	const int32_t dstOffset = (k & 1) ? (offset & ~1) : offset;
+
+	for (int32_t i = 0; i < bytes; i++)
+		testSrc[offset+i] = getRandomByte();
+
+	memcpy(&refBuf[dstOffset], &testSrc[offset], bytes);
+	memcpy(&testBuf[dstOffset], &testSrc[offset], bytes);
+
+	runKernel(&smpKernelsC, k, &refBuf[dstOffset], &testSrc[offset], bytes, inPlace || kernelIsInPlace(k));
+	runKernel(kernels, k, &testBuf[dstOffset], &testSrc[offset], bytes, inPlace || kernelIsInPlace(k));
+
+	if (memcmp(&refBuf[dstOffset], &testBuf[dstOffset], bytes) != 0)
+	{
+		printf("MISMATCH: %s %s (%d bytes, offset %d%s)\n", kernels->name, kernelNames[k], bytes, offset, inPlace ? ", in place" : "");
+		return false;
+	}
+
+	return true;
+}
+
+static bool checkKernels(const smpKernels_t *kernels)
+{
+	bool ok = true;
+	for (int32_t k = 0; k < NUM_KERNELS; k++)
+	{
+		for (int32_t bytes = 0; bytes <= 4096; bytes += (bytes < 256) ? 1 : 251)
+		{
+			for (int32_t offset = 0; offset <= BENCH_OFFSET; offset++)
+			{
+				ok &= checkKernel(kernels, k, bytes, offset, false);
+				ok &= checkKernel(kernels, k, bytes, offset, true);
+			}
+		}
+	}
+
+	return ok;
+}
+
+// returns throughput in MB/s (best of numRuns)
+static double benchKernel(const smpKernels_t *kernels, int32_t k, int32_t numRuns)
+{
+	double dBestTime = -1.0;
+	const double dPerfFreqMulSec = 1.0 / (double)SDL_GetPerformanceFrequency();
+
+	for (int32_t run = -1; run < numRuns; run++) // run -1 = warm-up
+	{
+		const uint64_t time64 = SDL_GetPerformanceCounter();
+		runKernel(kernels, k, dstData, srcData, BENCH_BUFFER_BYTES, false);
+		const double dTime = (SDL_GetPerformanceCounter() - time64) * dPerfFreqMulSec;
+
+		if (run >= 0 && (dBestTime < 0.0 || dTime < dBestTime))
+			dBestTime = dTime;
+	}
+
+	return (BENCH_BUFFER_BYTES / (1024.0 * 1024.0)) / dBestTime;
+}
+
+static void printUsage(void)
+{
+	printf("Usage: ft2-smpbench [--check] [--runs <n>]\n\n" \
+	       "  --check         only check the kernels against the C versions (no timing)\n" \
+	       "  --runs <n>      measurements per kernel, the best one is kept (default: 10)\n");
+}
+
+int main(int argc, char *argv[])
+{
+	int32_t numRuns = 10;
+	bool checkOnly = false;
+
+	for (int32_t i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--check"))
+		{
+			checkOnly = true;
+		}
+		else if (!strcmp(argv[i], "--runs") && i+1 < argc)
+		{
+			numRuns = atoi(argv[++i]);
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (numRuns < 1)
+		numRuns = 1;
+
+	cpu.hasSSE = SDL_HasSSE();
+	cpu.hasSSE2 = SDL_HasSSE2();
+	cpu.hasAVX2 = SDL_HasAVX2();
+
+	const smpKernels_t *kernelSets[3];
+	int32_t numKernelSets = 0;
+
+	kernelSets[numKernelSets++] = &smpKernelsC;
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	kernelSets[numKernelSets++] = &smpKernelsSSE2;
+#endif
+#if SMP_KERNELS_HAS_AVX2
+	if (cpu.hasAVX2)
+		kernelSets[numKernelSets++] = &smpKernelsAVX2;
+#endif
+
+	bool ok = true;
+	for (int32_t i = 1; i < numKernelSets; i++)
+	{
+		const bool setOk = checkKernels(kernelSets[i]);
+		printf("%s kernels: %s\n", kernelSets[i]->name, setOk ? "OK (byte-exact)" : "FAILED");
+		ok &= setOk;
+	}
+
+	if (checkOnly)
+		return ok ? 0 : 1;
+
+	srcData = (uint8_t *)malloc(BENCH_BUFFER_BYTES);
+	dstData = (uint8_t *)malloc(BENCH_BUFFER_BYTES);
+	if (srcData == NULL || dstData == NULL)
+	{
+		fprintf(stderr, "Error: Not enough memory!\n");
+		return 1;
+	}
+
+	for (int32_t i = 0; i < BENCH_BUFFER_BYTES; i++)
+		srcData[i] = getRandomByte();
+	memcpy(dstData, srcData, BENCH_BUFFER_BYTES);
+
+	printf("\n%-22s", "kernel (MB/s)");
+	for (int32_t i = 0; i < numKernelSets; i++)
+		printf(" %10s", kernelSets[i]->name);
+	printf("\n");
+
+	for (int32_t k = 0; k < NUM_KERNELS; k++)
+	{
+		printf("%-22s", kernelNames[k]);
+		for (int32_t i = 0; i < numKernelSets; i++)
+			printf(" %10.0f", benchKernel(kernelSets[i], k, numRuns));
+
+		printf("\n");
+		fflush(stdout);
+	}
+
+	free(srcData);
+	free(dstData);
+
+	return ok ? 0 : 1;
+}
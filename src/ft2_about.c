@@ -97,6 +97,7 @@ static void aboutInit(void)
 static void blendPixel(int32_t x, int32_t y, int32_t r, int32_t g, int32_t b, int32_t alpha)
 {
 	uint32_t *p = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, 1, 1);
 
 	const uint32_t srcPixel = *p;
 
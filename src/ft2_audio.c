@@ -5,6 +5,12 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 #include "ft2_header.h"
 #include "ft2_config.h"
 #include "scopes/ft2_scopes.h"
@@ -27,15 +33,59 @@ static int32_t smpShiftValue;
 static uint32_t oldAudioFreq, tickTimeLenInt;
 static uint64_t tickTimeLenFrac;
 static float fAudioNormalizeMul, fSqrtPanningTable[256+1];
+static uint32_t ditherSeeds[8] = { 0x12345678, 0x9ABCDEF1, 0x2468ACE1, 0x13579BDF, 0xFEDCBA98, 0x76543210, 0x0F1E2D3C, 0x4B5A6978 };
 static voice_t voice[MAX_CHANNELS * 2];
 
+/* Channel bitmasks (bit n = channel n):
+** activeChannelMask: the channel's voice and/or fadeout voice may be active. Bits are set when a
+**   voice is started, and cleared by doChannelMixing() once both voices have stopped.
+** syncChannelMask: the channel got a status update (updateVoices() -> fillVisualsSyncBuffer()).
+*/
+#define CHANNEL_MASK_WORDS ((MAX_CHANNELS + 31) / 32)
+static uint32_t activeChannelMask[CHANNEL_MASK_WORDS], syncChannelMask[CHANNEL_MASK_WORDS];
+static uint32_t lastSyncChannelMask[CHANNEL_MASK_WORDS];
+static bool fullVisualsSyncUpdate = true;
+
 // globalized
 audio_t audio;
+audioStats_t audioStats;
 pattSyncData_t *pattSyncEntry;
 chSyncData_t *chSyncEntry;
 chSync_t chSync;
 pattSync_t pattSync;
-volatile bool pattQueueClearing, chQueueClearing;
+
+// optional render-ahead thread, mixes ahead into a ring buffer that the audio callback copies from
+typedef struct renderAhead_t
+{
+	volatile bool active, running, quit;
+	SDL_atomic_t readPos, writePos; // in samples (stereo frames)
+	int32_t mask, targetSamples, chunkSamples;
+	uint8_t *ringBuffer, *chunkBuffer;
+	SDL_Thread *thread;
+	SDL_mutex *mutex; // held while rendering, also taken by lockAudio()
+	SDL_sem *sem;
+} renderAhead_t;
+
+static renderAhead_t renderAhead;
+
+static int32_t renderAheadBufferedSamples(void)
+{
+	return (SDL_AtomicGet(&renderAhead.writePos) - SDL_AtomicGet(&renderAhead.readPos)) & renderAhead.mask;
+}
+
+static void flushRenderAheadBuffer(void) // audio callback and render-ahead thread must be locked
+{
+	SDL_AtomicSet(&renderAhead.readPos, 0);
+	SDL_AtomicSet(&renderAhead.writePos, 0);
+}
+
+// audio/video sync queue state only touched by the audio thread (or while it is locked)
+static bool chSyncFullUpdate = true;
+static syncedChannel_t lastSyncedChannel[MAX_CHANNELS];
+
+// the video thread's copies (slots in the queues can be reused as soon as they are popped)
+static pattSyncData_t pattSyncState;
+static chSyncData_t chSyncState;
 
 void resetCachedMixerVars(void)
 {
@@ -48,6 +98,22 @@ void resetCachedMixerVars(void)
 		v->oldDelta = 0;
 }
 
+static inline int32_t lowestSetBit(uint32_t x) // 'x' must not be zero
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, x);
+	return (int32_t)index;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+
+static inline void setChannelBit(uint32_t *mask, int32_t ch)
+{
+	mask[ch >> 5] |= 1UL << (ch & 31);
+}
+
 void stopVoice(int32_t i)
 {
 	voice_t *v;
@@ -63,6 +129,36 @@ void stopVoice(int32_t i)
 	v->panning = 128;
 }
 
+// used by freeRetiredSmpData() (ft2_sample_ed.c), audio thread must be locked
+bool isSmpDataUsedByVoices(const int8_t *dataPtr)
+{
+	const voice_t *v = voice;
+	for (int32_t i = 0; i < MAX_CHANNELS*2; i++, v++)
+	{
+		if (v->active && (v->base8 == dataPtr || v->base16 == (const int16_t *)dataPtr))
+			return true;
+	}
+
+	return false;
+}
+
+/* Voices still playing a replaced sample read its left edge taps from the old sample header,
+** which is about to be overwritten. Point them to a copy of the taps instead.
+** Used by replaceSample() (ft2_sample_ed.c), audio thread must be locked.
+*/
+void moveVoiceLeftEdgeTaps(const sample_t *s, const int8_t *taps8, const int16_t *taps16)
+{
+	voice_t *v = voice;
+	for (int32_t i = 0; i < MAX_CHANNELS*2; i++, v++)
+	{
+		if (v->leftEdgeTaps8 == s->leftEdgeTapSamples8 + MAX_LEFT_TAPS)
+			v->leftEdgeTaps8 = taps8 + MAX_LEFT_TAPS;
+
+		if (v->leftEdgeTaps16 == s->leftEdgeTapSamples16 + MAX_LEFT_TAPS)
+			v->leftEdgeTaps16 = taps16 + MAX_LEFT_TAPS;
+	}
+}
+
 bool setNewAudioSettings(void) // only call this from the main input/video thread
 {
 	pauseAudio();
@@ -262,6 +358,9 @@ static void voiceUpdateVolumes(int32_t i, uint8_t status)
 			f->fVolumeRDelta = fVolumeRDiff / fVolumeRampLength;
 
 			f->isFadeOutVoice = true;
+
+			if (f->active)
+				setChannelBit(activeChannelMask, i);
 		}
 
 		// make current voice fade in from zero when it starts
@@ -337,6 +436,8 @@ static void voiceTrigger(int32_t ch, sample_t *s, int32_t position)
 
 	v->mixFuncOffset = ((int32_t)sample16Bit * 15) + (audio.interpolationType * 3) + loopType;
 	v->active = true;
+
+	setChannelBit(activeChannelMask, ch);
 }
 
 void resetRampVolumes(void)
@@ -362,6 +463,7 @@ void updateVoices(void)
 			continue;
 
 		ch->status = 0;
+		setChannelBit(syncChannelMask, i);
 
 		if (status & IS_Vol)
 		{
@@ -414,15 +516,178 @@ void updateVoices(void)
 	}
 }
 
+/* The output stage normalizes the mix buffers, converts/clamps them to the output format,
+** interleaves them and clears them for the next round, all in one pass.
+**
+** The 16-bit output can optionally be dithered (config: DITHER_16BIT_OUTPUT). This is TPDF dither,
+** the sum of two uniform random values (xorshift32, -0.5..0.5 LSB) added before rounding.
+*/
+
+static inline uint32_t xorshift32(uint32_t x)
+{
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+static inline __m128i xorshift32SSE2(__m128i x)
+{
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+	return x;
+}
+#endif
+
 static void sendSamples16BitStereo(void *stream, uint32_t sampleBlockLength)
 {
+	float *fMixBufferL = audio.fMixBufferL;
+	float *fMixBufferR = audio.fMixBufferR;
+	int16_t *streamPtr16 = (int16_t *)stream;
+	uint32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	const __m128 fNormalizeMul = _mm_set1_ps(fAudioNormalizeMul);
+	const __m128 fZero = _mm_setzero_ps();
+
+	for (; i+4 <= sampleBlockLength; i += 4)
+	{
+#if MIXER_INTERLEAVED_BUFFER
+		float *fMixBufferLR = &fMixBufferL[i*2]; // already in LRLR order
+
+		const __m128 fLR1 = _mm_mul_ps(_mm_loadu_ps(&fMixBufferLR[0]), fNormalizeMul);
+		const __m128 fLR2 = _mm_mul_ps(_mm_loadu_ps(&fMixBufferLR[4]), fNormalizeMul);
+
+		// truncate to int32 (same as a C cast), packs_epi32() clamps to int16
+		_mm_storeu_si128((__m128i *)streamPtr16, _mm_packs_epi32(_mm_cvttps_epi32(fLR1), _mm_cvttps_epi32(fLR2)));
+		streamPtr16 += 8;
+
+		// clear what we read from the mixing buffer
+		_mm_storeu_ps(&fMixBufferLR[0], fZero);
+		_mm_storeu_ps(&fMixBufferLR[4], fZero);
+#else
+		const __m128 fL = _mm_mul_ps(_mm_loadu_ps(&fMixBufferL[i]), fNormalizeMul);
+		const __m128 fR = _mm_mul_ps(_mm_loadu_ps(&fMixBufferR[i]), fNormalizeMul);
+
+		// truncate to int32 (same as a C cast), packs_epi32() clamps to int16
+		const __m128i L = _mm_cvttps_epi32(fL);
+		const __m128i R = _mm_cvttps_epi32(fR);
+		_mm_storeu_si128((__m128i *)streamPtr16, _mm_packs_epi32(_mm_unpacklo_epi32(L, R), _mm_unpackhi_epi32(L, R)));
+		streamPtr16 += 8;
+
+		// clear what we read from the mixing buffer
+		_mm_storeu_ps(&fMixBufferL[i], fZero);
+		_mm_storeu_ps(&fMixBufferR[i], fZero);
+#endif
+	}
+#endif
+
+	for (; i < sampleBlockLength; i++)
+	{
+		int32_t L = (int32_t)(fMixBufferL[i*MIX_BUFFER_STRIDE] * fAudioNormalizeMul);
+		int32_t R = (int32_t)(fMixBufferR[i*MIX_BUFFER_STRIDE] * fAudioNormalizeMul);
+
+		CLAMP16(L);
+		CLAMP16(R);
+
+		*streamPtr16++ = (int16_t)L;
+		*streamPtr16++ = (int16_t)R;
+
+		// clear what we read from the mixing buffer
+		fMixBufferL[i*MIX_BUFFER_STRIDE] = 0.0f;
+		fMixBufferR[i*MIX_BUFFER_STRIDE] = 0.0f;
+	}
+}
+
+static void sendSamples16BitDitherStereo(void *stream, uint32_t sampleBlockLength)
+{
+	float *fMixBufferL = audio.fMixBufferL;
+	float *fMixBufferR = audio.fMixBufferR;
 	int16_t *streamPtr16 = (int16_t *)stream;
-	for (uint32_t i = 0; i < sampleBlockLength; i++)
+	uint32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	const __m128 fNormalizeMul = _mm_set1_ps(fAudioNormalizeMul);
+	const __m128 fRandMul = _mm_set1_ps(1.0f / 4294967296.0f); // int32 -> -0.5 .. 0.5
+	const __m128 fZero = _mm_setzero_ps();
+
+	// four independent xorshift32 generators per channel
+	__m128i seedL = _mm_loadu_si128((const __m128i *)&ditherSeeds[0]);
+	__m128i seedR = _mm_loadu_si128((const __m128i *)&ditherSeeds[4]);
+
+	for (; i+4 <= sampleBlockLength; i += 4)
 	{
-		// TODO: This could use dithering (a proper implementation, that is...)
+#if MIXER_INTERLEAVED_BUFFER
+		// seedL/seedR each feed one LRLR vector here (still eight independent generators)
+		float *fMixBufferLR = &fMixBufferL[i*2];
+
+		__m128 fLR1 = _mm_mul_ps(_mm_loadu_ps(&fMixBufferLR[0]), fNormalizeMul);
+		__m128 fLR2 = _mm_mul_ps(_mm_loadu_ps(&fMixBufferLR[4]), fNormalizeMul);
+
+		seedL = xorshift32SSE2(seedL);
+		fLR1 = _mm_add_ps(fLR1, _mm_mul_ps(_mm_cvtepi32_ps(seedL), fRandMul));
+		seedL = xorshift32SSE2(seedL);
+		fLR1 = _mm_add_ps(fLR1, _mm_mul_ps(_mm_cvtepi32_ps(seedL), fRandMul));
+
+		seedR = xorshift32SSE2(seedR);
+		fLR2 = _mm_add_ps(fLR2, _mm_mul_ps(_mm_cvtepi32_ps(seedR), fRandMul));
+		seedR = xorshift32SSE2(seedR);
+		fLR2 = _mm_add_ps(fLR2, _mm_mul_ps(_mm_cvtepi32_ps(seedR), fRandMul));
 
-		int32_t L = (int32_t)(audio.fMixBufferL[i] * fAudioNormalizeMul);
-		int32_t R = (int32_t)(audio.fMixBufferR[i] * fAudioNormalizeMul);
+		// round to nearest int32, packs_epi32() clamps to int16
+		_mm_storeu_si128((__m128i *)streamPtr16, _mm_packs_epi32(_mm_cvtps_epi32(fLR1), _mm_cvtps_epi32(fLR2)));
+		streamPtr16 += 8;
+
+		// clear what we read from the mixing buffer
+		_mm_storeu_ps(&fMixBufferLR[0], fZero);
+		_mm_storeu_ps(&fMixBufferLR[4], fZero);
+#else
+		__m128 fL = _mm_mul_ps(_mm_loadu_ps(&fMixBufferL[i]), fNormalizeMul);
+		__m128 fR = _mm_mul_ps(_mm_loadu_ps(&fMixBufferR[i]), fNormalizeMul);
+
+		seedL = xorshift32SSE2(seedL);
+		fL = _mm_add_ps(fL, _mm_mul_ps(_mm_cvtepi32_ps(seedL), fRandMul));
+		seedL = xorshift32SSE2(seedL);
+		fL = _mm_add_ps(fL, _mm_mul_ps(_mm_cvtepi32_ps(seedL), fRandMul));
+
+		seedR = xorshift32SSE2(seedR);
+		fR = _mm_add_ps(fR, _mm_mul_ps(_mm_cvtepi32_ps(seedR), fRandMul));
+		seedR = xorshift32SSE2(seedR);
+		fR = _mm_add_ps(fR, _mm_mul_ps(_mm_cvtepi32_ps(seedR), fRandMul));
+
+		// round to nearest int32, packs_epi32() clamps to int16
+		const __m128i L = _mm_cvtps_epi32(fL);
+		const __m128i R = _mm_cvtps_epi32(fR);
+		_mm_storeu_si128((__m128i *)streamPtr16, _mm_packs_epi32(_mm_unpacklo_epi32(L, R), _mm_unpackhi_epi32(L, R)));
+		streamPtr16 += 8;
+
+		// clear what we read from the mixing buffer
+		_mm_storeu_ps(&fMixBufferL[i], fZero);
+		_mm_storeu_ps(&fMixBufferR[i], fZero);
+#endif
+	}
+
+	_mm_storeu_si128((__m128i *)&ditherSeeds[0], seedL);
+	_mm_storeu_si128((__m128i *)&ditherSeeds[4], seedR);
+#endif
+
+	for (; i < sampleBlockLength; i++)
+	{
+		float fL = fMixBufferL[i*MIX_BUFFER_STRIDE] * fAudioNormalizeMul;
+		float fR = fMixBufferR[i*MIX_BUFFER_STRIDE] * fAudioNormalizeMul;
+
+		ditherSeeds[0] = xorshift32(ditherSeeds[0]);
+		ditherSeeds[1] = xorshift32(ditherSeeds[1]);
+		ditherSeeds[4] = xorshift32(ditherSeeds[4]);
+		ditherSeeds[5] = xorshift32(ditherSeeds[5]);
+
+		fL += ((float)(int32_t)ditherSeeds[0] + (float)(int32_t)ditherSeeds[1]) * (1.0f / 4294967296.0f);
+		fR += ((float)(int32_t)ditherSeeds[4] + (float)(int32_t)ditherSeeds[5]) * (1.0f / 4294967296.0f);
+
+		int32_t L = (int32_t)floorf(fL + 0.5f);
+		int32_t R = (int32_t)floorf(fR + 0.5f);
 
 		CLAMP16(L);
 		CLAMP16(R);
@@ -431,62 +696,150 @@ static void sendSamples16BitStereo(void *stream, uint32_t sampleBlockLength)
 		*streamPtr16++ = (int16_t)R;
 
 		// clear what we read from the mixing buffer
-		audio.fMixBufferL[i] = 0.0f;
-		audio.fMixBufferR[i] = 0.0f;
+		fMixBufferL[i*MIX_BUFFER_STRIDE] = 0.0f;
+		fMixBufferR[i*MIX_BUFFER_STRIDE] = 0.0f;
 	}
 }
 
 static void sendSamples32BitFloatStereo(void *stream, uint32_t sampleBlockLength)
 {
+	float *fMixBufferL = audio.fMixBufferL;
+	float *fMixBufferR = audio.fMixBufferR;
 	float *fStreamPtr32 = (float *)stream;
-	for (uint32_t i = 0; i < sampleBlockLength; i++)
+	uint32_t i = 0;
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	const __m128 fNormalizeMul = _mm_set1_ps(fAudioNormalizeMul);
+	const __m128 fMin = _mm_set1_ps(-1.0f);
+	const __m128 fMax = _mm_set1_ps( 1.0f);
+	const __m128 fZero = _mm_setzero_ps();
+
+	for (; i+4 <= sampleBlockLength; i += 4)
+	{
+#if MIXER_INTERLEAVED_BUFFER
+		float *fMixBufferLR = &fMixBufferL[i*2];
+
+		__m128 fLR1 = _mm_mul_ps(_mm_loadu_ps(&fMixBufferLR[0]), fNormalizeMul);
+		__m128 fLR2 = _mm_mul_ps(_mm_loadu_ps(&fMixBufferLR[4]), fNormalizeMul);
+
+		_mm_storeu_ps(&fStreamPtr32[0], _mm_min_ps(_mm_max_ps(fLR1, fMin), fMax));
+		_mm_storeu_ps(&fStreamPtr32[4], _mm_min_ps(_mm_max_ps(fLR2, fMin), fMax));
+		fStreamPtr32 += 8;
+
+		// clear what we read from the mixing buffer
+		_mm_storeu_ps(&fMixBufferLR[0], fZero);
+		_mm_storeu_ps(&fMixBufferLR[4], fZero);
+#else
+		__m128 fL = _mm_mul_ps(_mm_loadu_ps(&fMixBufferL[i]), fNormalizeMul);
+		__m128 fR = _mm_mul_ps(_mm_loadu_ps(&fMixBufferR[i]), fNormalizeMul);
+
+		fL = _mm_min_ps(_mm_max_ps(fL, fMin), fMax);
+		fR = _mm_min_ps(_mm_max_ps(fR, fMin), fMax);
+
+		_mm_storeu_ps(&fStreamPtr32[0], _mm_unpacklo_ps(fL, fR));
+		_mm_storeu_ps(&fStreamPtr32[4], _mm_unpackhi_ps(fL, fR));
+		fStreamPtr32 += 8;
+
+		// clear what we read from the mixing buffer
+		_mm_storeu_ps(&fMixBufferL[i], fZero);
+		_mm_storeu_ps(&fMixBufferR[i], fZero);
+#endif
+	}
+#endif
+
+	for (; i < sampleBlockLength; i++)
 	{
-		const float fL = audio.fMixBufferL[i] * fAudioNormalizeMul;
-		const float fR = audio.fMixBufferR[i] * fAudioNormalizeMul;
+		const float fL = fMixBufferL[i*MIX_BUFFER_STRIDE] * fAudioNormalizeMul;
+		const float fR = fMixBufferR[i*MIX_BUFFER_STRIDE] * fAudioNormalizeMul;
 
 		*fStreamPtr32++ = CLAMP(fL, -1.0f, 1.0f);
 		*fStreamPtr32++ = CLAMP(fR, -1.0f, 1.0f);
 
 		// clear what we read from the mixing buffer
-		audio.fMixBufferL[i] = 0.0f;
-		audio.fMixBufferR[i] = 0.0f;
+		fMixBufferL[i*MIX_BUFFER_STRIDE] = 0.0f;
+		fMixBufferR[i*MIX_BUFFER_STRIDE] = 0.0f;
 	}
 }
 
-static void doChannelMixing(int32_t bufferPosition, int32_t samplesToMix)
+static void sendSamples(void *stream, uint32_t sampleBlockLength, uint8_t bitDepth)
 {
-	voice_t *v = voice; // normal voices
-	voice_t *r = &voice[MAX_CHANNELS]; // volume ramp fadeout-voices
+	if (bitDepth == 16)
+	{
+		if (config.specialFlags2 & DITHER_16BIT_OUTPUT)
+			sendSamples16BitDitherStereo(stream, sampleBlockLength);
+		else
+			sendSamples16BitStereo(stream, sampleBlockLength);
+	}
+	else
+	{
+		sendSamples32BitFloatStereo(stream, sampleBlockLength);
+	}
+}
 
-	for (int32_t i = 0; i < song.numChannels; i++, v++, r++)
+// mixes one channel's voice and its volume ramp fadeout-voice
+static inline void mixChannelVoices(voice_t *v, voice_t *r, int32_t bufferPosition, int32_t samplesToMix)
+{
+	if (v->active)
 	{
-		if (v->active)
-		{
-			bool centerMixFlag;
+		bool centerMixFlag;
 
-			const bool volRampFlag = (v->volumeRampLength > 0);
-			if (volRampFlag)
-			{
-				centerMixFlag = (v->fTargetVolumeL == v->fTargetVolumeR) && (v->fVolumeLDelta == v->fVolumeRDelta);
-			}
-			else // no volume ramping active
+		const bool volRampFlag = (v->volumeRampLength > 0);
+		if (volRampFlag)
+		{
+			centerMixFlag = (v->fTargetVolumeL == v->fTargetVolumeR) && (v->fVolumeLDelta == v->fVolumeRDelta);
+		}
+		else // no volume ramping active
+		{
+			if (v->fCurrVolumeL == 0.0f && v->fCurrVolumeR == 0.0f)
 			{
-				if (v->fCurrVolumeL == 0.0f && v->fCurrVolumeR == 0.0f)
-				{
-					silenceMixRoutine(v, samplesToMix);
-					continue;
-				}
-
-				centerMixFlag = (v->fCurrVolumeL == v->fCurrVolumeR);
+				silenceMixRoutine(v, samplesToMix);
+				return;
 			}
 
-			mixFuncTab[((int32_t)centerMixFlag * (3*5*2*2)) + ((int32_t)volRampFlag * (3*5*2)) + v->mixFuncOffset](v, bufferPosition, samplesToMix);
+			centerMixFlag = (v->fCurrVolumeL == v->fCurrVolumeR);
 		}
 
-		if (r->active) // volume ramp fadeout-voice
+		mixFuncTab[((int32_t)centerMixFlag * (3*5*2*2)) + ((int32_t)volRampFlag * (3*5*2)) + v->mixFuncOffset](v, bufferPosition, samplesToMix);
+	}
+
+	if (r->active) // volume ramp fadeout-voice
+	{
+		const bool centerMixFlag = (r->fTargetVolumeL == r->fTargetVolumeR) && (r->fVolumeLDelta == r->fVolumeRDelta);
+		mixFuncTab[((int32_t)centerMixFlag * (3*5*2*2)) + (3*5*2) + r->mixFuncOffset](r, bufferPosition, samplesToMix);
+	}
+}
+
+// only visits the channels in activeChannelMask (in channel order, so the mix result doesn't change)
+static void doChannelMixing(int32_t bufferPosition, int32_t samplesToMix)
+{
+	for (int32_t w = 0; w < CHANNEL_MASK_WORDS; w++)
+	{
+		uint32_t mask = activeChannelMask[w];
+		while (mask != 0)
 		{
-			const bool centerMixFlag = (r->fTargetVolumeL == r->fTargetVolumeR) && (r->fVolumeLDelta == r->fVolumeRDelta);
-			mixFuncTab[((int32_t)centerMixFlag * (3*5*2*2)) + (3*5*2) + r->mixFuncOffset](r, bufferPosition, samplesToMix);
+			const int32_t bit = lowestSetBit(mask);
+			mask &= mask - 1;
+
+			const int32_t i = (w << 5) + bit;
+			if (i >= song.numChannels)
+				break;
+
+			voice_t *v = &voice[i]; // normal voice
+			voice_t *r = &voice[MAX_CHANNELS+i]; // volume ramp fadeout-voice
+
+			if (audioStats.profileVoices) // per-voice cost profiler (shown in the scopes)
+			{
+				const uint64_t voiceStartTime64 = SDL_GetPerformanceCounter();
+				mixChannelVoices(v, r, bufferPosition, samplesToMix);
+				audioStats.voiceTime64[i] += SDL_GetPerformanceCounter() - voiceStartTime64;
+			}
+			else
+			{
+				mixChannelVoices(v, r, bufferPosition, samplesToMix);
+			}
+
+			if (!v->active && !r->active)
+				activeChannelMask[w] &= ~(1UL << bit);
 		}
 	}
 }
@@ -497,89 +850,67 @@ void mixReplayerTickToBuffer(uint32_t samplesToMix, void *stream, uint8_t bitDep
 	doChannelMixing(0, samplesToMix);
 
 	// normalize mix buffer and send to audio stream
-	if (bitDepth == 16)
-		sendSamples16BitStereo(stream, samplesToMix);
-	else
-		sendSamples32BitFloatStereo(stream, samplesToMix);
+	sendSamples(stream, samplesToMix, bitDepth);
 }
 
-int32_t pattQueueReadSize(void)
-{
-	while (pattQueueClearing);
-
-	if (pattSync.writePos > pattSync.readPos)
-		return pattSync.writePos - pattSync.readPos;
-	else if (pattSync.writePos < pattSync.readPos)
-		return pattSync.writePos - pattSync.readPos + SYNC_QUEUE_LEN + 1;
-	else
-		return 0;
-}
+/* The sync queues are single-producer/single-consumer ring buffers (audio thread -> video thread).
+** Each side does an acquire barrier after reading the other side's position, and a release barrier
+** before publishing its own. This way an entry is fully written before the consumer can see it, and
+** the producer never overwrites a slot that is still being read, also on weakly ordered CPUs (ARM).
+*/
 
-int32_t pattQueueWriteSize(void)
+// consumer side of resetSyncQueues(), called before each read
+static void handleSyncQueueReset(SDL_atomic_t *resetRequested, SDL_atomic_t *readPos, SDL_atomic_t *writePos)
 {
-	int32_t size;
-
-	if (pattSync.writePos > pattSync.readPos)
-	{
-		size = pattSync.readPos - pattSync.writePos + SYNC_QUEUE_LEN;
-	}
-	else if (pattSync.writePos < pattSync.readPos)
-	{
-		pattQueueClearing = true;
-
-		/* Buffer is full, reset the read/write pos. This is actually really nasty since
-		** read/write are two different threads, but because of timestamp validation it
-		** shouldn't be that dangerous.
-		** It will also create a small visual stutter while the buffer is getting filled,
-		** though that is barely noticable on normal buffer sizes, and it takes a minute
-		** or two at max BPM between each time (when queue size is default, 4095)
-		*/
-		pattSync.data[0].timestamp = 0;
-		pattSync.readPos = 0;
-		pattSync.writePos = 0;
+	if (!SDL_AtomicGet(resetRequested))
+		return;
 
-		size = SYNC_QUEUE_LEN;
+	// the producer doesn't push while a reset is requested, so writePos can't change here
+	SDL_AtomicSet(readPos, SDL_AtomicGet(writePos));
 
-		pattQueueClearing = false;
-	}
-	else
-	{
-		size = SYNC_QUEUE_LEN;
-	}
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(resetRequested, 0);
+}
 
-	return size;
+int32_t pattQueueReadSize(void)
+{
+	handleSyncQueueReset(&pattSync.resetRequested, &pattSync.readPos, &pattSync.writePos);
+	return (SDL_AtomicGet(&pattSync.writePos) - SDL_AtomicGet(&pattSync.readPos)) & pattSync.mask;
 }
 
 bool pattQueuePush(pattSyncData_t t)
 {
-	if (!pattQueueWriteSize())
-		return false;
-
-	assert(pattSync.writePos <= SYNC_QUEUE_LEN);
-	pattSync.data[pattSync.writePos] = t;
-	pattSync.writePos = (pattSync.writePos + 1) & SYNC_QUEUE_LEN;
+	if (pattSync.data == NULL || SDL_AtomicGet(&pattSync.resetRequested))
+		return false; // no queue, or the video thread hasn't emptied it yet after a reset
 
-	return true;
-}
+	const int32_t writePos = SDL_AtomicGet(&pattSync.writePos);
+	const int32_t nextWritePos = (writePos + 1) & pattSync.mask;
+	if (nextWritePos == SDL_AtomicGet(&pattSync.readPos))
+		return false; // queue is full (video thread is stalling), drop this tick
 
-bool pattQueuePop(void)
-{
-	if (!pattQueueReadSize())
-		return false;
+	SDL_MemoryBarrierAcquire();
+	pattSync.data[writePos] = t;
 
-	pattSync.readPos = (pattSync.readPos + 1) & SYNC_QUEUE_LEN;
-	assert(pattSync.readPos <= SYNC_QUEUE_LEN);
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&pattSync.writePos, nextWritePos);
 
 	return true;
 }
 
-pattSyncData_t *pattQueuePeek(void)
+// copies the oldest tick in the queue to the video thread's copy and returns it (or NULL if the queue is empty)
+pattSyncData_t *pattQueuePop(void)
 {
 	if (!pattQueueReadSize())
 		return NULL;
 
-	assert(pattSync.readPos <= SYNC_QUEUE_LEN);
-	return &pattSync.data[pattSync.readPos];
+	SDL_MemoryBarrierAcquire();
+
+	const int32_t readPos = SDL_AtomicGet(&pattSync.readPos);
+	pattSyncState = pattSync.data[readPos];
+
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&pattSync.readPos, (readPos + 1) & pattSync.mask);
+	return &pattSyncState;
 }
 
 uint64_t getPattQueueTimestamp(void)
@@ -587,87 +918,105 @@ uint64_t getPattQueueTimestamp(void)
 	if (!pattQueueReadSize())
 		return 0;
 
-	assert(pattSync.readPos <= SYNC_QUEUE_LEN);
-	return pattSync.data[pattSync.readPos].timestamp;
+	SDL_MemoryBarrierAcquire();
+	return pattSync.data[SDL_AtomicGet(&pattSync.readPos)].timestamp;
 }
 
 int32_t chQueueReadSize(void)
 {
-	while (chQueueClearing);
-
-	if (chSync.writePos > chSync.readPos)
-		return chSync.writePos - chSync.readPos;
-	else if (chSync.writePos < chSync.readPos)
-		return chSync.writePos - chSync.readPos + SYNC_QUEUE_LEN + 1;
-	else
-		return 0;
+	handleSyncQueueReset(&chSync.resetRequested, &chSync.readPos, &chSync.writePos);
+	return (SDL_AtomicGet(&chSync.writePos) - SDL_AtomicGet(&chSync.readPos)) & chSync.mask;
 }
 
-int32_t chQueueWriteSize(void)
+// only pushes the channels that changed since the last pushed tick (audio thread)
+bool chQueuePush(const chSyncData_t *chSyncData)
 {
-	int32_t size;
+	if (chSync.ticks == NULL)
+		return false;
 
-	if (chSync.writePos > chSync.readPos)
+	if (SDL_AtomicGet(&chSync.resetRequested))
 	{
-		size = chSync.readPos - chSync.writePos + SYNC_QUEUE_LEN;
+		// the video thread hasn't emptied the queue yet after a reset
+		chSyncFullUpdate = true;
+		return false;
 	}
-	else if (chSync.writePos < chSync.readPos)
+
+	const int32_t writePos = SDL_AtomicGet(&chSync.writePos);
+	const int32_t nextWritePos = (writePos + 1) & chSync.mask;
+	if (nextWritePos == SDL_AtomicGet(&chSync.readPos))
 	{
-		chQueueClearing = true;
+		// queue is full (video thread is stalling), drop this tick and resend everything later
+		chSyncFullUpdate = true;
+		return false;
+	}
 
-		/* Buffer is full, reset the read/write pos. This is actually really nasty since
-		** read/write are two different threads, but because of timestamp validation it
-		** shouldn't be that dangerous.
-		** It will also create a small visual stutter while the buffer is getting filled,
-		** though that is barely noticable on normal buffer sizes, and it takes several
-		** minutes between each time (when queue size is default, 16384)
-		*/
-		chSync.data[0].timestamp = 0;
-		chSync.readPos = 0;
-		chSync.writePos = 0;
+	SDL_MemoryBarrierAcquire();
 
-		size = SYNC_QUEUE_LEN;
+	chSyncTick_t *t = &chSync.ticks[writePos];
+	t->timestamp = chSyncData->timestamp;
+	t->firstUpdate = chSync.updateWritePos;
+	t->numUpdates = 0;
 
-		chQueueClearing = false;
-	}
-	else
+	const syncedChannel_t *c = chSyncData->channels;
+	syncedChannel_t *last = lastSyncedChannel;
+
+	for (int32_t i = 0; i < song.numChannels; i++, c++, last++)
 	{
-		size = SYNC_QUEUE_LEN;
-	}
+		/* A set status is an event, so it has to be sent even if nothing else changed.
+		** This also means that a channel that isn't sent already has a zero status
+		** in the video thread's copy (the tick after an event always differs).
+		*/
+		if (!chSyncFullUpdate && c->status == 0 && !memcmp(c, last, sizeof (syncedChannel_t)))
+			continue;
 
-	return size;
-}
+		chSyncUpdate_t *u = &chSync.updates[(t->firstUpdate + t->numUpdates) & chSync.updateMask];
+		u->channel = (uint8_t)i;
+		u->state = *c;
+		t->numUpdates++;
 
-bool chQueuePush(chSyncData_t t)
-{
-	if (!chQueueWriteSize())
-		return false;
+		*last = *c;
+	}
 
-	assert(chSync.writePos <= SYNC_QUEUE_LEN);
-	chSync.data[chSync.writePos] = t;
-	chSync.writePos = (chSync.writePos + 1) & SYNC_QUEUE_LEN;
+	chSync.updateWritePos = (t->firstUpdate + t->numUpdates) & chSync.updateMask;
+	chSyncFullUpdate = false;
 
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&chSync.writePos, nextWritePos);
 	return true;
 }
 
-bool chQueuePop(void)
+/* Applies the oldest tick in the queue to the video thread's copy of the channel states,
+** ORs the channel statuses into scopeUpdateStatus and returns the channel states
+** (or NULL if the queue is empty).
+*/
+chSyncData_t *chQueuePop(uint8_t *scopeUpdateStatus)
 {
 	if (!chQueueReadSize())
-		return false;
+		return NULL;
 
-	chSync.readPos = (chSync.readPos + 1) & SYNC_QUEUE_LEN;
-	assert(chSync.readPos <= SYNC_QUEUE_LEN);
+	SDL_MemoryBarrierAcquire();
 
-	return true;
-}
+	const int32_t readPos = SDL_AtomicGet(&chSync.readPos);
+	const chSyncTick_t *t = &chSync.ticks[readPos];
 
-chSyncData_t *chQueuePeek(void)
-{
-	if (!chQueueReadSize())
-		return NULL;
+	const int32_t numUpdates = (t->numUpdates >= 0 && t->numUpdates <= MAX_CHANNELS) ? t->numUpdates : 0;
+	for (int32_t i = 0; i < numUpdates; i++)
+	{
+		const chSyncUpdate_t *u = &chSync.updates[(t->firstUpdate + i) & chSync.updateMask];
 
-	assert(chSync.readPos <= SYNC_QUEUE_LEN);
-	return &chSync.data[chSync.readPos];
+		const int32_t ch = u->channel;
+		if (ch >= MAX_CHANNELS)
+			continue; // invalid entry
+
+		chSyncState.channels[ch] = u->state;
+		scopeUpdateStatus[ch] |= u->state.status; // yes, OR the status
+	}
+
+	chSyncState.timestamp = t->timestamp;
+
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&chSync.readPos, (readPos + 1) & chSync.mask);
+	return &chSyncState;
 }
 
 uint64_t getChQueueTimestamp(void)
@@ -675,35 +1024,48 @@ uint64_t getChQueueTimestamp(void)
 	if (!chQueueReadSize())
 		return 0;
 
-	assert(chSync.readPos <= SYNC_QUEUE_LEN);
-	return chSync.data[chSync.readPos].timestamp;
+	SDL_MemoryBarrierAcquire();
+	return chSync.ticks[SDL_AtomicGet(&chSync.readPos)].timestamp;
 }
 
-void lockAudio(void)
+void lockAudioThreads(void)
 {
 	if (audio.dev != 0)
 		SDL_LockAudioDevice(audio.dev);
 
-	audio.locked = true;
+	if (renderAhead.mutex != NULL)
+		SDL_LockMutex(renderAhead.mutex);
 }
 
-void unlockAudio(void)
+void unlockAudioThreads(void)
 {
+	if (renderAhead.mutex != NULL)
+		SDL_UnlockMutex(renderAhead.mutex);
+
 	if (audio.dev != 0)
 		SDL_UnlockAudioDevice(audio.dev);
+}
 
+void lockAudio(void)
+{
+	lockAudioThreads();
+	audio.locked = true;
+}
+
+void unlockAudio(void)
+{
+	unlockAudioThreads();
 	audio.locked = false;
 }
 
-void resetSyncQueues(void)
+void resetSyncQueues(void) // audio thread must be locked (or not running)
 {
-	pattSync.data[0].timestamp = 0;
-	pattSync.readPos = 0;
-	pattSync.writePos = 0;
-	
-	chSync.data[0].timestamp = 0;
-	chSync.writePos = 0;
-	chSync.readPos = 0;
+	// the video thread empties the queues (see handleSyncQueueReset())
+	SDL_AtomicSet(&pattSync.resetRequested, 1);
+	SDL_AtomicSet(&chSync.resetRequested, 1);
+
+	chSyncFullUpdate = true;
+	fullVisualsSyncUpdate = true;
 }
 
 void lockMixerCallback(void) // lock audio + clear voices/scopes (for short operations)
@@ -718,6 +1080,7 @@ void lockMixerCallback(void) // lock audio + clear voices/scopes (for short oper
 	// scopes, mixer and replayer are guaranteed to not be active at this point
 
 	resetSyncQueues();
+	flushRenderAheadBuffer();
 }
 
 void unlockMixerCallback(void)
@@ -739,6 +1102,9 @@ void pauseAudio(void) // lock audio + clear voices/scopes + render silence (for
 	if (audio.dev > 0)
 		SDL_PauseAudioDevice(audio.dev, true);
 
+	if (renderAhead.mutex != NULL)
+		SDL_LockMutex(renderAhead.mutex);
+
 	audio.resetSyncTickTimeFlag = true;
 
 	stopVoices(); // VERY important! prevents potential crashes by purging pointers
@@ -746,7 +1112,12 @@ void pauseAudio(void) // lock audio + clear voices/scopes + render silence (for
 	// scopes, mixer and replayer are guaranteed to not be active at this point
 
 	resetSyncQueues();
+	flushRenderAheadBuffer();
+	renderAhead.running = false;
 	audioPaused = true;
+
+	if (renderAhead.mutex != NULL)
+		SDL_UnlockMutex(renderAhead.mutex);
 }
 
 void resumeAudio(void) // unlock audio
@@ -758,12 +1129,40 @@ void resumeAudio(void) // unlock audio
 		SDL_PauseAudioDevice(audio.dev, false);
 
 	audioPaused = false;
+
+	if (renderAhead.active)
+	{
+		renderAhead.running = true;
+		SDL_SemPost(renderAhead.sem); // start filling right away
+	}
+}
+
+static void fillSyncedChannel(syncedChannel_t *c, int32_t i)
+{
+	const channel_t *s = &channel[i];
+	const voice_t *v = &voice[i];
+
+	c->scopeVolume = v->scopeVolume;
+	c->scopeDelta = v->scopeDelta;
+	c->instrNum = s->instrNum;
+	c->smpNum = s->smpNum;
+	c->status = s->tmpStatus;
+	c->smpStartPos = s->smpStartPos;
+
+	c->pianoNoteNum = 255; // no piano key
+	if (songPlaying && (c->status & IS_Period) && !s->keyOff)
+	{
+		const int32_t note = getPianoKey(s->finalPeriod, s->finetune, s->relativeNote);
+		if (note >= 0 && note <= 95)
+			c->pianoNoteNum = (uint8_t)note;
+	}
 }
 
 static void fillVisualsSyncBuffer(void)
 {
+	static int32_t lastNumChannels;
+	static chSyncData_t chSyncData; // kept between ticks, only changed channels are refilled
 	pattSyncData_t pattSyncData;
-	chSyncData_t chSyncData;
 
 	if (audio.resetSyncTickTimeFlag)
 	{
@@ -771,6 +1170,10 @@ static void fillVisualsSyncBuffer(void)
 
 		audio.tickTime64 = SDL_GetPerformanceCounter() + audio.audLatencyPerfValInt;
 		audio.tickTime64Frac = audio.audLatencyPerfValFrac;
+
+		// what's already in the render-ahead buffer will be played first
+		if (renderAhead.active)
+			audio.tickTime64 += (uint64_t)((renderAheadBufferedSamples() * (double)hpcFreq.freq64) / audio.freq);
 	}
 
 	if (songPlaying)
@@ -787,32 +1190,50 @@ static void fillVisualsSyncBuffer(void)
 		pattQueuePush(pattSyncData);
 	}
 
-	// push channel variables to sync queue
+	/* Push channel variables to sync queue. Only the channels that got a status update on this
+	** tick (or the previous one, to clear the status again) are refilled. The other channels
+	** have a zero status, and the video thread ignores the rest of a channel's state then.
+	*/
 
-	syncedChannel_t *c = chSyncData.channels;
-	channel_t *s = channel;
-	voice_t *v = voice;
+	if (song.numChannels != lastNumChannels)
+	{
+		lastNumChannels = song.numChannels;
+		fullVisualsSyncUpdate = true;
+	}
 
-	for (int32_t i = 0; i < song.numChannels; i++, c++, s++, v++)
+	if (fullVisualsSyncUpdate)
 	{
-		c->scopeVolume = v->scopeVolume;
-		c->scopeDelta = v->scopeDelta;
-		c->instrNum = s->instrNum;
-		c->smpNum = s->smpNum;
-		c->status = s->tmpStatus;
-		c->smpStartPos = s->smpStartPos;
+		fullVisualsSyncUpdate = false;
 
-		c->pianoNoteNum = 255; // no piano key
-		if (songPlaying && (c->status & IS_Period) && !s->keyOff)
+		for (int32_t i = 0; i < song.numChannels; i++)
+			fillSyncedChannel(&chSyncData.channels[i], i);
+	}
+	else
+	{
+		for (int32_t w = 0; w < CHANNEL_MASK_WORDS; w++)
 		{
-			const int32_t note = getPianoKey(s->finalPeriod, s->finetune, s->relativeNote);
-			if (note >= 0 && note <= 95)
-				c->pianoNoteNum = (uint8_t)note;
+			uint32_t mask = syncChannelMask[w] | lastSyncChannelMask[w];
+			while (mask != 0)
+			{
+				const int32_t i = (w << 5) + lowestSetBit(mask);
+				mask &= mask - 1;
+
+				if (i >= song.numChannels)
+					break;
+
+				fillSyncedChannel(&chSyncData.channels[i], i);
+			}
 		}
 	}
 
+	for (int32_t w = 0; w < CHANNEL_MASK_WORDS; w++)
+	{
+		lastSyncChannelMask[w] = syncChannelMask[w];
+		syncChannelMask[w] = 0;
+	}
+
 	chSyncData.timestamp = audio.tickTime64;
-	chQueuePush(chSyncData);
+	chQueuePush(&chSyncData);
 
 	audio.tickTime64 += tickTimeLenInt;
 
@@ -824,15 +1245,51 @@ static void fillVisualsSyncBuffer(void)
 	}
 }
 
-static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
+static void updateAudioStats(int32_t len, uint64_t replayerTime64, uint64_t mixTime64, uint64_t outputTime64)
 {
-	if (editor.wavIsRendering)
-		return;
+	if (audioStats.resetFlag)
+	{
+		audioStats.resetFlag = false;
 
-	len >>= smpShiftValue; // bytes -> samples
-	if (len <= 0)
+		audioStats.renders = audioStats.deadlineMisses = audioStats.underruns = 0;
+		audioStats.replayerTime64 = audioStats.mixTime64 = audioStats.outputTime64 = 0;
+		audioStats.periodTime64 = audioStats.worstTime64 = audioStats.worstPeriod64 = 0;
+		memset((void *)audioStats.histogram, 0, sizeof (audioStats.histogram));
+	}
+
+	const uint64_t time64 = replayerTime64 + mixTime64 + outputTime64;
+	const uint64_t period64 = (uint64_t)((len * (double)hpcFreq.freq64) / audio.freq); // real-time length of this render
+	if (period64 == 0)
 		return;
 
+	audioStats.renders++;
+	audioStats.replayerTime64 += replayerTime64;
+	audioStats.mixTime64 += mixTime64;
+	audioStats.outputTime64 += outputTime64;
+	audioStats.periodTime64 += period64;
+
+	if (time64 > period64)
+		audioStats.deadlineMisses++;
+
+	// worst case relative to the period (render lengths can differ)
+	if (audioStats.worstPeriod64 == 0 || time64 * audioStats.worstPeriod64 > audioStats.worstTime64 * period64)
+	{
+		audioStats.worstTime64 = time64;
+		audioStats.worstPeriod64 = period64;
+	}
+
+	uint64_t bin = (time64 * 10) / period64; // 10% steps
+	if (bin > AUDIO_STATS_HIST_BINS-1)
+		bin = AUDIO_STATS_HIST_BINS-1;
+
+	audioStats.histogram[bin]++;
+}
+
+// runs the replayer and mixes 'len' samples to 'stream' (audio callback or render-ahead thread)
+static void renderSamples(void *stream, int32_t len)
+{
+	const uint64_t startTime64 = SDL_GetPerformanceCounter();
+	uint64_t replayerTime64 = 0;
 	int32_t bufferPosition = 0;
 
 	uint32_t samplesLeft = len;
@@ -840,6 +1297,8 @@ static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
 	{
 		if (audio.tickSampleCounter == 0) // new replayer tick
 		{
+			const uint64_t tickStartTime64 = SDL_GetPerformanceCounter();
+
 			replayerBusy = true;
 			if (!musicPaused) // important, don't remove this check! (also used for safety)
 			{
@@ -852,6 +1311,8 @@ static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
 			}
 			replayerBusy = false;
 
+			replayerTime64 += SDL_GetPerformanceCounter() - tickStartTime64;
+
 			audio.tickSampleCounter = audio.samplesPerTickInt;
 
 			audio.tickSampleCounterFrac += audio.samplesPerTickFrac;
@@ -873,24 +1334,198 @@ static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
 		samplesLeft -= samplesToMix;
 	}
 
-	if (config.specialFlags & BITDEPTH_16)
-		sendSamples16BitStereo(stream, len);
+	const uint64_t mixEndTime64 = SDL_GetPerformanceCounter();
+	sendSamples(stream, len, (config.specialFlags & BITDEPTH_16) ? 16 : 32);
+	const uint64_t outputTime64 = SDL_GetPerformanceCounter() - mixEndTime64;
+
+	updateAudioStats(len, replayerTime64, (mixEndTime64 - startTime64) - replayerTime64, outputTime64);
+}
+
+// render-ahead thread: keeps the ring buffer filled with renderAhead.targetSamples samples
+static void fillRenderAheadBuffer(void)
+{
+	int32_t samplesToRender = renderAhead.targetSamples - renderAheadBufferedSamples();
+	while (samplesToRender > 0)
+	{
+		const int32_t len = MIN(samplesToRender, renderAhead.chunkSamples);
+		renderSamples(renderAhead.chunkBuffer, len);
+
+		const int32_t writePos = SDL_AtomicGet(&renderAhead.writePos);
+		const int32_t len1 = MIN(len, (renderAhead.mask + 1) - writePos);
+		const int32_t len2 = len - len1;
+
+		memcpy(&renderAhead.ringBuffer[writePos << smpShiftValue], renderAhead.chunkBuffer, len1 << smpShiftValue);
+		if (len2 > 0)
+			memcpy(renderAhead.ringBuffer, &renderAhead.chunkBuffer[len1 << smpShiftValue], len2 << smpShiftValue);
+
+		SDL_MemoryBarrierRelease();
+		SDL_AtomicSet(&renderAhead.writePos, (writePos + len) & renderAhead.mask);
+
+		samplesToRender -= len;
+	}
+}
+
+static int32_t SDLCALL renderAheadThreadFunc(void *ptr)
+{
+	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL);
+
+	while (!renderAhead.quit)
+	{
+		/* Don't block on the mutex. The main thread can hold it (lockAudio()) while it
+		** calls closeAudio(), which waits for this thread to quit.
+		*/
+		if (SDL_TryLockMutex(renderAhead.mutex) == 0)
+		{
+			if (renderAhead.running && !editor.wavIsRendering)
+				fillRenderAheadBuffer();
+
+			SDL_UnlockMutex(renderAhead.mutex);
+		}
+
+		SDL_SemWaitTimeout(renderAhead.sem, 10); // posted by the audio callback
+	}
+
+	(void)ptr;
+	return true;
+}
+
+// audio callback: only copies from the ring buffer, outputs silence on underrun
+static void readRenderAheadBuffer(uint8_t *stream, int32_t len)
+{
+	const int32_t samplesAvailable = renderAheadBufferedSamples();
+	const int32_t samplesToRead = MIN(len, samplesAvailable);
+
+	SDL_MemoryBarrierAcquire();
+
+	const int32_t readPos = SDL_AtomicGet(&renderAhead.readPos);
+	const int32_t len1 = MIN(samplesToRead, (renderAhead.mask + 1) - readPos);
+	const int32_t len2 = samplesToRead - len1;
+
+	memcpy(stream, &renderAhead.ringBuffer[readPos << smpShiftValue], len1 << smpShiftValue);
+	if (len2 > 0)
+		memcpy(&stream[len1 << smpShiftValue], renderAhead.ringBuffer, len2 << smpShiftValue);
+
+	if (samplesToRead < len) // underrun, the render-ahead thread didn't keep up
+	{
+		memset(&stream[samplesToRead << smpShiftValue], 0, (len - samplesToRead) << smpShiftValue); // zero = silence (also for float)
+		audioStats.underruns++;
+	}
+
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&renderAhead.readPos, (readPos + samplesToRead) & renderAhead.mask);
+
+	SDL_SemPost(renderAhead.sem);
+}
+
+static void SDLCALL audioCallback(void *userdata, Uint8 *stream, int len)
+{
+	if (editor.wavIsRendering)
+		return;
+
+	len >>= smpShiftValue; // bytes -> samples
+	if (len <= 0)
+		return;
+
+	if (renderAhead.active)
+		readRenderAheadBuffer(stream, len);
 	else
-		sendSamples32BitFloatStereo(stream, len);
+		renderSamples(stream, len);
 
 	(void)userdata;
 }
 
+static void closeRenderAhead(void)
+{
+	if (renderAhead.thread != NULL)
+	{
+		renderAhead.quit = true;
+		SDL_SemPost(renderAhead.sem);
+		SDL_WaitThread(renderAhead.thread, NULL);
+		renderAhead.thread = NULL;
+	}
+
+	renderAhead.active = renderAhead.running = false;
+
+	if (renderAhead.ringBuffer != NULL)
+	{
+		free(renderAhead.ringBuffer);
+		renderAhead.ringBuffer = NULL;
+	}
+
+	if (renderAhead.chunkBuffer != NULL)
+	{
+		free(renderAhead.chunkBuffer);
+		renderAhead.chunkBuffer = NULL;
+	}
+}
+
+// must be called while the audio device is paused
+static bool setupRenderAhead(int32_t renderAheadMs, int32_t audioBufferSize, int32_t audioFreq)
+{
+	closeRenderAhead();
+
+	if (renderAheadMs <= 0)
+		return true; // disabled, mix directly in the audio callback
+
+	// these are created once and kept (lockAudio()/unlockAudio() can be nested around setupAudio())
+	if (renderAhead.mutex == NULL)
+		renderAhead.mutex = SDL_CreateMutex();
+
+	if (renderAhead.sem == NULL)
+		renderAhead.sem = SDL_CreateSemaphore(0);
+
+	if (renderAhead.mutex == NULL || renderAhead.sem == NULL)
+		return false;
+
+	renderAhead.chunkSamples = audioBufferSize;
+	renderAhead.targetSamples = ((renderAheadMs * audioFreq) / 1000) + audioBufferSize;
+
+	int32_t ringBufferLen = 1024;
+	while (ringBufferLen <= renderAhead.targetSamples + renderAhead.chunkSamples)
+		ringBufferLen <<= 1;
+
+	renderAhead.mask = ringBufferLen - 1;
+	renderAhead.ringBuffer = (uint8_t *)malloc(ringBufferLen << smpShiftValue);
+	renderAhead.chunkBuffer = (uint8_t *)malloc(renderAhead.chunkSamples << smpShiftValue);
+
+	if (renderAhead.ringBuffer == NULL || renderAhead.chunkBuffer == NULL)
+	{
+		closeRenderAhead();
+		return false;
+	}
+
+	flushRenderAheadBuffer();
+	renderAhead.quit = renderAhead.running = false;
+	renderAhead.active = true;
+
+	renderAhead.thread = SDL_CreateThread(renderAheadThreadFunc, NULL, NULL);
+	if (renderAhead.thread == NULL)
+	{
+		closeRenderAhead();
+		return false;
+	}
+
+	return true;
+}
+
 static bool setupAudioBuffers(void)
 {
 	const int32_t maxAudioFreq = MAX(MAX_AUDIO_FREQ, MAX_WAV_RENDER_FREQ);
 	int32_t maxSamplesPerTick = (int32_t)ceil(maxAudioFreq / (MIN_BPM / 2.5)) + 1;
 
+#if MIXER_INTERLEAVED_BUFFER
+	audio.fMixBufferL = (float *)calloc(maxSamplesPerTick * 2, sizeof (float));
+	if (audio.fMixBufferL == NULL)
+		return false;
+
+	audio.fMixBufferR = audio.fMixBufferL + 1;
+#else
 	audio.fMixBufferL = (float *)calloc(maxSamplesPerTick, sizeof (float));
 	audio.fMixBufferR = (float *)calloc(maxSamplesPerTick, sizeof (float));
 
 	if (audio.fMixBufferL == NULL || audio.fMixBufferR == NULL)
 		return false;
+#endif
 
 	return true;
 }
@@ -903,11 +1538,82 @@ static void freeAudioBuffers(void)
 		audio.fMixBufferL = NULL;
 	}
 
+#if MIXER_INTERLEAVED_BUFFER
+	audio.fMixBufferR = NULL; // points into fMixBufferL
+#else
 	if (audio.fMixBufferR != NULL)
 	{
 		free(audio.fMixBufferR);
 		audio.fMixBufferR = NULL;
 	}
+#endif
+}
+
+static void freeSyncQueues(void)
+{
+	if (pattSync.data != NULL)
+	{
+		free(pattSync.data);
+		pattSync.data = NULL;
+	}
+
+	if (chSync.ticks != NULL)
+	{
+		free(chSync.ticks);
+		chSync.ticks = NULL;
+	}
+
+	if (chSync.updates != NULL)
+	{
+		free(chSync.updates);
+		chSync.updates = NULL;
+	}
+
+	pattSync.mask = chSync.mask = chSync.updateMask = 0;
+
+	// audio is closed and the video thread is this thread, so the positions can be cleared directly
+	SDL_AtomicSet(&pattSync.readPos, 0);
+	SDL_AtomicSet(&pattSync.writePos, 0);
+	SDL_AtomicSet(&pattSync.resetRequested, 0);
+	SDL_AtomicSet(&chSync.readPos, 0);
+	SDL_AtomicSet(&chSync.writePos, 0);
+	SDL_AtomicSet(&chSync.resetRequested, 0);
+	chSync.updateWritePos = 0;
+	chSyncFullUpdate = true;
+	fullVisualsSyncUpdate = true;
+}
+
+// the queues only need to hold the ticks that are in flight (audio latency + video thread lag)
+static bool setupSyncQueues(double dAudioLatencyMs)
+{
+	freeSyncQueues();
+
+	const double dMinTickTimeMs = 2500.0 / MAX_BPM;
+	const int32_t ticksInFlight = (int32_t)ceil((dAudioLatencyMs + SYNC_QUEUE_MARGIN_MS) / dMinTickTimeMs) + 1;
+
+	int32_t queueLen = 16;
+	while (queueLen < ticksInFlight)
+		queueLen <<= 1;
+
+	int32_t updateQueueLen = queueLen;
+	while (updateQueueLen < queueLen * MAX_CHANNELS)
+		updateQueueLen <<= 1;
+
+	// cleared, so that unwritten entries are always invalid (zero timestamp)
+	pattSync.data = (pattSyncData_t *)calloc(queueLen, sizeof (pattSyncData_t));
+	chSync.ticks = (chSyncTick_t *)calloc(queueLen, sizeof (chSyncTick_t));
+	chSync.updates = (chSyncUpdate_t *)calloc(updateQueueLen, sizeof (chSyncUpdate_t));
+
+	if (pattSync.data == NULL || chSync.ticks == NULL || chSync.updates == NULL)
+	{
+		freeSyncQueues();
+		return false;
+	}
+
+	pattSync.mask = chSync.mask = queueLen - 1;
+	chSync.updateMask = updateQueueLen - 1;
+
+	return true;
 }
 
 static void calcAudioLatencyVars(int32_t audioBufferSize, int32_t audioFreq)
@@ -1037,6 +1743,16 @@ bool setupAudio(bool showErrorMsg)
 	config.audioFreq = audio.freq = have.freq;
 
 	calcAudioLatencyVars(have.samples, have.freq);
+
+	if (!setupSyncQueues(audio.dAudioLatencyMs + config.renderAheadMs))
+	{
+		if (showErrorMsg)
+			showErrorMsgBox("Not enough memory!");
+
+		closeAudio();
+		return false;
+	}
+
 	smpShiftValue = (newBitDepth == 16) ? 2 : 3;
 
 	// make a copy of the new known working audio settings
@@ -1073,6 +1789,32 @@ bool setupAudio(bool showErrorMsg)
 	setWavRenderFrequency(audio.freq);
 	setWavRenderBitDepth((config.specialFlags & BITDEPTH_32) ? 32 : 16);
 
+	// the thread stays idle until resumeAudio() (same as the audio device)
+	if (!setupRenderAhead(config.renderAheadMs, have.samples, have.freq))
+	{
+		config.renderAheadMs = 0; // fall back to mixing in the audio callback
+
+		if (showErrorMsg)
+			showErrorMsgBox("Couldn't start the audio render-ahead thread!");
+	}
+
+	return true;
+}
+
+bool setupAudioNoDevice(uint32_t freq) // for command-line rendering (no audio device is opened)
+{
+	closeAudio();
+
+	if (!setupAudioBuffers())
+		return false;
+
+	audio.freq = freq;
+	calcReplayerVars(audio.freq);
+
+	for (int32_t i = 0; i < MAX_CHANNELS; i++)
+		stopVoice(i);
+
+	audio.tickSampleCounterFrac = audio.tickSampleCounter = 0;
 	return true;
 }
 
@@ -1085,5 +1827,7 @@ void closeAudio(void)
 		audio.dev = 0;
 	}
 
+	closeRenderAhead();
 	freeAudioBuffers();
+	freeSyncQueues();
 }
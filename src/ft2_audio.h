@@ -34,8 +34,11 @@ enum
 #define TICK_TIME_FRAC_SCALE (1ULL << TICK_TIME_FRAC_BITS)
 #define TICK_TIME_FRAC_MASK (TICK_TIME_FRAC_SCALE-1)
 
-// for audio/video sync queue. (2^n-1 - don't change this! Queue buffer is already BIG in size)
-#define SYNC_QUEUE_LEN 4095
+/* The audio/video sync queues are sized from the audio latency (see setupSyncQueues()).
+** This is how much extra time (on top of the latency) the video thread can lag
+** behind before ticks get dropped.
+*/
+#define SYNC_QUEUE_MARGIN_MS 500
 
 typedef struct audio_t
 {
@@ -62,6 +65,21 @@ typedef struct audio_t
 	uint32_t wantFreq, haveFreq, wantSamples, haveSamples;
 } audio_t;
 
+// audio thread timing, written by renderSamples() and shown next to the FPS counter (ft2_video.c)
+#define AUDIO_STATS_HIST_BINS 11 // render time in 10% steps of the real-time length, last bin is >=100%
+
+typedef struct audioStats_t
+{
+	volatile bool resetFlag; // set by the video thread, handled by the audio thread
+	volatile uint64_t renders, deadlineMisses, underruns;
+	volatile uint64_t replayerTime64, mixTime64, outputTime64, periodTime64; // accumulated HPC ticks
+	volatile uint64_t worstTime64, worstPeriod64;
+	volatile uint32_t histogram[AUDIO_STATS_HIST_BINS];
+
+	volatile bool profileVoices; // time each channel's voices in doChannelMixing() (toggled with CTRL+SHIFT+P)
+	volatile uint64_t voiceTime64[MAX_CHANNELS]; // accumulated HPC ticks, never reset (read as deltas)
+} audioStats_t;
+
 typedef struct
 {
 	const int8_t *base8, *revBase8;
@@ -98,39 +116,66 @@ pattSyncData_t;
 #pragma pack(pop)
 #endif
 
+/* Audio/video sync queues. These are lock-free single-producer/single-consumer ring buffers:
+** the audio thread pushes one entry per replayer tick, and the video thread pops them.
+** readPos is only written by the consumer, writePos only by the producer. resetSyncQueues()
+** only sets resetRequested: the producer stops pushing, and the consumer empties the queue
+** (readPos = writePos) and then clears the flag.
+*/
 typedef struct pattSync_t
 {
-	volatile int32_t readPos, writePos;
-	pattSyncData_t data[SYNC_QUEUE_LEN+1];
+	SDL_atomic_t readPos, writePos, resetRequested;
+	int32_t mask; // queue length - 1 (length is a power of two)
+	pattSyncData_t *data;
 } pattSync_t;
 
-typedef struct chSyncData_t
+typedef struct chSyncData_t // full channel state, as seen by the video thread
 {
 	syncedChannel_t channels[MAX_CHANNELS];
 	uint64_t timestamp;
 } chSyncData_t;
 
+#ifdef _MSC_VER
+#pragma pack(push)
+#pragma pack(1)
+#endif
+typedef struct chSyncUpdate_t // one channel that changed on a tick (pack to save RAM)
+{
+	uint8_t channel;
+	syncedChannel_t state;
+}
+#ifdef __GNUC__
+__attribute__ ((packed))
+#endif
+chSyncUpdate_t;
+#ifdef _MSC_VER
+#pragma pack(pop)
+#endif
+
+typedef struct chSyncTick_t
+{
+	uint64_t timestamp;
+	int32_t firstUpdate, numUpdates; // range in chSync_t.updates[]
+} chSyncTick_t;
+
 typedef struct chSync_t
 {
-	volatile int32_t readPos, writePos;
-	chSyncData_t data[SYNC_QUEUE_LEN+1];
+	SDL_atomic_t readPos, writePos, resetRequested;
+	int32_t mask, updateMask, updateWritePos;
+	chSyncTick_t *ticks;
+	chSyncUpdate_t *updates; // MAX_CHANNELS per tick slot, so this can't overflow before ticks[] does
 } chSync_t;
 
 void resetCachedMixerVars(void);
 int32_t pattQueueReadSize(void);
-int32_t pattQueueWriteSize(void);
 bool pattQueuePush(pattSyncData_t t);
-bool pattQueuePop(void);
-bool pattQueuePop(void);
-pattSyncData_t *pattQueuePeek(void);
+pattSyncData_t *pattQueuePop(void);
 uint64_t getPattQueueTimestamp(void);
 int32_t chQueueReadSize(void);
-int32_t chQueueWriteSize(void);
-bool chQueuePush(chSyncData_t t);
-bool chQueuePop(void);
-chSyncData_t *chQueuePeek(void);
+bool chQueuePush(const chSyncData_t *chSyncData);
+chSyncData_t *chQueuePop(uint8_t *scopeUpdateStatus);
 uint64_t getChQueueTimestamp(void);
-void resetSyncQueues(void);
+void resetSyncQueues(void); // audio thread must be locked (or not running)
 
 void decreaseMasterVol(void);
 void increaseMasterVol(void);
@@ -143,13 +188,23 @@ void setMixerBPM(int32_t bpm);
 void audioSetVolRamp(bool volRamp);
 void audioSetInterpolationType(uint8_t interpolationType);
 void stopVoice(int32_t i);
+bool isSmpDataUsedByVoices(const int8_t *dataPtr);
+void moveVoiceLeftEdgeTaps(const sample_t *s, const int8_t *taps8, const int16_t *taps16);
 bool setupAudio(bool showErrorMsg);
+bool setupAudioNoDevice(uint32_t freq); // for command-line rendering
 void closeAudio(void);
 void pauseAudio(void);
 void resumeAudio(void);
 bool setNewAudioSettings(void);
 void lockAudio(void);
 void unlockAudio(void);
+
+/* Locks the audio thread (and the render-ahead thread) without touching audio.locked. Use these
+** in code that can run on other threads than the main thread (audio.locked doesn't say which thread
+** holds the lock). They can be nested, also inside lockAudio()/unlockAudio().
+*/
+void lockAudioThreads(void);
+void unlockAudioThreads(void);
 void lockMixerCallback(void);
 void unlockMixerCallback(void);
 void resetRampVolumes(void);
@@ -158,9 +213,8 @@ void mixReplayerTickToBuffer(uint32_t samplesToMix, void *stream, uint8_t bitDep
 
 // in ft2_audio.c
 extern audio_t audio;
+extern audioStats_t audioStats;
 extern pattSyncData_t *pattSyncEntry;
 extern chSyncData_t *chSyncEntry;
 extern chSync_t chSync;
 extern pattSync_t pattSync;
-
-extern volatile bool pattQueueClearing, chQueueClearing;
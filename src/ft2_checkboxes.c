@@ -83,6 +83,8 @@ checkBox_t checkBoxes[NUM_CHECKBOXES] =
 	//x,   y,   w,   h,  funcOnUp
 	{   3,  91,  77, 12, cbToggleAutoSaveConfig },
 	{ 508, 158, 107, 12, cbConfigVolRamp },
+	{ 447,  73,  52, 12, cbConfigDither },
+	{ 447,  43,  52, 12, cbConfigRenderAhead },
 	{ 113,  14, 108, 12, cbConfigPattStretch },
 	{ 113,  27, 117, 12, cbConfigHexCount },
 	{ 113,  40,  81, 12, cbConfigAccidential },
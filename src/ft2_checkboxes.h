@@ -55,6 +55,8 @@ enum // CHECKBOXES
 
 	// CONFIG AUDIO
 	CB_CONF_VOL_RAMP,
+	CB_CONF_DITHER,
+	CB_CONF_RENDER_AHEAD,
 
 	// CONFIG LAYOUT
 	CB_CONF_PATTSTRETCH,
@@ -139,6 +139,7 @@ static void loadConfigFromBuffer(bool defaults)
 	config.NI_Speed = CLAMP(config.NI_Speed, 0, 3);
 	config.recMIDIVolSens = CLAMP(config.recMIDIVolSens, 0, 200);
 	config.recMIDIChn  = CLAMP(config.recMIDIChn, 1, 16);
+	config.renderAheadMs = CLAMP(config.renderAheadMs, 0, MAX_RENDER_AHEAD_MS);
 
 	if (config.interpolation > 4)
 		config.interpolation = INTERPOLATION_SINC8; // default (sinc, 8 point)
@@ -246,6 +247,11 @@ static void updateImageStretchAndPixelFilter(uint8_t oldWindowFlags, uint8_t old
 	}
 }
 
+bool multiRecChnEnabled(int32_t ch)
+{
+	return ch >= 0 && ch < CONFIG_MULTIREC_CHANNELS && config.multiRecChn[ch];
+}
+
 void resetConfig(void)
 {
 	if (okBox(2, "System request", "Are you sure you want to reset your FT2 configuration?", NULL) != 1)
@@ -737,6 +743,21 @@ void loadConfigOrSetDefaults(void)
 	loadConfigFromBuffer(false);
 }
 
+void setDefaultConfigNoGUI(void) // for command-line rendering (no window or audio device)
+{
+	memcpy(&config, defConfigData, CONFIG_FILE_SIZE);
+
+	config.audioFreq = DEFAULT_AUDIO_FREQ;
+	config.boostLevel = CLAMP(config.boostLevel, 1, 32);
+	config.masterVol = CLAMP(config.masterVol, 0, 256);
+
+	if (config.interpolation > 4)
+		config.interpolation = INTERPOLATION_SINC8;
+
+	if (config.specialFlags == 64)
+		config.specialFlags = BUFFSIZE_1024 | BITDEPTH_16;
+}
+
 // GUI-related code
 
 static void drawQuantValue(void)
@@ -882,7 +903,11 @@ void setConfigAudioRadioButtonStates(void) // accessed by other .c files
 static void setConfigAudioCheckButtonStates(void)
 {
 	checkBoxes[CB_CONF_VOL_RAMP].checked = (config.specialFlags & NO_VOLRAMP_FLAG) ? false : true;
+	checkBoxes[CB_CONF_DITHER].checked = (config.specialFlags2 & DITHER_16BIT_OUTPUT) ? true : false;
+	checkBoxes[CB_CONF_RENDER_AHEAD].checked = (config.renderAheadMs > 0) ? true : false;
 	showCheckBox(CB_CONF_VOL_RAMP);
+	showCheckBox(CB_CONF_DITHER);
+	showCheckBox(CB_CONF_RENDER_AHEAD);
 }
 
 static void setConfigLayoutCheckButtonStates(void)
@@ -1166,9 +1191,11 @@ void showConfigScreen(void)
 			textOutShadow(406,  17, PAL_FORGRND, PAL_DSKTOP2, "Small");
 			textOutShadow(406,  31, PAL_FORGRND, PAL_DSKTOP2, "Medium (default)");
 			textOutShadow(406,  45, PAL_FORGRND, PAL_DSKTOP2, "Large");
+			textOutShadow(464,  45, PAL_FORGRND, PAL_DSKTOP2, "Ahead");
 
 			textOutShadow(390,  61, PAL_FORGRND, PAL_DSKTOP2, "Audio bit depth:");
 			textOutShadow(406,  75, PAL_FORGRND, PAL_DSKTOP2, "16-bit");
+			textOutShadow(464,  75, PAL_FORGRND, PAL_DSKTOP2, "Dither");
 			textOutShadow(406,  89, PAL_FORGRND, PAL_DSKTOP2, "32-bit (float)");
 
 			textOutShadow(406, 105, PAL_FORGRND, PAL_DSKTOP2, "No interpolation");
@@ -1425,6 +1452,8 @@ void hideConfigScreen(void)
 	hideRadioButtonGroup(RB_GROUP_CONFIG_AUDIO_INPUT_FREQ);
 	hideRadioButtonGroup(RB_GROUP_CONFIG_FREQ_SLIDES);
 	hideCheckBox(CB_CONF_VOL_RAMP);
+	hideCheckBox(CB_CONF_DITHER);
+	hideCheckBox(CB_CONF_RENDER_AHEAD);
 	hidePushButton(PB_CONFIG_AUDIO_RESCAN);
 	hidePushButton(PB_CONFIG_AUDIO_OUTPUT_DOWN);
 	hidePushButton(PB_CONFIG_AUDIO_OUTPUT_UP);
@@ -1711,6 +1740,17 @@ void cbConfigVolRamp(void)
 	audioSetVolRamp((config.specialFlags & NO_VOLRAMP_FLAG) ? false : true);
 }
 
+void cbConfigDither(void)
+{
+	config.specialFlags2 ^= DITHER_16BIT_OUTPUT;
+}
+
+void cbConfigRenderAhead(void)
+{
+	config.renderAheadMs = (config.renderAheadMs > 0) ? 0 : DEFAULT_RENDER_AHEAD_MS;
+	setNewAudioSettings();
+}
+
 // CONFIG LAYOUT
 
 static void redrawPatternEditor(void) // called after changing some pattern editor settings in config
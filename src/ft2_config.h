@@ -8,6 +8,11 @@
 
 #define CFG_ID_STR "FastTracker 2.0 configuration file\x1A"
 #define CONFIG_FILE_SIZE 1736
+#define CONFIG_MULTIREC_CHANNELS 32 // config.multiRecChn[] (part of the FT2.CFG layout, doesn't follow MAX_CHANNELS)
+
+// audio render-ahead thread (config.renderAheadMs)
+#define DEFAULT_RENDER_AHEAD_MS 40
+#define MAX_RENDER_AHEAD_MS 250
 
 enum
 {
@@ -88,6 +93,7 @@ enum
 	HARDWARE_MOUSE = 2,
 	STRETCH_IMAGE = 4,
 	USE_OS_MOUSE_POINTER = 8,
+	DITHER_16BIT_OUTPUT = 16, // TPDF dither on 16-bit output
 
 	// windowFlags
 	WINSIZE_AUTO = 1,
@@ -126,12 +132,13 @@ typedef struct config_t // exact FT2.CFG layout (with some modifications)
 	uint8_t interpolation, internMode, stereoMode;
 	uint8_t specialFlags2; // was lo-byte of "sample16Bit" (was used for external audio sampling)
 	uint8_t dontShowAgainFlags; // was hi-byte of "sample16Bit" (was used for external audio sampling)
-	int16_t inEnhet, sbPort, sbDMA, sbHiDMA, sbInt, sbOutFilter;
+	int16_t inEnhet, sbPort, sbDMA, sbHiDMA, sbInt;
+	int16_t renderAheadMs; // was "sbOutFilter" (not used in our clone). 0 = mix in the audio callback
 	uint8_t true16Bit, ptnStretch, ptnHex, ptnInstrZero, ptnFrmWrk, ptnLineLight, ptnShowVolColumn, ptnChnNumbers;
 	int16_t ptnLineLightStep, ptnFont, ptnAcc;
 	pal16 userPal[16];
 	uint16_t comMacro[10], volMacro[10];
-	uint8_t multiRec, multiKeyJazz, multiEdit, multiRecChn[32], recRelease, recQuant;
+	uint8_t multiRec, multiKeyJazz, multiEdit, multiRecChn[CONFIG_MULTIREC_CHANNELS], recRelease, recQuant;
 	int16_t recQuantRes;
 	uint8_t recTrueInsert;
 	int16_t recMIDIChn;
@@ -182,11 +189,13 @@ config_t;
 #endif
 
 void resetConfig(void);
+bool multiRecChnEnabled(int32_t ch); // config.multiRecChn[] only has 32 channels, the rest are off
 bool loadConfig(bool showErrorFlag);
 void loadConfig2(void); // called by "Load config" button
 bool saveConfig(bool showErrorFlag);
 void saveConfig2(void); // called by "Save config" button
 void loadConfigOrSetDefaults(void);
+void setDefaultConfigNoGUI(void); // for command-line rendering
 void showConfigScreen(void);
 void hideConfigScreen(void);
 void exitConfigScreen(void);
@@ -258,6 +267,8 @@ void rbWinSize3x(void);
 void rbWinSize4x(void);
 void cbToggleAutoSaveConfig(void);
 void cbConfigVolRamp(void);
+void cbConfigDither(void);
+void cbConfigRenderAhead(void);
 void cbConfigPattStretch(void);
 void cbConfigHexCount(void);
 void cbConfigAccidential(void);
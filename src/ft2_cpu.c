@@ -0,0 +1,25 @@
+#if defined _MSC_VER && (defined _M_X64 || defined _M_IX86)
+#include <intrin.h> // __cpuid()
+#elif defined __amd64__ || defined __i386__
+#include <cpuid.h> // __get_cpuid()
+#endif
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft2_cpu.h"
+
+bool cpuHasFMA(void)
+{
+#if defined _MSC_VER && (defined _M_X64 || defined _M_IX86)
+	int32_t regs[4];
+	__cpuid(regs, 1);
+	return !!(regs[2] & (1 << 12));
+#elif defined __amd64__ || defined __i386__
+	uint32_t eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return false;
+
+	return !!(ecx & (1 << 12));
+#else
+	return false;
+#endif
+}
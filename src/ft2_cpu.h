@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef _WIN32
 
@@ -30,3 +31,5 @@
 #define uintCPUWord_t uint32_t
 #define intCPUWord_t int32_t
 #endif
+
+bool cpuHasFMA(void); // SDL2 doesn't have a test for this one
@@ -39,6 +39,8 @@
 #include "ft2_video.h"
 #include "ft2_inst_ed.h"
 #include "ft2_structs.h"
+#include "ft2_hpc.h"
+#include "ft2_diskop_cache.h"
 
 // hide POSIX warnings for chdir()
 #ifdef _MSC_VER
@@ -48,6 +50,8 @@
 #define FILENAME_TEXT_X 170
 #define FILESIZE_TEXT_X 295
 #define DISKOP_MAX_DRIVE_BUTTONS 8
+#define DISKOP_MIN_BUFFER_ENTRIES 256 // the entry buffer starts at this size and doubles when full
+#define DISKOP_PUBLISH_INTERVAL_MS 100 // show what we have read so far at this rate while reading
 
 #ifdef _WIN32
 #define PARENT_DIR_STR L".."
@@ -68,6 +72,7 @@ enum
 typedef struct DirRec
 {
 	UNICHAR *nameU;
+	char *sortKey; // made once when the entry is read (see ach())
 	bool isDir;
 	int32_t filesize;
 } DirRec;
@@ -81,6 +86,8 @@ static int32_t FReq_EntrySelected = -1, FReq_FileCount, FReq_DirPos, lastMouseY;
 static UNICHAR *FReq_CurPathU, *FReq_ModCurPathU, *FReq_InsCurPathU, *FReq_SmpCurPathU, *FReq_PatCurPathU, *FReq_TrkCurPathU;
 static DirRec *FReq_Buffer;
 static SDL_Thread *thread;
+static SDL_mutex *dirBufferMutex; // FReq_Buffer/FReq_FileCount (the read thread publishes entries while running)
+static volatile bool dirReadInProgress; // set when the read thread is started, cleared by the thread when done
 
 static void setDiskOpItem(uint8_t item);
 
@@ -265,6 +272,9 @@ static void freeDirRecBuffer(void)
 		{
 			if (FReq_Buffer[i].nameU != NULL)
 				free(FReq_Buffer[i].nameU);
+
+			if (FReq_Buffer[i].sortKey != NULL)
+				free(FReq_Buffer[i].sortKey);
 		}
 
 		free(FReq_Buffer);
@@ -301,7 +311,14 @@ void freeDiskOp(void)
 	if (FReq_TrkCurPathU != NULL) { free(FReq_TrkCurPathU); FReq_TrkCurPathU = NULL; }
 	if (modTmpFNameUTF8 != NULL) { free(modTmpFNameUTF8); modTmpFNameUTF8 = NULL; }
 
+	freeDiskOpCache();
 	freeDirRecBuffer();
+
+	if (dirBufferMutex != NULL)
+	{
+		SDL_DestroyMutex(dirBufferMutex);
+		dirBufferMutex = NULL;
+	}
 }
 
 bool setupDiskOp(void)
@@ -319,10 +336,13 @@ bool setupDiskOp(void)
 	FReq_PatCurPathU = (UNICHAR *)malloc((PATH_MAX + 1) * sizeof (UNICHAR));
 	FReq_TrkCurPathU = (UNICHAR *)malloc((PATH_MAX + 1) * sizeof (UNICHAR));
 
+	dirBufferMutex = SDL_CreateMutex();
+
 	if (modTmpFName      == NULL || insTmpFName      == NULL || smpTmpFName      == NULL ||
 		patTmpFName      == NULL || trkTmpFName      == NULL || FReq_NameTemp    == NULL ||
 		FReq_ModCurPathU == NULL || FReq_InsCurPathU == NULL || FReq_SmpCurPathU == NULL ||
-		FReq_PatCurPathU == NULL || FReq_TrkCurPathU == NULL)
+		FReq_PatCurPathU == NULL || FReq_TrkCurPathU == NULL || dirBufferMutex   == NULL ||
+		!setupDiskOpCache())
 	{
 		// allocated memory is free'd lateron
 		showErrorMsgBox("Not enough memory!");
@@ -1552,22 +1572,8 @@ static void findClose(void)
 	}
 }
 
-static bool swapBufferEntry(int32_t a, int32_t b) // used for sorting
+static char *ach(const DirRec *dirEntry) // makes the sort key for an entry (used for sortDirectory())
 {
-	if (a >= FReq_FileCount || b >= FReq_FileCount)
-		return false;
-
-	DirRec tmpBuffer = FReq_Buffer[a];
-	FReq_Buffer[a] = FReq_Buffer[b];
-	FReq_Buffer[b] = tmpBuffer;
-
-	return true;
-}
-
-static char *ach(int32_t rad) // used for sortDirectory()
-{
-	DirRec *dirEntry = &FReq_Buffer[rad];
-
 	char *name = unicharToCp437(dirEntry->nameU, true);
 	if (name == NULL)
 		return NULL;
@@ -1634,53 +1640,24 @@ static char *ach(int32_t rad) // used for sortDirectory()
 	}
 }
 
-static void sortDirectory(void)
+static int dirEntryCompare(const void *a, const void *b) // qsort() callback
 {
-	bool didSwap;
-
-	if (FReq_FileCount < 2)
-		return; // no need to sort
+	const char *p1 = ((const DirRec *)a)->sortKey;
+	const char *p2 = ((const DirRec *)b)->sortKey;
 
-	uint32_t offset = FReq_FileCount >> 1;
-	while (offset > 0)
-	{
-		const uint32_t limit = FReq_FileCount - offset;
-		do
-		{
-			didSwap = false;
-			for (uint32_t i = 0; i < limit; i++)
-			{
-				char *p1 = ach(i);
-				char *p2 = ach(offset+i);
-
-				if (p1 == NULL || p2 == NULL)
-				{
-					if (p1 != NULL) free(p1);
-					if (p2 != NULL) free(p2);
-					okBox(0, "System message", "Not enough memory!", NULL);
-					return;
-				}
+	// entries without a key (empty name or out of memory) go first
+	if (p1 == NULL) p1 = "";
+	if (p2 == NULL) p2 = "";
 
-				if (_stricmp(p1, p2) > 0)
-				{
-					if (!swapBufferEntry(i, offset + i))
-					{
-						free(p1);
-						free(p2);
-						return;
-					}
-
-					didSwap = true;
-				}
+	return _stricmp(p1, p2);
+}
 
-				free(p1);
-				free(p2);
-			}
-		}
-		while (didSwap);
+static void sortDirectory(DirRec *buffer, int32_t numEntries)
+{
+	if (numEntries < 2)
+		return; // no need to sort
 
-		offset >>= 1;
-	}
+	qsort(buffer, numEntries, sizeof (DirRec), dirEntryCompare);
 }
 
 static uint8_t numDigits32(uint32_t x)
@@ -1814,8 +1791,13 @@ void diskOp_DrawFilelist(void)
 {
 	clearRect(FILENAME_TEXT_X-1, 4, 162, 164);
 
+	SDL_LockMutex(dirBufferMutex); // the read thread may be running
+
 	if (FReq_FileCount == 0)
+	{
+		SDL_UnlockMutex(dirBufferMutex);
 		return;
+	}
 
 	// draw "selected file" rectangle
 	if (FReq_EntrySelected != -1)
@@ -1860,10 +1842,85 @@ void diskOp_DrawFilelist(void)
 		if (!FReq_Buffer[bufEntry].isDir)
 			printFormattedFilesize(FILESIZE_TEXT_X, y, bufEntry);
 	}
+
+	SDL_UnlockMutex(dirBufferMutex);
+}
+
+static int32_t infoEntry = -1; // entry whose file info is shown in the path line (-1 = none)
+
+static int32_t getMouseOverEntry(void)
+{
+	if (mouse.x < FILENAME_TEXT_X-1 || mouse.x >= FILENAME_TEXT_X-1+162 || mouse.y < 4)
+		return -1;
+
+	const int32_t row = (mouse.y - 4) / (FONT1_CHAR_H + 1);
+	if (row >= DISKOP_ENTRY_NUM)
+		return -1;
+
+	const int32_t bufEntry = FReq_DirPos + row;
+	if (bufEntry >= FReq_FileCount || FReq_Buffer[bufEntry].isDir)
+		return -1;
+
+	return bufEntry;
+}
+
+static void drawFileInfo(const fileInfo_t *info)
+{
+	char text[64];
+
+	if (info->type == FILEINFO_MODULE)
+	{
+		sprintf(text, "%s %dch: %s", info->formatName, info->numChannels, info->name);
+	}
+	else
+	{
+		const char *chnText = (info->numChannels == 1) ? "mono" : (info->numChannels == 2) ? "stereo" : "multi";
+		const int32_t seconds = (info->sampleRate > 0) ? (info->sampleLength / info->sampleRate) : 0;
+
+		sprintf(text, "%s %dHz %db %s %ds", info->formatName, info->sampleRate, info->bitDepth, chnText, seconds);
+	}
+
+	fillRect(4, 145, 162, 10, PAL_DESKTOP);
+	textOutClipX(4, 145, PAL_FORGRND, text, 165);
+}
+
+// shows the cached header info of the file under the mouse in the path line (called every frame)
+void diskOp_HandleFileInfo(void)
+{
+	fileInfo_t info;
+
+	if (dirReadInProgress)
+		return;
+
+	const bool updated = diskOpCacheUpdated();
+
+	SDL_LockMutex(dirBufferMutex);
+
+	const int32_t entry = getMouseOverEntry();
+	if (entry == infoEntry && !updated)
+	{
+		SDL_UnlockMutex(dirBufferMutex);
+		return;
+	}
+
+	bool hasInfo = false;
+	if (entry != -1 && diskOpCacheGetInfo(FReq_CurPathU, FReq_Buffer[entry].nameU, &info))
+		hasInfo = (info.type != FILEINFO_NONE);
+
+	SDL_UnlockMutex(dirBufferMutex);
+
+	if (hasInfo)
+		drawFileInfo(&info);
+	else if (infoEntry != -1)
+		displayCurrPath();
+
+	infoEntry = hasInfo ? entry : -1;
 }
 
 void diskOp_DrawDirectory(void)
 {
+	infoEntry = -1;
+
 	drawTextBox(TB_DISKOP_FILENAME);
 
 	displayCurrPath();
@@ -1890,85 +1947,138 @@ static DirRec *bufferCreateEmptyDir(void) // special case: creates a dir entry w
 		return NULL;
 	}
 
+	dirEntry->sortKey = NULL;
 	dirEntry->isDir = true;
 	dirEntry->filesize = 0;
 
 	return dirEntry;
 }
 
+// sorts the entries read so far and lets the main thread show them
+static void publishDirEntries(int32_t numEntries)
+{
+	SDL_LockMutex(dirBufferMutex);
+	sortDirectory(FReq_Buffer, numEntries);
+	FReq_FileCount = numEntries;
+	SDL_UnlockMutex(dirBufferMutex);
+
+	editor.diskOpReadUpdate = true;
+}
+
+// lets the Disk Op. cache read the headers of the files in this directory (in its own thread)
+static void startFileInfoScan(int32_t numEntries)
+{
+	UNICHAR **namesU = (UNICHAR **)malloc(numEntries * sizeof (UNICHAR *));
+	if (namesU == NULL)
+		return;
+
+	int32_t numNames = 0;
+	for (int32_t i = 0; i < numEntries; i++)
+	{
+		if (FReq_Buffer[i].isDir || FReq_Buffer[i].nameU == NULL)
+			continue;
+
+		namesU[numNames] = UNICHAR_STRDUP(FReq_Buffer[i].nameU);
+		if (namesU[numNames] != NULL)
+			numNames++;
+	}
+
+	const bool samples = (FReq_Item != DISKOP_ITEM_MODULE);
+	diskOpCacheScanDir(FReq_CurPathU, namesU, numNames, samples);
+}
+
 static int32_t SDLCALL diskOp_ReadDirectoryThread(void *ptr)
 {
 	DirRec tmpBuffer;
+	int32_t numEntries = 0, bufferSize = 0;
 
+	SDL_LockMutex(dirBufferMutex);
 	FReq_DirPos = 0;
+	freeDirRecBuffer(); // free old buffer
+	SDL_UnlockMutex(dirBufferMutex);
 
-	// free old buffer
-	freeDirRecBuffer();
-
+	diskOpCacheStopScan(); // stop reading file info from the previous directory
 	UNICHAR_GETCWD(FReq_CurPathU, PATH_MAX);
 
-	// read first file
+	/* Entries past FReq_FileCount are only touched by this thread, so they are added without
+	** locking. The mutex is only needed when the buffer moves (realloc) or when the entries
+	** read so far are sorted and published (FReq_FileCount is increased).
+	*/
+	uint64_t lastPublishTime64 = SDL_GetPerformanceCounter();
+
 	int8_t lastFindFileFlag = findFirst(&tmpBuffer);
-	if (lastFindFileFlag != LFF_DONE && lastFindFileFlag != LFF_SKIP)
+	while (lastFindFileFlag != LFF_DONE)
 	{
-		FReq_Buffer = (DirRec *)malloc(sizeof (DirRec) * (FReq_FileCount+1));
-		if (FReq_Buffer == NULL)
+		if (lastFindFileFlag != LFF_SKIP)
 		{
-			findClose();
+			if (numEntries == bufferSize) // buffer is full, double its size
+			{
+				const int32_t newBufferSize = (bufferSize == 0) ? DISKOP_MIN_BUFFER_ENTRIES : (bufferSize * 2);
 
-			okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+				SDL_LockMutex(dirBufferMutex);
+				DirRec *newPtr = (DirRec *)realloc(FReq_Buffer, sizeof (DirRec) * newBufferSize);
+				if (newPtr != NULL)
+					FReq_Buffer = newPtr;
+				SDL_UnlockMutex(dirBufferMutex);
 
-			FReq_Buffer = bufferCreateEmptyDir();
-			if (FReq_Buffer != NULL)
-				FReq_FileCount = 1;
-			else
-				okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+				if (newPtr == NULL)
+				{
+					free(tmpBuffer.nameU);
 
-			setMouseBusy(false);
-			return false;
-		}
+					SDL_LockMutex(dirBufferMutex);
+					FReq_FileCount = numEntries; // so that all entries get free'd
+					freeDirRecBuffer();
+					SDL_UnlockMutex(dirBufferMutex);
 
-		memcpy(&FReq_Buffer[FReq_FileCount], &tmpBuffer, sizeof (DirRec));
-		FReq_FileCount++;
-	}
+					numEntries = 0;
+					okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+					break;
+				}
 
-	// read remaining files
-	while (lastFindFileFlag != LFF_DONE)
-	{
-		lastFindFileFlag = findNext(&tmpBuffer);
-		if (lastFindFileFlag != LFF_DONE && lastFindFileFlag != LFF_SKIP)
-		{
-			DirRec *newPtr = (DirRec *)realloc(FReq_Buffer, sizeof (DirRec) * (FReq_FileCount + 1));
-			if (newPtr == NULL)
-			{
-				freeDirRecBuffer();
-				okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
-				break;
+				bufferSize = newBufferSize;
 			}
 
-			FReq_Buffer = newPtr;
+			tmpBuffer.sortKey = ach(&tmpBuffer);
+			FReq_Buffer[numEntries++] = tmpBuffer;
 
-			memcpy(&FReq_Buffer[FReq_FileCount], &tmpBuffer, sizeof (DirRec));
-			FReq_FileCount++;
+			const uint64_t time64 = SDL_GetPerformanceCounter();
+			if ((time64 - lastPublishTime64) * hpcFreq.dFreqMulMs >= DISKOP_PUBLISH_INTERVAL_MS)
+			{
+				publishDirEntries(numEntries);
+				lastPublishTime64 = SDL_GetPerformanceCounter();
+			}
 		}
+
+		lastFindFileFlag = findNext(&tmpBuffer);
 	}
 
 	findClose();
 
-	if (FReq_FileCount > 0)
+	if (numEntries > 0)
 	{
-		sortDirectory();
+		SDL_LockMutex(dirBufferMutex);
+		sortDirectory(FReq_Buffer, numEntries);
+		FReq_FileCount = numEntries;
+		SDL_UnlockMutex(dirBufferMutex);
+
+		if (FReq_Item == DISKOP_ITEM_MODULE || FReq_Item == DISKOP_ITEM_INSTR || FReq_Item == DISKOP_ITEM_SAMPLE)
+			startFileInfoScan(numEntries);
 	}
 	else
 	{
 		// access denied or out of memory - create parent directory link
+		SDL_LockMutex(dirBufferMutex);
+		freeDirRecBuffer();
 		FReq_Buffer = bufferCreateEmptyDir();
 		if (FReq_Buffer != NULL)
 			FReq_FileCount = 1;
-		else
+		SDL_UnlockMutex(dirBufferMutex);
+
+		if (FReq_Buffer == NULL)
 			okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
 	}
 
+	dirReadInProgress = false;
 	editor.diskOpReadDone = true;
 	setMouseBusy(false);
 
@@ -1980,11 +2090,13 @@ static int32_t SDLCALL diskOp_ReadDirectoryThread(void *ptr)
 void diskOp_StartDirReadThread(void)
 {
 	editor.diskOpReadDone = false;
+	dirReadInProgress = true;
 
 	mouseAnimOn();
 	thread = SDL_CreateThread(diskOp_ReadDirectoryThread, NULL, NULL);
 	if (thread == NULL)
 	{
+		dirReadInProgress = false;
 		editor.diskOpReadDone = true;
 		okBox(0, "System message", "Couldn't create thread!", NULL);
 		return;
@@ -44,6 +44,7 @@ void testDiskOpMouseRelease(void);
 void diskOp_StartDirReadThread(void);
 void diskOp_DrawFilelist(void);
 void diskOp_DrawDirectory(void);
+void diskOp_HandleFileInfo(void); // file info for the entry under the mouse
 void showDiskOpScreen(void);
 void hideDiskOpScreen(void);
 void exitDiskOpScreen(void);
@@ -0,0 +1,526 @@
+// for finding memory leaks in debug mode with Visual Studio
+#if defined _DEBUG && defined _MSC_VER
+#include <crtdbg.h>
+#endif
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "ft2_header.h"
+#include "ft2_unicode.h"
+#include "ft2_module_loader.h"
+#include "ft2_sample_loader.h"
+#include "ft2_diskop_cache.h"
+#include "ft2_structs.h"
+
+/* Disk Op. file info cache.
+**
+** Module/sample header info (format, song name, channels, rate, length) is kept in a hash table
+** keyed by the full path, and is validated against the file's modification time and size. The
+** table is saved next to FT2.CFG, so that revisiting a directory shows the info right away.
+**
+** The scan thread reads the headers of new or changed files in the current directory after it
+** has been read. The table is shared with the main thread (guarded by cacheMutex).
+*/
+
+#define CACHE_ID_STR "FT2 Disk Op. file info cache v1"
+#define CACHE_FILENAME "diskop.cache"
+#define CACHE_MIN_TABLE_SIZE 1024 // must be 2^n
+#define CACHE_MAX_ENTRIES (1 << 18)
+
+typedef struct cacheEntry_t
+{
+	UNICHAR *pathU; // NULL = free slot
+	uint32_t hash;
+	int64_t mtime;
+	int64_t filesize;
+	fileInfo_t info;
+} cacheEntry_t;
+
+static volatile bool scanThreadQuit, cacheUpdated;
+static bool cacheLoaded, cacheDirty, scanSamples;
+static uint32_t cacheTableSize, cacheNumEntries;
+static int32_t numScanNames;
+static cacheEntry_t *cacheTable;
+static UNICHAR *scanDirU, **scanNamesU;
+static SDL_mutex *cacheMutex;
+static SDL_Thread *scanThread;
+
+static uint32_t hashPath(const UNICHAR *pathU) // FNV-1a
+{
+	uint32_t hash = 2166136261UL;
+	while (*pathU != 0)
+	{
+		hash ^= (uint32_t)*pathU++;
+		hash *= 16777619UL;
+	}
+
+	return hash;
+}
+
+static UNICHAR *makeFullPath(const UNICHAR *dirU, const UNICHAR *nameU)
+{
+	const size_t dirLen = UNICHAR_STRLEN(dirU);
+
+	UNICHAR *pathU = (UNICHAR *)malloc((dirLen + 1 + UNICHAR_STRLEN(nameU) + 1) * sizeof (UNICHAR));
+	if (pathU == NULL)
+		return NULL;
+
+	UNICHAR_STRCPY(pathU, dirU);
+	if (dirLen == 0 || pathU[dirLen-1] != DIR_DELIMITER)
+	{
+		pathU[dirLen+0] = DIR_DELIMITER;
+		pathU[dirLen+1] = 0;
+	}
+
+	UNICHAR_STRCAT(pathU, nameU);
+	return pathU;
+}
+
+static UNICHAR *getCacheFilePathU(void) // same directory as FT2.CFG
+{
+	if (editor.configFileLocationU == NULL)
+		return NULL;
+
+	UNICHAR *pathU = UNICHAR_STRDUP(editor.configFileLocationU);
+	if (pathU == NULL)
+		return NULL;
+
+	int32_t i = (int32_t)UNICHAR_STRLEN(pathU) - 1;
+	while (i >= 0 && pathU[i] != DIR_DELIMITER)
+		i--;
+	pathU[i+1] = 0;
+
+#ifdef _WIN32
+	UNICHAR *cacheNameU = cp437ToUnichar(CACHE_FILENAME);
+#else
+	UNICHAR *cacheNameU = CACHE_FILENAME;
+#endif
+	UNICHAR *fullPathU = (cacheNameU != NULL) ? makeFullPath(pathU, cacheNameU) : NULL;
+
+#ifdef _WIN32
+	if (cacheNameU != NULL)
+		free(cacheNameU);
+#endif
+	free(pathU);
+
+	return fullPathU;
+}
+
+static bool getFileStats(const UNICHAR *pathU, int64_t *mtime, int64_t *filesize)
+{
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_wstat64(pathU, &st) != 0)
+		return false;
+#else
+	struct stat st;
+	if (stat(pathU, &st) != 0)
+		return false;
+#endif
+
+	*mtime = (int64_t)st.st_mtime;
+	*filesize = (int64_t)st.st_size;
+	return true;
+}
+
+static cacheEntry_t *findEntry(const UNICHAR *pathU, uint32_t hash) // returns a free slot if not found
+{
+	if (cacheTable == NULL)
+		return NULL;
+
+	const uint32_t mask = cacheTableSize - 1;
+
+	cacheEntry_t *e = &cacheTable[hash & mask];
+	while (e->pathU != NULL)
+	{
+		if (e->hash == hash && UNICHAR_STRCMP(e->pathU, pathU) == 0)
+			break;
+
+		hash++;
+		e = &cacheTable[hash & mask];
+	}
+
+	return e;
+}
+
+static bool growTable(void)
+{
+	const uint32_t oldTableSize = cacheTableSize;
+	cacheEntry_t *oldTable = cacheTable;
+
+	const uint32_t newTableSize = (oldTableSize == 0) ? CACHE_MIN_TABLE_SIZE : (oldTableSize * 2);
+	cacheEntry_t *newTable = (cacheEntry_t *)calloc(newTableSize, sizeof (cacheEntry_t));
+	if (newTable == NULL)
+		return false;
+
+	cacheTable = newTable;
+	cacheTableSize = newTableSize;
+
+	for (uint32_t i = 0; i < oldTableSize; i++)
+	{
+		if (oldTable[i].pathU != NULL)
+			*findEntry(oldTable[i].pathU, oldTable[i].hash) = oldTable[i];
+	}
+
+	if (oldTable != NULL)
+		free(oldTable);
+
+	return true;
+}
+
+// 'pathU' is taken over
+static bool insertEntry(UNICHAR *pathU, int64_t mtime, int64_t filesize, const fileInfo_t *info)
+{
+	const uint32_t hash = hashPath(pathU);
+
+	cacheEntry_t *e = findEntry(pathU, hash);
+	if (e != NULL && e->pathU != NULL) // already in table, update it
+	{
+		free(pathU);
+	}
+	else
+	{
+		if (cacheNumEntries >= CACHE_MAX_ENTRIES)
+		{
+			free(pathU);
+			return false;
+		}
+
+		if ((cacheNumEntries+1)*2 > cacheTableSize) // keep load factor under 50%
+		{
+			if (!growTable())
+			{
+				free(pathU);
+				return false;
+			}
+		}
+
+		e = findEntry(pathU, hash);
+		e->pathU = pathU;
+		e->hash = hash;
+		cacheNumEntries++;
+	}
+
+	e->mtime = mtime;
+	e->filesize = filesize;
+	e->info = *info;
+
+	return true;
+}
+
+static void freeTable(void)
+{
+	if (cacheTable != NULL)
+	{
+		for (uint32_t i = 0; i < cacheTableSize; i++)
+		{
+			if (cacheTable[i].pathU != NULL)
+				free(cacheTable[i].pathU);
+		}
+
+		free(cacheTable);
+		cacheTable = NULL;
+	}
+
+	cacheTableSize = cacheNumEntries = 0;
+}
+
+static void loadCache(void)
+{
+	char id[sizeof (CACHE_ID_STR)];
+	uint32_t numEntries, unicharSize, infoSize;
+
+	UNICHAR *cachePathU = getCacheFilePathU();
+	if (cachePathU == NULL)
+		return;
+
+	FILE *f = UNICHAR_FOPEN(cachePathU, "rb");
+	free(cachePathU);
+
+	if (f == NULL)
+		return; // no cache yet
+
+	// the cache is only valid for the same type of build (native byte order and struct layout)
+	if (fread(id, 1, sizeof (id), f) != sizeof (id) || memcmp(id, CACHE_ID_STR, sizeof (id)) != 0 ||
+		fread(&unicharSize, 4, 1, f) != 1 || unicharSize != sizeof (UNICHAR) ||
+		fread(&infoSize, 4, 1, f) != 1 || infoSize != sizeof (fileInfo_t) ||
+		fread(&numEntries, 4, 1, f) != 1 || numEntries > CACHE_MAX_ENTRIES)
+	{
+		fclose(f);
+		return;
+	}
+
+	for (uint32_t i = 0; i < numEntries; i++)
+	{
+		uint16_t pathLen;
+		int64_t mtime, filesize;
+		fileInfo_t info;
+
+		if (fread(&pathLen, 2, 1, f) != 1 || pathLen == 0)
+			break;
+
+		UNICHAR *pathU = (UNICHAR *)malloc((pathLen + 1) * sizeof (UNICHAR));
+		if (pathU == NULL)
+			break;
+
+		if (fread(pathU, sizeof (UNICHAR), pathLen, f) != pathLen ||
+			fread(&mtime, 8, 1, f) != 1 || fread(&filesize, 8, 1, f) != 1 ||
+			fread(&info, sizeof (fileInfo_t), 1, f) != 1)
+		{
+			free(pathU);
+			break;
+		}
+
+		pathU[pathLen] = 0;
+		info.formatName[sizeof (info.formatName)-1] = '\0';
+		info.name[sizeof (info.name)-1] = '\0';
+
+		if (!insertEntry(pathU, mtime, filesize, &info))
+			break;
+	}
+
+	fclose(f);
+}
+
+static void saveCache(void)
+{
+	UNICHAR *cachePathU = getCacheFilePathU();
+	if (cachePathU == NULL)
+		return;
+
+	FILE *f = UNICHAR_FOPEN(cachePathU, "wb");
+	free(cachePathU);
+
+	if (f == NULL)
+		return; // not a big deal, the cache will be rebuilt
+
+	const uint32_t unicharSize = sizeof (UNICHAR);
+	const uint32_t infoSize = sizeof (fileInfo_t);
+
+	// count entries that can be saved
+	uint32_t numEntries = 0;
+	for (uint32_t i = 0; i < cacheTableSize; i++)
+	{
+		if (cacheTable[i].pathU != NULL && UNICHAR_STRLEN(cacheTable[i].pathU) <= UINT16_MAX)
+			numEntries++;
+	}
+
+	fwrite(CACHE_ID_STR, 1, sizeof (CACHE_ID_STR), f);
+	fwrite(&unicharSize, 4, 1, f);
+	fwrite(&infoSize, 4, 1, f);
+	fwrite(&numEntries, 4, 1, f);
+
+	for (uint32_t i = 0; i < cacheTableSize; i++)
+	{
+		const cacheEntry_t *e = &cacheTable[i];
+		if (e->pathU == NULL)
+			continue;
+
+		const size_t pathLen = UNICHAR_STRLEN(e->pathU);
+		if (pathLen > UINT16_MAX)
+			continue;
+
+		const uint16_t pathLen16 = (uint16_t)pathLen;
+		fwrite(&pathLen16, 2, 1, f);
+		fwrite(e->pathU, sizeof (UNICHAR), pathLen, f);
+		fwrite(&e->mtime, 8, 1, f);
+		fwrite(&e->filesize, 8, 1, f);
+		fwrite(&e->info, sizeof (fileInfo_t), 1, f);
+	}
+
+	fclose(f);
+	cacheDirty = false;
+}
+
+static void readFileInfo(const UNICHAR *pathU, bool sample, fileInfo_t *info)
+{
+	memset(info, 0, sizeof (fileInfo_t)); // also clears struct padding (the struct is saved as-is)
+	info->type = FILEINFO_NONE;
+
+	MEMFILE *f = mopen(pathU);
+	if (f == NULL)
+		return;
+
+	if (sample)
+		getSampleFileInfo(f, info);
+	else
+		getModuleFileInfo(f, info);
+
+	mclose(f);
+}
+
+static void freeScanNames(void)
+{
+	if (scanNamesU != NULL)
+	{
+		for (int32_t i = 0; i < numScanNames; i++)
+		{
+			if (scanNamesU[i] != NULL)
+				free(scanNamesU[i]);
+		}
+
+		free(scanNamesU);
+		scanNamesU = NULL;
+	}
+
+	if (scanDirU != NULL)
+	{
+		free(scanDirU);
+		scanDirU = NULL;
+	}
+
+	numScanNames = 0;
+}
+
+static int32_t SDLCALL scanThreadFunc(void *ptr)
+{
+	fileInfo_t info;
+	int64_t mtime, filesize;
+
+	if (!cacheLoaded) // the cache is loaded on first use
+	{
+		SDL_LockMutex(cacheMutex);
+		loadCache();
+		cacheLoaded = true;
+		SDL_UnlockMutex(cacheMutex);
+
+		cacheUpdated = true;
+	}
+
+	for (int32_t i = 0; i < numScanNames && !scanThreadQuit; i++)
+	{
+		UNICHAR *pathU = makeFullPath(scanDirU, scanNamesU[i]);
+		if (pathU == NULL)
+			break;
+
+		if (!getFileStats(pathU, &mtime, &filesize))
+		{
+			free(pathU);
+			continue;
+		}
+
+		// skip if the cached info is still valid
+		SDL_LockMutex(cacheMutex);
+		const cacheEntry_t *e = findEntry(pathU, hashPath(pathU));
+		const bool cached = (e != NULL && e->pathU != NULL && e->mtime == mtime && e->filesize == filesize);
+		SDL_UnlockMutex(cacheMutex);
+
+		if (cached)
+		{
+			free(pathU);
+			continue;
+		}
+
+		readFileInfo(pathU, scanSamples, &info);
+
+		SDL_LockMutex(cacheMutex);
+		if (insertEntry(pathU, mtime, filesize, &info))
+			cacheDirty = true;
+		SDL_UnlockMutex(cacheMutex);
+
+		cacheUpdated = true;
+	}
+
+	SDL_LockMutex(cacheMutex);
+	if (cacheDirty)
+		saveCache();
+	SDL_UnlockMutex(cacheMutex);
+
+	return true;
+
+	(void)ptr;
+}
+
+void diskOpCacheStopScan(void)
+{
+	if (scanThread != NULL)
+	{
+		scanThreadQuit = true;
+		SDL_WaitThread(scanThread, NULL);
+		scanThread = NULL;
+	}
+
+	freeScanNames();
+}
+
+void diskOpCacheScanDir(const UNICHAR *dirU, UNICHAR **namesU, int32_t numNames, bool samples)
+{
+	diskOpCacheStopScan();
+
+	scanDirU = UNICHAR_STRDUP(dirU);
+	scanNamesU = namesU;
+	numScanNames = numNames;
+	scanSamples = samples;
+
+	if (cacheMutex == NULL || scanDirU == NULL)
+	{
+		freeScanNames();
+		return;
+	}
+
+	scanThreadQuit = false;
+	scanThread = SDL_CreateThread(scanThreadFunc, NULL, NULL);
+	if (scanThread == NULL)
+		freeScanNames(); // not critical, we just don't get any file info
+}
+
+bool diskOpCacheGetInfo(const UNICHAR *dirU, const UNICHAR *nameU, fileInfo_t *info)
+{
+	if (cacheMutex == NULL || dirU == NULL || nameU == NULL)
+		return false;
+
+	UNICHAR *pathU = makeFullPath(dirU, nameU);
+	if (pathU == NULL)
+		return false;
+
+	SDL_LockMutex(cacheMutex);
+
+	const cacheEntry_t *e = findEntry(pathU, hashPath(pathU));
+	const bool found = (e != NULL && e->pathU != NULL);
+	if (found)
+		*info = e->info;
+
+	SDL_UnlockMutex(cacheMutex);
+
+	free(pathU);
+	return found;
+}
+
+bool diskOpCacheUpdated(void)
+{
+	if (!cacheUpdated)
+		return false;
+
+	cacheUpdated = false;
+	return true;
+}
+
+bool setupDiskOpCache(void)
+{
+	cacheMutex = SDL_CreateMutex();
+	return (cacheMutex != NULL);
+}
+
+void freeDiskOpCache(void)
+{
+	diskOpCacheStopScan();
+
+	if (cacheMutex != NULL)
+	{
+		if (cacheDirty)
+			saveCache();
+
+		SDL_DestroyMutex(cacheMutex);
+		cacheMutex = NULL;
+	}
+
+	freeTable();
+	cacheLoaded = false;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft2_unicode.h"
+
+enum
+{
+	FILEINFO_NONE = 0, // no info (not a supported module/sample)
+	FILEINFO_MODULE = 1,
+	FILEINFO_SAMPLE = 2
+};
+
+#define FILEINFO_NAME_LEN 32
+
+// header info shown in Disk Op., filled in by getModuleFileInfo()/getSampleFileInfo()
+typedef struct fileInfo_t
+{
+	uint8_t type, numChannels, bitDepth; // bitDepth is only used for samples
+	int32_t sampleRate, sampleLength; // samples
+	char formatName[4+1]; // "XM", "MOD", "WAV" etc.
+	char name[FILEINFO_NAME_LEN+1]; // module song name
+} fileInfo_t;
+
+bool setupDiskOpCache(void);
+void freeDiskOpCache(void); // stops the scan thread and saves the cache
+
+// starts reading file headers for entries in 'dirU' that aren't cached (or changed), 'namesU' is taken over
+void diskOpCacheScanDir(const UNICHAR *dirU, UNICHAR **namesU, int32_t numNames, bool samples);
+void diskOpCacheStopScan(void);
+
+bool diskOpCacheGetInfo(const UNICHAR *dirU, const UNICHAR *nameU, fileInfo_t *info); // no disk access
+bool diskOpCacheUpdated(void); // true once after the scan thread has added new info
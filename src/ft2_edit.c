@@ -86,7 +86,7 @@ void testNoteKeysRelease(SDL_Scancode scancode)
 
 static bool testEditKeys(SDL_Scancode scancode, SDL_Keycode keycode)
 {
-	int8_t i;
+	int32_t i;
 
 	if (cursor.object == CURSOR_NOTE)
 	{
@@ -328,7 +328,7 @@ static void evaluateTimeStamp(int16_t *songPos, int16_t *pattNum, int16_t *row,
 
 void recordNote(uint8_t noteNum, int8_t vol) // directly ported from the original FT2 code - what a mess, but it works...
 {
-	int8_t i;
+	int32_t i;
 	int16_t pattNum, songPos, row, tick;
 	int32_t time;
 	note_t *p;
@@ -354,8 +354,8 @@ void recordNote(uint8_t noteNum, int8_t vol) // directly ported from the origina
 	if (noteNum == NOTE_OFF)
 		vol = 0;
 
-	int8_t c = -1;
-	int8_t k = -1;
+	int32_t c = -1;
+	int32_t k = -1;
 
 	if (editmode || recmode)
 	{
@@ -366,7 +366,7 @@ void recordNote(uint8_t noteNum, int8_t vol) // directly ported from the origina
 			time = INT32_MAX;
 			for (i = 0; i < song.numChannels; i++)
 			{
-				if (editor.chnMode[i] && config.multiRecChn[i] && editor.keyOffTime[i] < time && editor.keyOnTab[i] == 0)
+				if (editor.chnMode[i] && multiRecChnEnabled(i) && editor.keyOffTime[i] < time && editor.keyOnTab[i] == 0)
 				{
 					c = i;
 					time = editor.keyOffTime[i];
@@ -380,7 +380,7 @@ void recordNote(uint8_t noteNum, int8_t vol) // directly ported from the origina
 
 		for (i = 0; i < song.numChannels; i++)
 		{
-			if (noteNum == editor.keyOnTab[i] && config.multiRecChn[i])
+			if (noteNum == editor.keyOnTab[i] && multiRecChnEnabled(i))
 				k = i;
 		}
 	}
@@ -396,7 +396,7 @@ void recordNote(uint8_t noteNum, int8_t vol) // directly ported from the origina
 			{
 				for (i = 0; i < song.numChannels; i++)
 				{
-					if (editor.keyOffTime[i] < time && editor.keyOnTab[i] == 0 && config.multiRecChn[i])
+					if (editor.keyOffTime[i] < time && editor.keyOnTab[i] == 0 && multiRecChnEnabled(i))
 					{
 						c = i;
 						time = editor.keyOffTime[i];
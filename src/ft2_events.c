@@ -121,6 +121,13 @@ void handleEvents(void)
 		diskOp_StartDirReadThread();
 	}
 
+	if (editor.diskOpReadUpdate) // the read thread has published more entries
+	{
+		editor.diskOpReadUpdate = false;
+		if (ui.diskOpShown)
+			diskOp_DrawDirectory();
+	}
+
 	if (editor.diskOpReadDone)
 	{
 		editor.diskOpReadDone = false;
@@ -129,6 +136,7 @@ void handleEvents(void)
 	}
 
 	handleLoadMusicEvents();
+	freeRetiredSmpData(false); // old sample data from sample editor operations (see replaceSample())
 
 	if (editor.samplingAudioFlag) handleSamplingUpdates();
 	if (ui.setMouseBusy) mouseAnimOn();
@@ -372,6 +380,13 @@ void handleWaitVblQuirk(SDL_Event *event)
 		else if (event->window.event == SDL_WINDOWEVENT_SHOWN)
 			video.windowHidden = false;
 
+		// the window's content may have been lost, upload and present the whole frame again
+		if (event->window.event == SDL_WINDOWEVENT_EXPOSED || event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+			event->window.event == SDL_WINDOWEVENT_RESTORED || event->window.event == SDL_WINDOWEVENT_SHOWN)
+		{
+			markScreenDirty();
+		}
+
 		// reset vblank end time if we minimize window
 		if (event->window.event == SDL_WINDOWEVENT_MINIMIZED || event->window.event == SDL_WINDOWEVENT_FOCUS_LOST)
 			hpc_ResetCounters(&video.vblankHpc);
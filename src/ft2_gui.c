@@ -291,6 +291,7 @@ uint16_t textWidth16(const char *textPtr)
 void textOutTiny(int32_t xPos, int32_t yPos, char *str, uint32_t color) // A..Z/a..z and 0..9
 {
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, (int32_t)strlen(str) * FONT3_CHAR_W, FONT3_CHAR_H);
 	while (*str != '\0')
 	{
 		char chr = *str++;
@@ -356,6 +357,7 @@ void charOut(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, char chr)
 	const uint32_t pixVal = video.palette[paletteIndex];
 	const uint8_t *srcPtr = &bmp.font1[chr * FONT1_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT1_CHAR_W, FONT1_CHAR_H);
 
 	for (uint32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
@@ -385,6 +387,7 @@ void charOutAlpha(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, char chr,
 	const uint32_t palNum = paletteIndex << 24;
 	const uint8_t *srcPtr = &bmp.font1[chr * FONT1_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT1_CHAR_W, FONT1_CHAR_H);
 
 	for (int32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
@@ -429,6 +432,7 @@ void charOutBg(uint16_t xPos, uint16_t yPos, uint8_t fgPalette, uint8_t bgPalett
 
 	const uint8_t *srcPtr = &bmp.font1[chr * FONT1_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT1_CHAR_W-1, FONT1_CHAR_H);
 
 	for (int32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
@@ -462,6 +466,7 @@ void charOutShadow(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, uint8_t s
 	const uint32_t pixVal2 = video.palette[shadowPaletteIndex];
 	const uint8_t *srcPtr = &bmp.font1[chr * FONT1_CHAR_W];
 	uint32_t *dstPtr1 = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT1_CHAR_W+1, FONT1_CHAR_H+1); // +1 for the shadow
 	uint32_t *dstPtr2 = dstPtr1 + (SCREEN_W+1);
 
 	for (int32_t y = 0; y < FONT1_CHAR_H; y++)
@@ -499,6 +504,7 @@ void charOutClipX(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, char chr,
 	int32_t width = FONT1_CHAR_W;
 	if (xPos+width > clipX)
 		width = FONT1_CHAR_W - ((xPos + width) - clipX);
+	markDirtyRect(xPos, yPos, width, FONT1_CHAR_H);
 
 	for (int32_t y = 0; y < FONT1_CHAR_H; y++)
 	{
@@ -523,6 +529,7 @@ void bigCharOut(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, char chr)
 
 	const uint8_t *srcPtr = &bmp.font2[chr * FONT2_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT2_CHAR_W, FONT2_CHAR_H);
 	const uint32_t pixVal = video.palette[paletteIndex];
 
 	for (int32_t y = 0; y < FONT2_CHAR_H; y++)
@@ -550,6 +557,7 @@ static void bigCharOutShadow(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex,
 	const uint32_t pixVal2 = video.palette[shadowPaletteIndex];
 	const uint8_t *srcPtr = &bmp.font2[chr * FONT2_CHAR_W];
 	uint32_t *dstPtr1 = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT2_CHAR_W+1, FONT2_CHAR_H+1); // +1 for the shadow
 	uint32_t *dstPtr2 = dstPtr1 + (SCREEN_W+1);
 
 	for (int32_t y = 0; y < FONT2_CHAR_H; y++)
@@ -710,6 +718,7 @@ void hexOut(uint16_t xPos, uint16_t yPos, uint8_t paletteIndex, uint32_t val, ui
 
 	const uint32_t pixVal = video.palette[paletteIndex];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, numDigits * FONT6_CHAR_W, FONT6_CHAR_H);
 
 	for (int32_t i = numDigits-1; i >= 0; i--)
 	{
@@ -739,6 +748,7 @@ void hexOutBg(uint16_t xPos, uint16_t yPos, uint8_t fgPalette, uint8_t bgPalette
 	const uint32_t fg = video.palette[fgPalette];
 	const uint32_t bg = video.palette[bgPalette];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, numDigits * FONT6_CHAR_W, FONT6_CHAR_H);
 
 	for (int32_t i = numDigits-1; i >= 0; i--)
 	{
@@ -774,6 +784,7 @@ void clearRect(uint16_t xPos, uint16_t yPos, uint16_t w, uint16_t h)
 	const uint32_t pitch = w * sizeof (int32_t);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++, dstPtr += SCREEN_W)
 		memset(dstPtr, 0, pitch);
 }
@@ -784,6 +795,7 @@ void fillRect(uint16_t xPos, uint16_t yPos, uint16_t w, uint16_t h, uint8_t pale
 
 	const uint32_t pixVal = video.palette[paletteIndex];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 
 	for (int32_t y = 0; y < h; y++)
 	{
@@ -799,6 +811,7 @@ void blit32(uint16_t xPos, uint16_t yPos, const uint32_t *srcPtr, uint16_t w, ui
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + w) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -823,6 +836,7 @@ void blit32Alpha(uint16_t xPos, uint16_t yPos, const uint32_t *srcPtr, uint16_t
 	}
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -858,6 +872,7 @@ void blit(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t w, uint1
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + w) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -880,6 +895,7 @@ void blitClipX(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t w,
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + clipX) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, clipX, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < clipX; x++)
@@ -899,6 +915,7 @@ void blitFast(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t w, u
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + w) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -917,6 +934,7 @@ void blitFastClipX(uint16_t xPos, uint16_t yPos, const uint8_t *srcPtr, uint16_t
 	assert(srcPtr != NULL && xPos < SCREEN_W && yPos < SCREEN_H && (xPos + clipX) <= SCREEN_W && (yPos + h) <= SCREEN_H);
 
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, clipX, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < clipX; x++)
@@ -936,6 +954,7 @@ void hLine(uint16_t x, uint16_t y, uint16_t w, uint8_t paletteIndex)
 	const uint32_t pixVal = video.palette[paletteIndex];
 
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, w, 1);
 	for (int32_t i = 0; i < w; i++)
 		dstPtr[i] = pixVal;
 }
@@ -947,6 +966,7 @@ void vLine(uint16_t x, uint16_t y, uint16_t h, uint8_t paletteIndex)
 	const uint32_t pixVal = video.palette[paletteIndex];
 
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, 1, h);
 	for (int32_t i = 0; i < h; i++)
 	{
 		*dstPtr = pixVal;
@@ -980,6 +1000,7 @@ void line(int16_t x1, int16_t x2, int16_t y1, int16_t y2, uint8_t paletteIndex)
 	uint32_t pixVal = video.palette[paletteIndex];
 	const int32_t pitch  = sy * SCREEN_W;
 	uint32_t *dst32  = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(MIN(x1, x2), MIN(y1, y2), (ax >> 1) + 1, (ay >> 1) + 1);
 
 	// draw line
 	if (ax > ay)
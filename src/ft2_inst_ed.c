@@ -1567,6 +1567,7 @@ static void pinoaNumberOut(uint16_t xPos, uint16_t yPos, uint8_t fgPalette, uint
 	const uint32_t fg = video.palette[fgPalette];
 	const uint32_t bg = video.palette[bgPalette];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, 5, 7);
 	const uint8_t *srcPtr = &bmp.font8[val * 5];
 
 	for (int32_t y = 0; y < 7; y++)
@@ -1764,6 +1765,7 @@ static void envelopeLine(int32_t envNum, int16_t x1, int16_t y1, int16_t x2, int
 	const int32_t pitch = sy * SCREEN_W;
 
 	uint32_t *dst32 = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(MIN(x1, x2), MIN(y1, y2), (ax >> 1) + 1, (ay >> 1) + 1);
 
 	// draw line
 	if (ax > ay)
@@ -1828,6 +1830,7 @@ static void envelopePixel(int32_t envNum, int16_t x, int16_t y, uint8_t pal)
 {
 	y += (envNum == 0) ? 189 : 276;
 	video.frameBuffer[(y * SCREEN_W) + x] = video.palette[pal];
+	markDirtyRect(x, y, 1, 1);
 }
 
 static void envelopeDot(int32_t envNum, int16_t x, int16_t y)
@@ -1836,6 +1839,7 @@ static void envelopeDot(int32_t envNum, int16_t x, int16_t y)
 
 	const uint32_t pixVal = video.palette[PAL_BLCKTXT];
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, 3, 3);
 
 	for (y = 0; y < 3; y++)
 	{
@@ -1855,6 +1859,7 @@ static void envelopeVertLine(int32_t envNum, int16_t x, int16_t y, uint8_t pal)
 	const uint32_t pixVal2 = video.palette[PAL_BLCKTXT];
 
 	uint32_t *dstPtr = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(x, y, 1, 65);
 	for (y = 0; y < 33; y++)
 	{
 		if (*dstPtr != pixVal2)
@@ -2037,6 +2042,7 @@ static void drawPanEnvCoords(int16_t tick, int16_t val)
 		hLine(326, 289, 3, PAL_BCKGRND);
 		video.frameBuffer[(288 * SCREEN_W) + 325] = video.palette[PAL_BCKGRND];
 		video.frameBuffer[(288 * SCREEN_W) + 329] = video.palette[PAL_BCKGRND];
+		markDirtyRect(325, 288, 5, 1);
 
 		hLine(326, 288, 3, PAL_FORGRND);
 	}
@@ -25,6 +25,7 @@
 #include "ft2_trim.h"
 #include "ft2_sample_ed_features.h"
 #include "ft2_structs.h"
+#include "scopes/ft2_scopes.h"
 
 keyb_t keyb; // globalized
 
@@ -1003,7 +1004,12 @@ static bool checkModifiedKeys(SDL_Keycode keycode)
 
 		case SDLK_p:
 		{
-			if (keyb.leftCtrlPressed)
+			if (keyb.leftShiftPressed && keyb.leftCtrlPressed)
+			{
+				toggleVoiceProfiler();
+				return true;
+			}
+			else if (keyb.leftCtrlPressed)
 			{
 				if (!ui.patternEditorShown)
 				{
@@ -10,8 +10,12 @@
 #define WIN32_MEAN_AND_LEAN
 #include <windows.h>
 #include <SDL2/SDL_syswm.h>
+#include <process.h> // _spawnv()
 #else
-#include <unistd.h> // chdir()
+#include <unistd.h> // chdir(), fork()
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #endif
 #include "ft2_header.h"
 #include "ft2_gui.h"
@@ -34,6 +38,9 @@
 #include "ft2_bmp.h"
 #include "ft2_structs.h"
 #include "ft2_hpc.h"
+#include "ft2_wav_renderer.h"
+#include "ft2_smp_kernels.h"
+#include "mixer/ft2_mix.h"
 
 #ifdef HAS_MIDI
 static SDL_Thread *initMidiThread;
@@ -41,6 +48,9 @@ static SDL_Thread *initMidiThread;
 
 static void initializeVars(void);
 static void cleanUpAndExit(void); // never call this inside the main loop
+static int32_t renderModuleFromArgs(int argc, char *argv[]); // no window or audio device
+static int32_t renderDirFromArgs(int argc, char *argv[]);
+
 #ifdef __APPLE__
 static void osxSetDirToProgramDirFromArgs(char **argv);
 #endif
@@ -65,6 +75,13 @@ int main(int argc, char *argv[])
 #pragma message("At least version 2.0.7 is recommended.")
 #endif
 
+	// command-line song-to-WAV rendering (doesn't create a window or open an audio device)
+	if (argc >= 2 && !strcmp(argv[1], "--render"))
+		return renderModuleFromArgs(argc, argv);
+
+	if (argc >= 2 && !strcmp(argv[1], "--render-dir"))
+		return renderDirFromArgs(argc, argv);
+
 	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
 	SDL_EnableScreenSaver(); // allow screensaver to activate
 
@@ -267,6 +284,10 @@ static void initializeVars(void)
 {
 	cpu.hasSSE = SDL_HasSSE();
 	cpu.hasSSE2 = SDL_HasSSE2();
+	cpu.hasAVX2 = SDL_HasAVX2(); // also checks for OS support
+	cpu.hasFMA = cpuHasFMA();
+	selectMixFuncs();
+	selectSmpKernels();
 
 	// clear common structs
 	memset(&video, 0, sizeof (video));
@@ -337,11 +358,13 @@ static void cleanUpAndExit(void) // never call this inside the main loop!
 #endif
 
 	closeAudio();
+	freeRetiredSmpData(true);
 	closeReplayer();
 	closeVideo();
 	freeSprites();
 	freeDiskOp();
 	clearCopyBuffer();
+	freeSmpPeaks();
 	freeAudioDeviceSelectorBuffers();
 #ifdef HAS_MIDI
 	freeMidiInputDeviceList();
@@ -390,6 +413,471 @@ static void cleanUpAndExit(void) // never call this inside the main loop!
 	SDL_Quit();
 }
 
+// command-line rendering (no window or audio device)
+
+typedef struct renderArgs_t
+{
+	uint32_t freq;
+	uint8_t bitDepth;
+	int32_t interpolation, amp, numJobs;
+} renderArgs_t;
+
+static void printRenderUsage(void)
+{
+	fprintf(stderr, "Usage: ft2-clone --render <module> <output.wav> [options]\n" \
+	                "       ft2-clone --render-dir <input dir> <output dir> [options] [--jobs <n>]\n" \
+	                "       (\"<input dir>/song.xm\" is rendered to \"<output dir>/song.xm.wav\")\n\n" \
+	                "Options:\n" \
+	                "  --rate <hz>       output rate, %d..%d (default: 48000)\n" \
+	                "  --bits <16|32>    16-bit integer or 32-bit float output (default: 16)\n" \
+	                "  --interp <type>   none, linear, cubic, sinc8 or sinc16 (default: sinc8)\n" \
+	                "  --amp <1..32>     amplification (default: from default config)\n" \
+	                "  --jobs <n>        modules to render in parallel (default: number of CPU cores)\n",
+	                MIN_WAV_RENDER_FREQ, MAX_WAV_RENDER_FREQ);
+}
+
+static bool parseRenderArgs(int argc, char *argv[], renderArgs_t *r)
+{
+	r->freq = 48000;
+	r->bitDepth = 16;
+	r->interpolation = -1;
+	r->amp = -1;
+	r->numJobs = SDL_GetCPUCount();
+
+	if (argc < 4)
+	{
+		printRenderUsage();
+		return false;
+	}
+
+	for (int32_t i = 4; i < argc; i += 2)
+	{
+		if (i+1 >= argc)
+		{
+			printRenderUsage();
+			return false;
+		}
+
+		const char *opt = argv[i];
+		const char *val = argv[i+1];
+
+		if (!strcmp(opt, "--rate"))
+		{
+			r->freq = (uint32_t)atoi(val);
+			if (r->freq < MIN_WAV_RENDER_FREQ || r->freq > MAX_WAV_RENDER_FREQ)
+			{
+				fprintf(stderr, "Error: The output rate must be %d..%d!\n", MIN_WAV_RENDER_FREQ, MAX_WAV_RENDER_FREQ);
+				return false;
+			}
+		}
+		else if (!strcmp(opt, "--bits"))
+		{
+			r->bitDepth = (uint8_t)atoi(val);
+			if (r->bitDepth != 16 && r->bitDepth != 32)
+			{
+				fprintf(stderr, "Error: The bit depth must be 16 or 32!\n");
+				return false;
+			}
+		}
+		else if (!strcmp(opt, "--interp"))
+		{
+			     if (!strcmp(val, "none")) r->interpolation = INTERPOLATION_DISABLED;
+			else if (!strcmp(val, "linear")) r->interpolation = INTERPOLATION_LINEAR;
+			else if (!strcmp(val, "cubic")) r->interpolation = INTERPOLATION_CUBIC;
+			else if (!strcmp(val, "sinc8")) r->interpolation = INTERPOLATION_SINC8;
+			else if (!strcmp(val, "sinc16")) r->interpolation = INTERPOLATION_SINC16;
+			else
+			{
+				fprintf(stderr, "Error: Unknown interpolation type \"%s\"!\n", val);
+				return false;
+			}
+		}
+		else if (!strcmp(opt, "--amp"))
+		{
+			r->amp = atoi(val);
+			if (r->amp < 1 || r->amp > 32)
+			{
+				fprintf(stderr, "Error: The amplification must be 1..32!\n");
+				return false;
+			}
+		}
+		else if (!strcmp(opt, "--jobs"))
+		{
+			r->numJobs = atoi(val);
+			if (r->numJobs < 1)
+			{
+				fprintf(stderr, "Error: The number of jobs must be at least 1!\n");
+				return false;
+			}
+		}
+		else
+		{
+			printRenderUsage();
+			return false;
+		}
+	}
+
+	if (r->numJobs < 1)
+		r->numJobs = 1;
+
+	return true;
+}
+
+static bool setupHeadlessRenderer(renderArgs_t *r)
+{
+	initializeVars();
+	hpc_Init();
+
+	if (!calcCubicSplineTable() || !calcWindowedSincTables())
+	{
+		fprintf(stderr, "Error: Not enough memory!\n");
+		return false;
+	}
+
+	setDefaultConfigNoGUI();
+	if (r->interpolation != -1)
+		config.interpolation = (uint8_t)r->interpolation;
+
+	if (r->amp != -1)
+		config.boostLevel = (int16_t)r->amp;
+
+	if (!setupAudioNoDevice(r->freq) || !setupReplayer())
+	{
+		fprintf(stderr, "Error: Not enough memory!\n");
+		closeReplayer();
+		return false;
+	}
+
+	audioSetInterpolationType(config.interpolation);
+	audioSetVolRamp((config.specialFlags & NO_VOLRAMP_FLAG) ? false : true);
+
+	return true;
+}
+
+static void closeHeadlessRenderer(void)
+{
+	closeAudio();
+	closeReplayer();
+
+	if (editor.tmpFilenameU != NULL)
+	{
+		free(editor.tmpFilenameU);
+		editor.tmpFilenameU = NULL;
+	}
+}
+
+static bool renderModuleFile(const char *inFilename, const char *outFilename, renderArgs_t *r)
+{
+	const uint64_t startTime64 = SDL_GetPerformanceCounter();
+
+	const uint32_t filenameLen = (const uint32_t)strlen(inFilename);
+	UNICHAR *filenameU = (UNICHAR *)malloc((filenameLen + 1) * sizeof (UNICHAR));
+	if (filenameU == NULL)
+	{
+		fprintf(stderr, "Error: Not enough memory!\n");
+		return false;
+	}
+
+	filenameU[0] = 0;
+#ifdef _WIN32
+	MultiByteToWideChar(CP_UTF8, 0, inFilename, -1, filenameU, filenameLen+1);
+#else
+	strcpy(filenameU, inFilename);
+#endif
+
+	bool result = loadMusicHeadless(filenameU);
+	free(filenameU);
+
+	if (!result)
+	{
+		fprintf(stderr, "Error: Couldn't load \"%s\"!\n", inFilename);
+		return false;
+	}
+
+	if (!renderWavNoGUI(outFilename, r->freq, r->bitDepth))
+		return false;
+
+	const double dTimeMs = (SDL_GetPerformanceCounter() - startTime64) * hpcFreq.dFreqMulMs;
+	printf("Rendered \"%s\" to \"%s\" in %.1fms\n", inFilename, outFilename, dTimeMs);
+
+	return true;
+}
+
+static int32_t renderModuleFromArgs(int argc, char *argv[])
+{
+	renderArgs_t r;
+
+	if (!parseRenderArgs(argc, argv, &r) || !setupHeadlessRenderer(&r))
+		return 1;
+
+	const bool result = renderModuleFile(argv[2], argv[3], &r);
+
+	closeHeadlessRenderer();
+	return result ? 0 : 1;
+}
+
+static bool hasModuleExtension(const char *filename)
+{
+	const char *ext = strrchr(filename, '.');
+	if (ext == NULL || ext == filename)
+		return false;
+
+	ext++;
+	for (int32_t i = 0; strcmp(supportedModExtensions[i], "END_OF_LIST") != 0; i++)
+	{
+		if (!_stricmp(supportedModExtensions[i], ext))
+			return true;
+	}
+
+	return false;
+}
+
+// "dir/song.xm" -> "outDir/song.xm.wav" (the extension is kept, or "song.xm" and "song.mod" would both be "song.wav")
+static char *getOutputWavFilename(const char *outDir, const char *filename)
+{
+	const size_t outDirLen = strlen(outDir);
+
+	char *outFilename = (char *)malloc(outDirLen + 1 + strlen(filename) + 4 + 1);
+	if (outFilename == NULL)
+		return NULL;
+
+	strcpy(outFilename, outDir);
+	if (outDirLen > 0 && outFilename[outDirLen-1] != DIR_DELIMITER && outFilename[outDirLen-1] != '/')
+		strcat(outFilename, (const char[]) { DIR_DELIMITER, '\0' });
+
+	strcat(outFilename, filename);
+	strcat(outFilename, ".wav");
+	return outFilename;
+}
+
+/* Each module is rendered in its own process, so that the jobs don't share any
+** replayer/mixer state (the replayer is a direct port of FT2 and works on globals).
+** On POSIX systems the worker processes are forked after the interpolation tables
+** have been calculated, so they start rendering right away.
+*/
+#ifdef _WIN32
+static int32_t renderDirFromArgs(int argc, char *argv[])
+{
+	renderArgs_t r;
+	WIN32_FIND_DATAA fd;
+	HANDLE jobs[MAXIMUM_WAIT_OBJECTS];
+	char searchPath[MAX_PATH];
+	const char *spawnArgs[32];
+
+	if (!parseRenderArgs(argc, argv, &r))
+		return 1;
+
+	if (r.numJobs > MAXIMUM_WAIT_OBJECTS)
+		r.numJobs = MAXIMUM_WAIT_OBJECTS;
+
+	if (argc > 32-3)
+	{
+		printRenderUsage();
+		return 1;
+	}
+
+	snprintf(searchPath, sizeof (searchPath), "%s\\*", argv[2]);
+	HANDLE hFind = FindFirstFileA(searchPath, &fd);
+	if (hFind == INVALID_HANDLE_VALUE)
+	{
+		fprintf(stderr, "Error: Couldn't open directory \"%s\"!\n", argv[2]);
+		return 1;
+	}
+
+	const uint64_t startTime64 = SDL_GetPerformanceCounter();
+	hpc_Init();
+
+	int32_t numRunning = 0, numFiles = 0, numFailed = 0;
+	do
+	{
+		if ((fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) || !hasModuleExtension(fd.cFileName))
+			continue;
+
+		numFiles++;
+
+		char inFilename[MAX_PATH * 2];
+		snprintf(inFilename, sizeof (inFilename), "\"%s\\%s\"", argv[2], fd.cFileName);
+
+		char *outFilename = getOutputWavFilename(argv[3], fd.cFileName);
+		if (outFilename == NULL)
+		{
+			numFailed++;
+			continue;
+		}
+
+		char outFilenameQuoted[MAX_PATH * 2];
+		snprintf(outFilenameQuoted, sizeof (outFilenameQuoted), "\"%s\"", outFilename);
+		free(outFilename);
+
+		// wait for a free job slot
+		if (numRunning >= r.numJobs)
+		{
+			DWORD exitCode;
+			const DWORD i = WaitForMultipleObjects(numRunning, jobs, FALSE, INFINITE) - WAIT_OBJECT_0;
+			if (!GetExitCodeProcess(jobs[i], &exitCode) || exitCode != 0)
+				numFailed++;
+
+			CloseHandle(jobs[i]);
+			jobs[i] = jobs[--numRunning];
+		}
+
+		// worker: "ft2-clone --render <in> <out> [options]" (all options except --jobs are passed on)
+		int32_t n = 0;
+		spawnArgs[n++] = argv[0];
+		spawnArgs[n++] = "--render";
+		spawnArgs[n++] = inFilename;
+		spawnArgs[n++] = outFilenameQuoted;
+		for (int32_t i = 4; i+1 < argc; i += 2)
+		{
+			if (strcmp(argv[i], "--jobs") != 0)
+			{
+				spawnArgs[n++] = argv[i];
+				spawnArgs[n++] = argv[i+1];
+			}
+		}
+		spawnArgs[n] = NULL;
+
+		const intptr_t job = _spawnv(_P_NOWAIT, argv[0], spawnArgs);
+		if (job == -1)
+		{
+			fprintf(stderr, "Error: Couldn't start rendering process!\n");
+			numFailed++;
+			continue;
+		}
+
+		jobs[numRunning++] = (HANDLE)job;
+	}
+	while (FindNextFileA(hFind, &fd));
+	FindClose(hFind);
+
+	while (numRunning > 0)
+	{
+		DWORD exitCode;
+		const DWORD i = WaitForMultipleObjects(numRunning, jobs, FALSE, INFINITE) - WAIT_OBJECT_0;
+		if (!GetExitCodeProcess(jobs[i], &exitCode) || exitCode != 0)
+			numFailed++;
+
+		CloseHandle(jobs[i]);
+		jobs[i] = jobs[--numRunning];
+	}
+
+	const double dTimeMs = (SDL_GetPerformanceCounter() - startTime64) * hpcFreq.dFreqMulMs;
+	printf("Rendered %d of %d module(s) in %.1fms (%d jobs)\n", numFiles-numFailed, numFiles, dTimeMs, r.numJobs);
+
+	return (numFailed == 0) ? 0 : 1;
+}
+#else
+static int32_t renderDirFromArgs(int argc, char *argv[])
+{
+	renderArgs_t r;
+
+	if (!parseRenderArgs(argc, argv, &r))
+		return 1;
+
+	DIR *dir = opendir(argv[2]);
+	if (dir == NULL)
+	{
+		fprintf(stderr, "Error: Couldn't open directory \"%s\"!\n", argv[2]);
+		return 1;
+	}
+
+	const uint64_t startTime64 = SDL_GetPerformanceCounter();
+
+	if (!setupHeadlessRenderer(&r))
+	{
+		closedir(dir);
+		return 1;
+	}
+
+	fflush(stdout); // don't let the worker processes inherit buffered output
+
+	int32_t numRunning = 0, numFiles = 0, numFailed = 0, status;
+	struct dirent *ent;
+
+	while ((ent = readdir(dir)) != NULL)
+	{
+		if (!hasModuleExtension(ent->d_name))
+			continue;
+
+		const size_t inFilenameLen = strlen(argv[2]) + 1 + strlen(ent->d_name);
+		char *inFilename = (char *)malloc(inFilenameLen + 1);
+		char *outFilename = getOutputWavFilename(argv[3], ent->d_name);
+
+		if (inFilename == NULL || outFilename == NULL)
+		{
+			if (inFilename != NULL) free(inFilename);
+			if (outFilename != NULL) free(outFilename);
+
+			fprintf(stderr, "Error: Not enough memory!\n");
+			numFiles++;
+			numFailed++;
+			break;
+		}
+
+		sprintf(inFilename, "%s/%s", argv[2], ent->d_name);
+
+		struct stat st;
+		if (stat(inFilename, &st) != 0 || !S_ISREG(st.st_mode))
+		{
+			free(inFilename);
+			free(outFilename);
+			continue;
+		}
+
+		numFiles++;
+
+		// wait for a free job slot
+		if (numRunning >= r.numJobs)
+		{
+			if (wait(&status) > 0)
+			{
+				if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+					numFailed++;
+
+				numRunning--;
+			}
+		}
+
+		const pid_t pid = fork();
+		if (pid == 0)
+		{
+			// worker process
+			const bool result = renderModuleFile(inFilename, outFilename, &r);
+			fflush(stdout);
+			_exit(result ? 0 : 1);
+		}
+
+		free(inFilename);
+		free(outFilename);
+
+		if (pid < 0)
+		{
+			fprintf(stderr, "Error: Couldn't start rendering process!\n");
+			numFailed++;
+			continue;
+		}
+
+		numRunning++;
+	}
+	closedir(dir);
+
+	while (numRunning > 0 && wait(&status) > 0)
+	{
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			numFailed++;
+
+		numRunning--;
+	}
+
+	closeHeadlessRenderer();
+
+	const double dTimeMs = (SDL_GetPerformanceCounter() - startTime64) * hpcFreq.dFreqMulMs;
+	printf("Rendered %d of %d module(s) in %.1fms (%d jobs)\n", numFiles-numFailed, numFiles, dTimeMs, r.numJobs);
+
+	return (numFailed == 0) ? 0 : 1;
+}
+#endif
+
 #ifdef __APPLE__
 static void osxSetDirToProgramDirFromArgs(char **argv)
 {
@@ -0,0 +1,236 @@
+// for finding memory leaks in debug mode with Visual Studio
+#if defined _DEBUG && defined _MSC_VER
+#include <crtdbg.h>
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "ft2_unicode.h"
+#include "ft2_memfile.h"
+
+#define MEMFILE_MAX_SIZE INT32_MAX // loaders use 32-bit file sizes/offsets
+
+static bool mapFile(MEMFILE *m, const UNICHAR *pathU)
+{
+#ifdef _WIN32
+	HANDLE hFile = CreateFileW(pathU, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart > MEMFILE_MAX_SIZE)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	HANDLE hMap = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMap == NULL)
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+
+	const void *data = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+	if (data == NULL)
+	{
+		CloseHandle(hMap);
+		CloseHandle(hFile);
+		return false;
+	}
+
+	m->hFile = hFile;
+	m->hMap = hMap;
+	m->data = (const uint8_t *)data;
+	m->size = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(pathU, O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 || st.st_size > MEMFILE_MAX_SIZE)
+	{
+		close(fd);
+		return false;
+	}
+
+	void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping stays valid
+
+	if (data == MAP_FAILED)
+		return false;
+
+#ifdef MADV_SEQUENTIAL
+	madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+
+	m->data = (const uint8_t *)data;
+	m->size = (size_t)st.st_size;
+#endif
+
+	m->mapped = true;
+	return true;
+}
+
+static bool readWholeFile(MEMFILE *m, const UNICHAR *pathU)
+{
+	FILE *f = UNICHAR_FOPEN(pathU, "rb");
+	if (f == NULL)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	const long fileSize = ftell(f);
+	rewind(f);
+
+	if (fileSize < 0 || fileSize > MEMFILE_MAX_SIZE)
+	{
+		fclose(f);
+		return false;
+	}
+
+	uint8_t *data = (uint8_t *)malloc((fileSize > 0) ? fileSize : 1);
+	if (data == NULL)
+	{
+		fclose(f);
+		return false;
+	}
+
+	const size_t bytesRead = fread(data, 1, fileSize, f);
+	fclose(f);
+
+	m->data = data;
+	m->size = bytesRead;
+	m->mapped = false;
+
+	return true;
+}
+
+MEMFILE *mopen(const UNICHAR *pathU)
+{
+	MEMFILE *m = (MEMFILE *)calloc(1, sizeof (MEMFILE));
+	if (m == NULL)
+		return NULL;
+
+	if (!mapFile(m, pathU) && !readWholeFile(m, pathU)) // empty files can't be mapped
+	{
+		free(m);
+		return NULL;
+	}
+
+	return m;
+}
+
+void mclose(MEMFILE *m)
+{
+	if (m == NULL)
+		return;
+
+	if (m->mapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m->data);
+		CloseHandle((HANDLE)m->hMap);
+		CloseHandle((HANDLE)m->hFile);
+#else
+		munmap((void *)m->data, m->size);
+#endif
+	}
+	else if (m->data != NULL)
+	{
+		free((void *)m->data);
+	}
+
+	free(m);
+}
+
+size_t mread(void *buffer, size_t size, size_t count, MEMFILE *m)
+{
+	if (size == 0 || count == 0)
+		return 0;
+
+	const size_t bytesLeft = (m->pos < m->size) ? (m->size - m->pos) : 0;
+
+	size_t bytesToRead = size * count;
+	if (bytesToRead > bytesLeft)
+	{
+		bytesToRead = bytesLeft;
+		m->eof = true;
+	}
+
+	memcpy(buffer, &m->data[m->pos], bytesToRead);
+	m->pos += bytesToRead;
+
+	return bytesToRead / size;
+}
+
+int32_t mgetc(MEMFILE *m)
+{
+	if (m->pos >= m->size)
+	{
+		m->eof = true;
+		return -1;
+	}
+
+	return m->data[m->pos++];
+}
+
+int32_t mseek(MEMFILE *m, int32_t offset, int32_t whence)
+{
+	int64_t newPos;
+	switch (whence)
+	{
+		case SEEK_SET: newPos = offset; break;
+		case SEEK_CUR: newPos = (int64_t)m->pos + offset; break;
+		case SEEK_END: newPos = (int64_t)m->size + offset; break;
+		default: return -1;
+	}
+
+	if (newPos < 0 || newPos > MEMFILE_MAX_SIZE)
+		return -1;
+
+	m->pos = (size_t)newPos; // seeking past the end is allowed (like fseek())
+	m->eof = false;
+
+	return 0;
+}
+
+int32_t mtell(MEMFILE *m)
+{
+	return (int32_t)m->pos;
+}
+
+void mrewind(MEMFILE *m)
+{
+	m->pos = 0;
+	m->eof = false;
+}
+
+bool meof(MEMFILE *m)
+{
+	return m->eof;
+}
+
+const uint8_t *mreadptr(MEMFILE *m, size_t length)
+{
+	if (m->pos > m->size || length > m->size-m->pos)
+		return NULL;
+
+	const uint8_t *ptr = &m->data[m->pos];
+	m->pos += length;
+
+	return ptr;
+}
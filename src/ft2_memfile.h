@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ft2_unicode.h"
+
+/* Read-only in-memory file for the module/sample loaders.
+**
+** The whole file is memory-mapped (or read in one go if mapping fails), so the many small
+** header reads the loaders do are just memcpy()s. The functions work like their stdio
+** counterparts, so the loaders read the same way as before.
+*/
+
+typedef struct MEMFILE
+{
+	const uint8_t *data;
+	size_t size, pos;
+	bool eof, mapped;
+#ifdef _WIN32
+	void *hFile, *hMap;
+#endif
+} MEMFILE;
+
+MEMFILE *mopen(const UNICHAR *pathU); // returns NULL on error (or if the file is 2GB or bigger)
+void mclose(MEMFILE *m);
+
+size_t mread(void *buffer, size_t size, size_t count, MEMFILE *m);
+int32_t mgetc(MEMFILE *m); // returns -1 on EOF
+int32_t mseek(MEMFILE *m, int32_t offset, int32_t whence); // SEEK_SET/SEEK_CUR/SEEK_END
+int32_t mtell(MEMFILE *m);
+void mrewind(MEMFILE *m);
+bool meof(MEMFILE *m);
+
+// returns a pointer to the next 'length' bytes and skips them (NULL and no skip if there's not enough data)
+const uint8_t *mreadptr(MEMFILE *m, size_t length);
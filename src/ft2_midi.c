@@ -68,7 +68,7 @@ static inline void midiInControlChange(uint8_t data1, uint8_t data2)
 
 	if (recMIDIValidChn) // real FT2 forgot to check this here..
 	{
-		for (uint8_t i = 0; i < song.numChannels; i++)
+		for (int32_t i = 0; i < song.numChannels; i++)
 		{
 			if (channel[i].midiVibDepth != 0 || editor.keyOnTab[i] != 0)
 				channel[i].midiVibDepth = midi.currMIDIVibDepth;
@@ -89,7 +89,7 @@ static inline void midiInPitchBendChange(uint8_t data1, uint8_t data2)
 	if (recMIDIValidChn)
 	{
 		channel_t *ch = channel;
-		for (uint8_t i = 0; i < song.numChannels; i++, ch++)
+		for (int32_t i = 0; i < song.numChannels; i++, ch++)
 		{
 			if (ch->midiPitch != 0 || editor.keyOnTab[i] != 0)
 				ch->midiPitch = midi.currMIDIPitch;
@@ -225,7 +225,7 @@ void recordMIDIEffect(uint8_t efx, uint8_t efxData)
 		note_t *p = &pattern[editor.editPattern][editor.row * MAX_CHANNELS];
 		for (int32_t i = 0; i < song.numChannels; i++, p++)
 		{
-			if (config.multiRecChn[i] && editor.chnMode[i])
+			if (multiRecChnEnabled(i) && editor.chnMode[i])
 			{
 				if (!allocatePattern(editor.editPattern))
 					return;
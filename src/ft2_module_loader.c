@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdarg.h>
 #ifndef _WIN32
 #include <unistd.h>
 #endif
@@ -26,12 +27,12 @@
 #include "ft2_structs.h"
 #include "ft2_sysreqs.h"
 
-bool loadDIGI(FILE *f, uint32_t filesize);
-bool loadMOD(FILE *f, uint32_t filesize);
-bool loadS3M(FILE *f, uint32_t filesize);
-bool loadSTK(FILE *f, uint32_t filesize);
-bool loadSTM(FILE *f, uint32_t filesize);
-bool loadXM(FILE *f, uint32_t filesize);
+bool loadDIGI(MEMFILE *f, uint32_t filesize);
+bool loadMOD(MEMFILE *f, uint32_t filesize);
+bool loadS3M(MEMFILE *f, uint32_t filesize);
+bool loadSTK(MEMFILE *f, uint32_t filesize);
+bool loadSTM(MEMFILE *f, uint32_t filesize);
+bool loadXM(MEMFILE *f, uint32_t filesize);
 
 enum
 {
@@ -65,24 +66,25 @@ song_t songTmp;
 static volatile bool musicIsLoading, moduleLoaded, moduleFailedToLoad;
 static SDL_Thread *thread;
 static uint8_t oldPlayMode;
+static void setupLoadedModuleData(void);
 static void setupLoadedModule(void);
 static void freeTmpModule(void);
 
 // Crude module detection routine. These aren't always accurate detections!
-static int8_t detectModule(FILE *f)
+static int8_t detectModule(MEMFILE *f)
 {
 	uint8_t D[256], I[4];
 
-	fseek(f, 0, SEEK_END);
-	uint32_t fileLength = (uint32_t)ftell(f);
-	rewind(f);
+	mseek(f, 0, SEEK_END);
+	uint32_t fileLength = (uint32_t)mtell(f);
+	mrewind(f);
 
 	memset(D, 0, sizeof (D));
-	fread(D, 1, sizeof (D), f);
-	fseek(f, 1080, SEEK_SET); // MOD ID
+	mread(D, 1, sizeof (D), f);
+	mseek(f, 1080, SEEK_SET); // MOD ID
 	I[0] = I[1] = I[2] = I[3] = 0;
-	fread(I, 1, 4, f);
-	rewind(f);
+	mread(I, 1, 4, f);
+	mrewind(f);
 
 	// DIGI Booster (non-Pro)
 	if (!memcmp("DIGI Booster module", &D[0x00], 19+1) && D[0x19] >= 1 && D[0x19] <= 8)
@@ -150,10 +152,10 @@ static int8_t detectModule(FILE *f)
 		return FORMAT_UNKNOWN;
 
 	// test STK numOrders+BPM for illegal values
-	fseek(f, 470, SEEK_SET);
+	mseek(f, 470, SEEK_SET);
 	D[0] = D[1] = 0;
-	fread(D, 1, 2, f);
-	rewind(f);
+	mread(D, 1, 2, f);
+	mrewind(f);
 
 	if (D[0] <= 128 && D[1] <= 220)
 		return FORMAT_POSSIBLY_STK;
@@ -161,19 +163,15 @@ static int8_t detectModule(FILE *f)
 	return FORMAT_UNKNOWN;
 }
 
-static bool doLoadMusic(bool externalThreadFlag)
+static bool doLoadMusic(void) // loaderMsgBox()/loaderSysReq() must be set up by the caller
 {
-	// setup message box functions
-	loaderMsgBox = externalThreadFlag ? myLoaderMsgBoxThreadSafe : myLoaderMsgBox;
-	loaderSysReq = externalThreadFlag ? okBoxThreadSafe : okBox;
-
 	if (editor.tmpFilenameU == NULL)
 	{
 		loaderMsgBox("Generic memory fault during loading!");
 		goto loadError;
 	}
 
-	FILE *f = UNICHAR_FOPEN(editor.tmpFilenameU, "rb");
+	MEMFILE *f = mopen(editor.tmpFilenameU);
 	if (f == NULL)
 	{
 		loaderMsgBox("General I/O error during loading! Is the file in use? Does it exist?");
@@ -181,10 +179,10 @@ static bool doLoadMusic(bool externalThreadFlag)
 	}
 
 	int8_t format = detectModule(f);
-	fseek(f, 0, SEEK_END);
-	uint32_t filesize = ftell(f);
+	mseek(f, 0, SEEK_END);
+	uint32_t filesize = mtell(f);
 
-	rewind(f);
+	mrewind(f);
 	switch (format)
 	{
 		case FORMAT_XM: moduleLoaded = loadXM(f, filesize); break;
@@ -198,7 +196,7 @@ static bool doLoadMusic(bool externalThreadFlag)
 			loaderMsgBox("This file is not a supported module!");
 		break;
 	}
-	fclose(f);
+	mclose(f);
 
 	if (!moduleLoaded)
 		goto loadError;
@@ -224,7 +222,11 @@ static void clearTmpModule(void)
 
 static int32_t SDLCALL loadMusicThread(void *ptr)
 {
-	return doLoadMusic(true);
+	// setup message box functions
+	loaderMsgBox = myLoaderMsgBoxThreadSafe;
+	loaderSysReq = okBoxThreadSafe;
+
+	return doLoadMusic();
 	(void)ptr;
 }
 
@@ -254,6 +256,117 @@ void loadMusic(UNICHAR *filenameU)
 	SDL_DetachThread(thread);
 }
 
+static uint8_t getMODNumChannels(const uint8_t *id)
+{
+	if (isdigit(id[0]) && id[0] != '0' && id[1] == 'C' && id[2] == 'H' && id[3] == 'N') // xCHN
+		return id[0] - '0';
+
+	if (isdigit(id[0]) && isdigit(id[1]) && id[0] != '0' && id[2] == 'C' && (id[3] == 'H' || id[3] == 'N')) // xxCH/xxCN
+		return ((id[0] - '0') * 10) + (id[1] - '0');
+
+	if (id[0] == 'F' && id[1] == 'A' && id[2] == '0' && id[3] >= '4' && id[3] <= '8') // FA0x
+		return id[3] - '0';
+
+	if (!memcmp("FLT8", id, 4) || !memcmp("EXO8", id, 4) || !memcmp("OCTA", id, 4) ||
+		!memcmp("OKTA", id, 4) || !memcmp("CD81", id, 4))
+	{
+		return 8;
+	}
+
+	if (!memcmp("CD61", id, 4))
+		return 6;
+
+	return 4;
+}
+
+// reads format, song name and channel count from the header (for the Disk Op. file info cache)
+bool getModuleFileInfo(MEMFILE *f, fileInfo_t *info)
+{
+	uint8_t D[1084];
+
+	const int8_t format = detectModule(f);
+	if (format == FORMAT_UNKNOWN)
+		return false;
+
+	memset(D, 0, sizeof (D));
+	mrewind(f);
+	mread(D, 1, sizeof (D), f);
+
+	int32_t nameOffset = 0, nameLen = 20;
+	switch (format)
+	{
+		case FORMAT_XM:
+		{
+			strcpy(info->formatName, "XM");
+			nameOffset = 17;
+			info->numChannels = D[68]; // 2 bytes, but never above 32
+		}
+		break;
+
+		case FORMAT_S3M:
+		{
+			strcpy(info->formatName, "S3M");
+			nameLen = 28;
+
+			// count enabled PCM channels
+			for (int32_t i = 0; i < 32; i++)
+			{
+				if (D[0x40+i] < 16)
+					info->numChannels++;
+			}
+		}
+		break;
+
+		case FORMAT_STM:
+		{
+			strcpy(info->formatName, "STM");
+			info->numChannels = 4;
+		}
+		break;
+
+		case FORMAT_MOD:
+		{
+			strcpy(info->formatName, "MOD");
+			info->numChannels = getMODNumChannels(&D[1080]);
+		}
+		break;
+
+		case FORMAT_POSSIBLY_STK:
+		{
+			strcpy(info->formatName, "STK");
+			info->numChannels = 4;
+		}
+		break;
+
+		case FORMAT_DIGI:
+		{
+			strcpy(info->formatName, "DIGI");
+			nameOffset = 610;
+			nameLen = 32;
+			info->numChannels = D[0x19];
+		}
+		break;
+
+		default: return false;
+	}
+
+	memcpy(info->name, &D[nameOffset], nameLen);
+	info->name[nameLen] = '\0';
+
+	// make the name printable and remove trailing spaces
+	for (int32_t i = 0; i < nameLen; i++)
+	{
+		if (info->name[i] != '\0' && (uint8_t)info->name[i] < ' ')
+			info->name[i] = ' ';
+	}
+
+	for (int32_t i = (int32_t)strlen(info->name) - 1; i >= 0 && info->name[i] == ' '; i--)
+		info->name[i] = '\0';
+
+	info->type = FILEINFO_MODULE;
+	return true;
+}
+
 bool loadMusicUnthreaded(UNICHAR *filenameU, bool autoPlay)
 {
 	if (filenameU == NULL)
@@ -263,7 +376,12 @@ bool loadMusicUnthreaded(UNICHAR *filenameU, bool autoPlay)
 	UNICHAR_STRCPY(editor.tmpFilenameU, filenameU);
 
 	editor.loadMusicEvent = EVENT_NONE;
-	doLoadMusic(false);
+
+	// setup message box functions
+	loaderMsgBox = myLoaderMsgBox;
+	loaderSysReq = okBox;
+
+	doLoadMusic();
 
 	if (moduleLoaded)
 	{
@@ -277,6 +395,63 @@ bool loadMusicUnthreaded(UNICHAR *filenameU, bool autoPlay)
 	return false;
 }
 
+static void headlessLoaderMsgBox(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+
+	fputc('\n', stderr);
+}
+
+static int16_t headlessLoaderSysReq(int16_t type, const char *headline, const char *text, void (*checkBoxCallback)(void))
+{
+	fprintf(stderr, "%s\n", text);
+	return 1; // first button ("OK"/"Mix"/etc.)
+
+	(void)type;
+	(void)headline;
+	(void)checkBoxCallback;
+}
+
+bool loadMusicHeadless(UNICHAR *filenameU) // for command-line rendering (no window)
+{
+	if (filenameU == NULL)
+		return false;
+
+	if (editor.tmpFilenameU == NULL)
+	{
+		editor.tmpFilenameU = (UNICHAR *)malloc((PATH_MAX + 1) * sizeof (UNICHAR));
+		if (editor.tmpFilenameU == NULL)
+			return false;
+	}
+
+	clearTmpModule(); // clear stuff from last loading session (very important)
+	UNICHAR_STRNCPY(editor.tmpFilenameU, filenameU, PATH_MAX);
+	editor.tmpFilenameU[PATH_MAX] = 0;
+
+	moduleLoaded = false;
+	moduleFailedToLoad = false;
+
+	// print loader messages to stderr instead of showing message boxes
+	loaderMsgBox = headlessLoaderMsgBox;
+	loaderSysReq = headlessLoaderSysReq;
+
+	const bool loaded = doLoadMusic();
+
+	moduleLoaded = false;
+	moduleFailedToLoad = false;
+
+	if (!loaded)
+		return false;
+
+	setupLoadedModuleData();
+
+	return true;
+}
+
 bool allocateTmpPatt(int32_t pattNum, uint16_t numRows)
 {
 	patternTmp[pattNum] = (note_t *)calloc((MAX_PATT_LEN * TRACK_WIDTH) + 16, 1);
@@ -363,8 +538,8 @@ void clearUnusedChannels(note_t *pattPtr, int16_t numRows, int32_t numChannels)
 		memset(p, 0, width);
 }
 
-// called from input/video thread after the module was done loading
-static void setupLoadedModule(void)
+// copies the loaded module over to the replayer (no GUI handling)
+static void setupLoadedModuleData(void)
 {
 	lockMixerCallback();
 
@@ -462,9 +637,6 @@ static void setupLoadedModule(void)
 		}
 	}
 
-	setScrollBarEnd(SB_POS_ED, (song.songLength - 1) + 5);
-	setScrollBarPos(SB_POS_ED, 0, false);
-
 	resetChannels();
 	setPos(0, 0, true);
 	setMixerBPM(song.BPM);
@@ -478,6 +650,15 @@ static void setupLoadedModule(void)
 	setLinearPeriods(tmpLinearPeriodsFlag);
 
 	unlockMixerCallback();
+}
+
+// called from input/video thread after the module was done loading
+static void setupLoadedModule(void)
+{
+	setupLoadedModuleData();
+
+	setScrollBarEnd(SB_POS_ED, (song.songLength - 1) + 5);
+	setScrollBarPos(SB_POS_ED, 0, false);
 
 	editor.currVolEnvPoint = 0;
 	editor.currPanEnvPoint = 0;
@@ -586,12 +767,12 @@ bool handleModuleLoadFromArg(int argc, char **argv)
 
 static bool fileIsModule(UNICHAR *pathU)
 {
-	FILE *f = UNICHAR_FOPEN(pathU, "rb");
+	MEMFILE *f = mopen(pathU);
 	if (f == NULL)
 		return false;
 
 	int8_t modFormat = detectModule(f);
-	fclose(f);
+	mclose(f);
 
 	/* If the module was not identified (possibly STK type),
 	** check the file extension and handle it as a module only
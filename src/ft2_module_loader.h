@@ -4,6 +4,8 @@
 #include <stdbool.h>
 #include "ft2_header.h"
 #include "ft2_unicode.h"
+#include "ft2_memfile.h"
+#include "ft2_diskop_cache.h"
 
 bool tmpPatternEmpty(uint16_t pattNum);
 void clearUnusedChannels(note_t *p, int16_t numRows, int32_t numChannels);
@@ -11,9 +13,11 @@ bool allocateTmpInstr(int16_t insNum);
 bool allocateTmpPatt(int32_t pattNum, uint16_t numRows);
 void loadMusic(UNICHAR *filenameU);
 bool loadMusicUnthreaded(UNICHAR *filenameU, bool autoPlay);
+bool loadMusicHeadless(UNICHAR *filenameU); // for command-line rendering (no window)
 bool handleModuleLoadFromArg(int argc, char **argv);
 void loadDroppedFile(char *fullPathUTF8, bool songModifiedCheck);
 void handleLoadMusicEvents(void);
+bool getModuleFileInfo(MEMFILE *f, fileInfo_t *info); // for Disk Op. (header only)
 
 // file extensions accepted by Disk Op. in module mode
 extern char *supportedModExtensions[];
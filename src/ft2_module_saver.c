@@ -376,6 +376,12 @@ static bool saveMOD(UNICHAR *filenameU)
 	}
 	if (test) okBoxThreadSafe(0, "System message", "Warning: Song is using XM instrument features!", NULL);
 
+	if (song.numChannels > 32) // only possible with MAX_CHANNELS above 32
+	{
+		okBoxThreadSafe(0, "System message", "Error: The MOD format supports max. 32 channels! Module wasn't saved.", NULL);
+		return false;
+	}
+
 	bool tooLongPatterns = false;
 	bool tooManyInstr = false;
 	bool incompatEfx = false;
@@ -624,7 +624,7 @@ void mouseButtonUpHandler(uint8_t mouseButton)
 			resumeAudio();
 
 			if (ui.sampleEditorShown)
-				writeSample(true);
+				writeSampleKeepPeaks();
 
 			setSongModifiedFlag();
 
@@ -64,6 +64,8 @@ void setPal16(pal16 *p, bool redrawScreen)
 	{
 		for (int32_t i = 0; i < SCREEN_W*SCREEN_H; i++)
 			video.frameBuffer[i] = video.palette[(video.frameBuffer[i] >> 24) & 15]; // ARGB alpha channel = palette index
+
+		markScreenDirty();
 	}
 }
 
@@ -0,0 +1,71 @@
+// for finding memory leaks in debug mode with Visual Studio
+#if defined _DEBUG && defined _MSC_VER
+#include <crtdbg.h>
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ft2_header.h"
+#include "ft2_parallel.h"
+
+typedef struct parallelJobs_t
+{
+	parallelJobFunc_t jobFunc;
+	void *userData;
+	int32_t numJobs;
+	SDL_atomic_t nextJob;
+} parallelJobs_t;
+
+static void doJobs(parallelJobs_t *p)
+{
+	while (true)
+	{
+		const int32_t job = SDL_AtomicAdd(&p->nextJob, 1);
+		if (job >= p->numJobs)
+			break;
+
+		p->jobFunc(p->userData, job);
+	}
+}
+
+static int32_t SDLCALL parallelThreadFunc(void *ptr)
+{
+	doJobs((parallelJobs_t *)ptr);
+	return true;
+}
+
+void runParallelJobs(parallelJobFunc_t jobFunc, void *userData, int32_t numJobs)
+{
+	SDL_Thread *threads[MAX_PARALLEL_THREADS-1];
+	parallelJobs_t p;
+
+	if (numJobs <= 0)
+		return;
+
+	p.jobFunc = jobFunc;
+	p.userData = userData;
+	p.numJobs = numJobs;
+	SDL_AtomicSet(&p.nextJob, 0);
+
+	int32_t numThreads = SDL_GetCPUCount();
+	if (numThreads > numJobs)
+		numThreads = numJobs;
+	if (numThreads > MAX_PARALLEL_THREADS)
+		numThreads = MAX_PARALLEL_THREADS;
+
+	// the calling thread is one of the workers
+	int32_t numWorkers = 0;
+	for (int32_t i = 0; i < numThreads-1; i++)
+	{
+		threads[numWorkers] = SDL_CreateThread(parallelThreadFunc, NULL, &p);
+		if (threads[numWorkers] == NULL)
+			break; // fewer threads then, the remaining jobs still get done
+
+		numWorkers++;
+	}
+
+	doJobs(&p);
+
+	for (int32_t i = 0; i < numWorkers; i++)
+		SDL_WaitThread(threads[i], NULL);
+}
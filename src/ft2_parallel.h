@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Runs jobFunc(userData, 0..numJobs-1) spread over the CPU cores and returns when all jobs
+** are done. Worker threads are started for the duration of the call (the calling thread
+** takes jobs as well), so this is meant for bigger offline jobs like sample decoding, not
+** for things that run every audio/video frame.
+**
+** Jobs are handed out in order, so put the biggest ones first for the best load balancing.
+** If no threads could be created, all the jobs are simply run on the calling thread.
+*/
+
+#define MAX_PARALLEL_THREADS 64
+
+typedef void (*parallelJobFunc_t)(void *userData, int32_t jobIndex);
+
+void runParallelJobs(parallelJobFunc_t jobFunc, void *userData, int32_t numJobs);
@@ -149,11 +149,13 @@ void drawPatternBorders(void)
 		{
 			const int32_t clearSize = ui.pattChanScrollShown ? (SCREEN_W * sizeof (int32_t) * 330) : (SCREEN_W * sizeof (int32_t) * 347);
 			memset(&video.frameBuffer[53 * SCREEN_W], 0, clearSize);
+			markDirtyRect(0, 53, SCREEN_W, clearSize / (SCREEN_W * sizeof (int32_t)));
 		}
 		else
 		{
 			const int32_t clearSize = ui.pattChanScrollShown ? (SCREEN_W * sizeof(int32_t) * 210) : (SCREEN_W * sizeof(int32_t) * 227);
 			memset(&video.frameBuffer[173 * SCREEN_W], 0, clearSize);
+			markDirtyRect(0, 173, SCREEN_W, clearSize / (SCREEN_W * sizeof (int32_t)));
 		}
 
 		drawFramework(0, pattCoord->lowerRowsY - 10, SCREEN_W, 11, FRAMEWORK_TYPE1);
@@ -186,6 +188,7 @@ static void writeCursor(void)
 	xPos += ((cursor.ch - ui.channelOffset) * ui.patternChannelWidth);
 
 	uint32_t *dstPtr = &video.frameBuffer[(editor.ptnCursorY * SCREEN_W) + xPos];
+	markDirtyRect(xPos, editor.ptnCursorY, width, 9);
 	for (int32_t y = 0; y < 9; y++)
 	{
 		for (int32_t x = 0; x < width; x++)
@@ -288,6 +291,7 @@ static void writePatternBlockMark(int32_t currRow, uint32_t rowHeight, const pat
 	assert(x1+w <= SCREEN_W && y1+h <= SCREEN_H);
 
 	uint32_t *ptr32 = &video.frameBuffer[(y1 * SCREEN_W) + x1];
+	markDirtyRect(x1, y1, w, h);
 	for (int32_t y = 0; y < h; y++)
 	{
 		for (int32_t x = 0; x < w; x++)
@@ -308,10 +312,16 @@ static void drawChannelNumbering(uint16_t yPos)
 		{
 			charOutOutlined(xPos, yPos, PAL_MOUSEPT, '0' + (char)ch);
 		}
-		else
+		else if (ch < 100)
+		{
+			charOutOutlined(xPos, yPos, PAL_MOUSEPT, '0' + (char)(ch / 10));
+			charOutOutlined(xPos + (FONT1_CHAR_W + 1), yPos, PAL_MOUSEPT, '0' + (char)(ch % 10));
+		}
+		else // only with MAX_CHANNELS above 99
 		{
-			charOutOutlined(xPos, yPos, PAL_MOUSEPT, chDecTab1[ch]);
-			charOutOutlined(xPos + (FONT1_CHAR_W + 1), yPos, PAL_MOUSEPT, chDecTab2[ch]);
+			charOutOutlined(xPos, yPos, PAL_MOUSEPT, '0' + (char)(ch / 100));
+			charOutOutlined(xPos + (FONT1_CHAR_W + 1), yPos, PAL_MOUSEPT, '0' + (char)((ch / 10) % 10));
+			charOutOutlined(xPos + ((FONT1_CHAR_W + 1) * 2), yPos, PAL_MOUSEPT, '0' + (char)(ch % 10));
 		}
 
 		ch++;
@@ -340,6 +350,7 @@ static void drawRowNums(int32_t yPos, uint8_t row, bool selectedRowFlag)
 	const uint8_t *src1Ptr = &font4Ptr[(row   >> 4) * FONT4_CHAR_W];
 	const uint8_t *src2Ptr = &font4Ptr[(row & 0x0F) * FONT4_CHAR_W];
 	uint32_t *dst1Ptr = &video.frameBuffer[(yPos * SCREEN_W) + LEFT_ROW_XPOS];
+	markDirtyRect(LEFT_ROW_XPOS, yPos, (RIGHT_ROW_XPOS - LEFT_ROW_XPOS) + (FONT4_CHAR_W * 2), FONT4_CHAR_H);
 	uint32_t *dst2Ptr = dst1Ptr + (RIGHT_ROW_XPOS - LEFT_ROW_XPOS);
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
@@ -634,22 +645,103 @@ static void showEfxNoVolColumn(uint32_t xPos, uint32_t yPos, uint8_t efx, uint8_
 	pattCharOut(xPos + (charW * 2), yPos, efxData & 0x0F, fontType, color);
 }
 
+/* The pattern view (borders and rows, without the cursor, block mark and channel numbers) is
+** kept in pattView.surface. writePattern() restores the view from it, and then only updates
+** the rows that changed. A row that is still on screen, but at another position (f.ex. when
+** the song advances one row), is copied from its old position instead of being drawn again.
+** Everything is redrawn if the layout, the pattern font settings or the palette changed.
+*/
+
+#define PATT_VIEW_MAX_ROWS 48 // the extended pattern editor has the most rows (42)
+#define PATT_VIEW_MAX_CHANS 12
+#define PATT_ROW_H FONT4_CHAR_H // height of the row text (tallest pattern font)
+
+enum
+{
+	PATT_REGION_UPPER = 0,
+	PATT_REGION_MID = 1, // current row
+	PATT_REGION_LOWER = 2
+};
+
+typedef struct pattViewKey_t // everything (except the pattern data) that changes the rendering
+{
+	uint32_t palette[PAL_NUM];
+	int16_t ptnFont, ptnAcc;
+	uint8_t ptnStretch, ptnHex, ptnInstrZero, ptnFrmWrk, ptnLineLight, ptnShowVolColumn;
+	uint8_t numChannelsShown, maxVisibleChannels;
+	bool extended, pattChanScrollShown;
+} pattViewKey_t;
+
+static struct
+{
+	bool valid;
+	pattViewKey_t key;
+	int32_t areaY, areaH;
+	int32_t slotRow[PATT_VIEW_MAX_ROWS]; // row shown at each screen row slot (-1 = none)
+	note_t slotData[PATT_VIEW_MAX_ROWS][PATT_VIEW_MAX_CHANS];
+	uint32_t background[3][PATT_ROW_H * SCREEN_W]; // empty row for each region
+	uint32_t surface[SCREEN_W * SCREEN_H];
+} pattView;
+
+static int32_t getSlotRegion(const pattCoord_t *pattCoord, int32_t slot)
+{
+	if (slot < pattCoord->numUpperRows)
+		return PATT_REGION_UPPER;
+	else if (slot == pattCoord->numUpperRows)
+		return PATT_REGION_MID;
+	else
+		return PATT_REGION_LOWER;
+}
+
+static int32_t getSlotTextY(const pattCoord_t *pattCoord, int32_t rowHeight, int32_t slot)
+{
+	if (slot < pattCoord->numUpperRows)
+		return pattCoord->upperRowsTextY + (slot * rowHeight);
+	else if (slot == pattCoord->numUpperRows)
+		return pattCoord->midRowTextY;
+	else
+		return pattCoord->lowerRowsTextY + ((slot - (pattCoord->numUpperRows + 1)) * rowHeight);
+}
+
+// returns false if the pattern view has to be redrawn from scratch
+static bool updatePattViewKey(void)
+{
+	pattViewKey_t key;
+
+	memset(&key, 0, sizeof (key)); // clear padding bytes, for memcmp()
+	memcpy(key.palette, video.palette, sizeof (key.palette));
+	key.ptnFont = config.ptnFont;
+	key.ptnAcc = config.ptnAcc;
+	key.ptnStretch = config.ptnStretch;
+	key.ptnHex = config.ptnHex;
+	key.ptnInstrZero = config.ptnInstrZero;
+	key.ptnFrmWrk = config.ptnFrmWrk;
+	key.ptnLineLight = config.ptnLineLight;
+	key.ptnShowVolColumn = config.ptnShowVolColumn;
+	key.numChannelsShown = ui.numChannelsShown;
+	key.maxVisibleChannels = ui.maxVisibleChannels;
+	key.extended = ui.extended;
+	key.pattChanScrollShown = ui.pattChanScrollShown;
+
+	if (pattView.valid && memcmp(&key, &pattView.key, sizeof (key)) == 0)
+		return true;
+
+	pattView.key = key;
+	pattView.valid = true;
+	return false;
+}
+
 void writePattern(int32_t currRow, int32_t currPattern)
 {
 	uint32_t noteTextColors[2];
+	int32_t newSlotRow[PATT_VIEW_MAX_ROWS];
+	note_t newSlotData[PATT_VIEW_MAX_ROWS][PATT_VIEW_MAX_CHANS];
 
 	void (*drawNote)(uint32_t, uint32_t, int16_t, uint32_t);
 	void (*drawInst)(uint32_t, uint32_t, uint8_t, uint32_t);
 	void (*drawVolEfx)(uint32_t, uint32_t, uint8_t, uint32_t);
 	void (*drawEfx)(uint32_t, uint32_t, uint8_t, uint8_t, uint32_t);
 
-	/* Draw pattern framework every time (erasing existing content).
-	** FT2 doesn't do this. This is quite lazy and consumes more CPU
-	** time than needed (overlapped drawing), but it makes the pattern
-	** mark/cursor drawing MUCH simpler to implement...
-	*/
-	drawPatternBorders();
-
 	// setup variables
 
 	uint32_t chans = ui.numChannelsShown;
@@ -665,20 +757,37 @@ void writePattern(int32_t currRow, int32_t currPattern)
 	// get heights/pos/rows depending on configuration
 	uint32_t rowHeight = config.ptnStretch ? 11 : 8;
 	const pattCoord_t *pattCoord = &pattCoordTable[config.ptnStretch][ui.pattChanScrollShown][ui.extended];
-	const int32_t midRowTextY = pattCoord->midRowTextY;
-	const int32_t lowerRowsTextY = pattCoord->lowerRowsTextY;
-	int32_t row = currRow - pattCoord->numUpperRows;
 	const int32_t rowsOnScreen = pattCoord->numUpperRows + 1 + pattCoord->numLowerRows;
-	int32_t textY = pattCoord->upperRowsTextY;
-	const int32_t afterCurrRow = currRow + 1;
 	const int32_t numChannels = ui.numChannelsShown;
 	note_t *pattPtr = pattern[currPattern];
 	const int32_t numRows = patternNumRows[currPattern];
 
+	assert(rowsOnScreen <= PATT_VIEW_MAX_ROWS && numChannels <= PATT_VIEW_MAX_CHANS);
+
 	// increment pattern data pointer by horizontal scrollbar offset/channel
 	if (pattPtr != NULL)
 		pattPtr += ui.channelOffset;
 
+	const bool redrawAll = !updatePattViewKey();
+	if (redrawAll)
+	{
+		drawPatternBorders();
+
+		pattView.areaY = ui.extended ? 53 : 173;
+		pattView.areaH = (ui.pattChanScrollShown ? 383 : SCREEN_H) - pattView.areaY;
+
+		// get the empty rows (the background varies between the upper, middle and lower part)
+		memcpy(pattView.background[PATT_REGION_UPPER], &video.frameBuffer[pattCoord->upperRowsTextY * SCREEN_W], sizeof (pattView.background[0]));
+		memcpy(pattView.background[PATT_REGION_MID], &video.frameBuffer[pattCoord->midRowTextY * SCREEN_W], sizeof (pattView.background[0]));
+		memcpy(pattView.background[PATT_REGION_LOWER], &video.frameBuffer[pattCoord->lowerRowsTextY * SCREEN_W], sizeof (pattView.background[0]));
+	}
+	else
+	{
+		// get rid of the cursor/mark/channel numbers (and anything else that was drawn on top of the pattern view)
+		memcpy(&video.frameBuffer[pattView.areaY * SCREEN_W], pattView.surface, pattView.areaH * SCREEN_W * sizeof (int32_t));
+		markDirtyRect(0, pattView.areaY, SCREEN_W, pattView.areaH);
+	}
+
 	// set up function pointers for drawing
 	if (config.ptnShowVolColumn)
 	{
@@ -699,41 +808,78 @@ void writePattern(int32_t currRow, int32_t currPattern)
 	noteTextColors[1] = video.palette[PAL_FORGRND]; // selected
 
 	// draw pattern data
+	const size_t rowDataBytes = numChannels * sizeof (note_t);
 	for (int32_t i = 0; i < rowsOnScreen; i++)
 	{
+		int32_t row = currRow + (i - pattCoord->numUpperRows);
+		if (row < 0 || row >= numRows)
+			row = -1;
+
+		const note_t *p = NULL;
 		if (row >= 0)
 		{
-			const bool selectedRowFlag = (row == currRow);
+			p = (pattPtr == NULL) ? emptyPattern : &pattPtr[(uint32_t)row * MAX_CHANNELS];
+			memcpy(newSlotData[i], p, rowDataBytes);
+		}
+
+		newSlotRow[i] = row;
 
-			drawRowNums(textY, (uint8_t)row, selectedRowFlag);
+		// row didn't change?
+		if (!redrawAll && pattView.slotRow[i] == row && (row < 0 || memcmp(pattView.slotData[i], p, rowDataBytes) == 0))
+			continue;
 
-			const note_t *p = (pattPtr == NULL) ? emptyPattern : &pattPtr[(uint32_t)row * MAX_CHANNELS];
-			const int32_t xWidth = ui.patternChannelWidth;
-			const uint32_t color = noteTextColors[selectedRowFlag];
+		const int32_t region = getSlotRegion(pattCoord, i);
+		const int32_t textY = getSlotTextY(pattCoord, rowHeight, i);
+		uint32_t *dstPtr = &video.frameBuffer[textY * SCREEN_W];
+		markDirtyRect(0, textY, SCREEN_W, PATT_ROW_H);
 
-			int32_t xPos = 29;
-			for (int32_t j = 0; j < numChannels; j++, p++, xPos += xWidth)
+		// was the row somewhere else (in the same part of the view)? Then copy it from there
+		int32_t oldSlot = -1;
+		if (!redrawAll && row >= 0)
+		{
+			for (int32_t j = 0; j < rowsOnScreen; j++)
 			{
-				drawNote(xPos, textY, p->note, color);
-				drawInst(xPos, textY, p->instr, color);
-				drawVolEfx(xPos, textY, p->vol, color);
-				drawEfx(xPos, textY, p->efx, p->efxData, color);
+				if (pattView.slotRow[j] == row && getSlotRegion(pattCoord, j) == region && memcmp(pattView.slotData[j], p, rowDataBytes) == 0)
+				{
+					oldSlot = j;
+					break;
+				}
 			}
 		}
 
-		// next row
-		if (++row >= numRows)
-			break;
+		if (oldSlot >= 0)
+		{
+			const int32_t oldTextY = getSlotTextY(pattCoord, rowHeight, oldSlot);
+			memcpy(dstPtr, &pattView.surface[(oldTextY - pattView.areaY) * SCREEN_W], PATT_ROW_H * SCREEN_W * sizeof (int32_t));
+			continue;
+		}
+
+		memcpy(dstPtr, pattView.background[region], PATT_ROW_H * SCREEN_W * sizeof (int32_t));
+		if (row < 0)
+			continue; // no row here
 
-		// adjust textY position
-		if (row == currRow)
-			textY = midRowTextY;
-		else if (row == afterCurrRow)
-			textY = lowerRowsTextY;
-		else
-			textY += rowHeight;
+		const bool selectedRowFlag = (row == currRow);
+
+		drawRowNums(textY, (uint8_t)row, selectedRowFlag);
+
+		const int32_t xWidth = ui.patternChannelWidth;
+		const uint32_t color = noteTextColors[selectedRowFlag];
+
+		int32_t xPos = 29;
+		for (int32_t j = 0; j < numChannels; j++, p++, xPos += xWidth)
+		{
+			drawNote(xPos, textY, p->note, color);
+			drawInst(xPos, textY, p->instr, color);
+			drawVolEfx(xPos, textY, p->vol, color);
+			drawEfx(xPos, textY, p->efx, p->efxData, color);
+		}
 	}
 
+	// update the pattern view's surface (all rows were restored from it, so it can simply be overwritten)
+	memcpy(pattView.slotRow, newSlotRow, rowsOnScreen * sizeof (int32_t));
+	memcpy(pattView.slotData, newSlotData, rowsOnScreen * sizeof (newSlotData[0]));
+	memcpy(pattView.surface, &video.frameBuffer[pattView.areaY * SCREEN_W], pattView.areaH * SCREEN_W * sizeof (int32_t));
+
 	writeCursor();
 
 	// draw pattern marking (if anything is marked)
@@ -752,6 +898,7 @@ void pattTwoHexOut(uint32_t xPos, uint32_t yPos, uint8_t val, uint32_t color)
 	const uint8_t *ch1Ptr = &font4Ptr[(val   >> 4) * FONT4_CHAR_W];
 	const uint8_t *ch2Ptr = &font4Ptr[(val & 0x0F) * FONT4_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT4_CHAR_W * 2, FONT4_CHAR_H);
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
 	{
@@ -777,6 +924,7 @@ static void pattCharOut(uint32_t xPos, uint32_t yPos, uint8_t chr, uint8_t fontT
 	if (fontType == FONT_TYPE3)
 	{
 		srcPtr = &bmp.font3[chr * FONT3_CHAR_W];
+		markDirtyRect(xPos, yPos, FONT3_CHAR_W, FONT3_CHAR_H);
 		for (y = 0; y < FONT3_CHAR_H; y++)
 		{
 			for (x = 0; x < FONT3_CHAR_W; x++)
@@ -792,6 +940,7 @@ static void pattCharOut(uint32_t xPos, uint32_t yPos, uint8_t chr, uint8_t fontT
 	else if (fontType == FONT_TYPE4)
 	{
 		srcPtr = &font4Ptr[chr * FONT4_CHAR_W];
+		markDirtyRect(xPos, yPos, FONT4_CHAR_W, FONT4_CHAR_H);
 		for (y = 0; y < FONT4_CHAR_H; y++)
 		{
 			for (x = 0; x < FONT4_CHAR_W; x++)
@@ -807,6 +956,7 @@ static void pattCharOut(uint32_t xPos, uint32_t yPos, uint8_t chr, uint8_t fontT
 	else if (fontType == FONT_TYPE5)
 	{
 		srcPtr = &font5Ptr[chr * FONT5_CHAR_W];
+		markDirtyRect(xPos, yPos, FONT5_CHAR_W, FONT5_CHAR_H);
 		for (y = 0; y < FONT5_CHAR_H; y++)
 		{
 			for (x = 0; x < FONT5_CHAR_W; x++)
@@ -822,6 +972,7 @@ static void pattCharOut(uint32_t xPos, uint32_t yPos, uint8_t chr, uint8_t fontT
 	else
 	{
 		srcPtr = &bmp.font7[chr * FONT7_CHAR_W];
+		markDirtyRect(xPos, yPos, FONT7_CHAR_W, FONT7_CHAR_H);
 		for (y = 0; y < FONT7_CHAR_H; y++)
 		{
 			for (x = 0; x < FONT7_CHAR_W; x++)
@@ -840,6 +991,7 @@ static void drawEmptyNoteSmall(uint32_t xPos, uint32_t yPos, uint32_t color)
 {
 	const uint8_t *srcPtr = &bmp.font7[18 * FONT7_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT7_CHAR_W * 3, FONT7_CHAR_H);
 
 	for (int32_t y = 0; y < FONT7_CHAR_H; y++)
 	{
@@ -858,6 +1010,7 @@ static void drawKeyOffSmall(uint32_t xPos, uint32_t yPos, uint32_t color)
 {
 	const uint8_t *srcPtr = &bmp.font7[21 * FONT7_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + (xPos + 2)];
+	markDirtyRect(xPos + 2, yPos, FONT7_CHAR_W * 2, FONT7_CHAR_H);
 
 	for (int32_t y = 0; y < FONT7_CHAR_H; y++)
 	{
@@ -896,6 +1049,7 @@ static void drawNoteSmall(uint32_t xPos, uint32_t yPos, int32_t noteNum, uint32_
 	const uint8_t *ch2Ptr = &bmp.font7[char2];
 	const uint8_t *ch3Ptr = &bmp.font7[char3];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, (FONT7_CHAR_W * 3) - 2, FONT7_CHAR_H);
 
 	for (int32_t y = 0; y < FONT7_CHAR_H; y++)
 	{
@@ -916,6 +1070,7 @@ static void drawNoteSmall(uint32_t xPos, uint32_t yPos, int32_t noteNum, uint32_
 static void drawEmptyNoteMedium(uint32_t xPos, uint32_t yPos, uint32_t color)
 {
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT4_CHAR_W * 3, FONT4_CHAR_H);
 	const uint8_t *srcPtr = &font4Ptr[43 * FONT4_CHAR_W];
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
@@ -935,6 +1090,7 @@ static void drawKeyOffMedium(uint32_t xPos, uint32_t yPos, uint32_t color)
 {
 	const uint8_t *srcPtr = &font4Ptr[40 * FONT4_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT4_CHAR_W * 3, FONT4_CHAR_H);
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
 	{
@@ -973,6 +1129,7 @@ static void drawNoteMedium(uint32_t xPos, uint32_t yPos, int32_t noteNum, uint32
 	const uint8_t *ch2Ptr = &font4Ptr[char2];
 	const uint8_t *ch3Ptr = &font4Ptr[char3];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT4_CHAR_W * 3, FONT4_CHAR_H);
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
 	{
@@ -994,6 +1151,7 @@ static void drawEmptyNoteBig(uint32_t xPos, uint32_t yPos, uint32_t color)
 {
 	const uint8_t *srcPtr = &font4Ptr[67 * FONT4_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT4_CHAR_W * 6, FONT4_CHAR_H);
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
 	{
@@ -1012,6 +1170,7 @@ static void drawKeyOffBig(uint32_t xPos, uint32_t yPos, uint32_t color)
 {
 	const uint8_t *srcPtr = &bmp.font4[61 * FONT4_CHAR_W];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT4_CHAR_W * 6, FONT4_CHAR_H);
 
 	for (int32_t y = 0; y < FONT4_CHAR_H; y++)
 	{
@@ -1050,6 +1209,7 @@ static void drawNoteBig(uint32_t xPos, uint32_t yPos, int32_t noteNum, uint32_t
 	const uint8_t *ch2Ptr = &font5Ptr[char2];
 	const uint8_t *ch3Ptr = &font5Ptr[char3];
 	uint32_t *dstPtr = &video.frameBuffer[(yPos * SCREEN_W) + xPos];
+	markDirtyRect(xPos, yPos, FONT5_CHAR_W * 3, FONT5_CHAR_H);
 
 	for (int32_t y = 0; y < FONT5_CHAR_H; y++)
 	{
@@ -25,7 +25,7 @@
 
 
 // for pattern marking w/ keyboard
-static int8_t lastChMark;
+static int16_t lastChMark;
 static int16_t lastRowMark;
 
 // for pattern marking w/ mouse
@@ -754,7 +754,7 @@ void checkMarkLimits(void)
 	pattMark.markY2 = markY2;
 }
 
-static int8_t mouseXToCh(void) // used to get channel num from mouse x (for pattern marking)
+static int16_t mouseXToCh(void) // used to get channel num from mouse x (for pattern marking)
 {
 	assert(ui.patternChannelWidth > 0);
 	if (ui.patternChannelWidth == 0)
@@ -763,14 +763,14 @@ static int8_t mouseXToCh(void) // used to get channel num from mouse x (for patt
 	int32_t mouseX = mouse.x - 29;
 	mouseX = CLAMP(mouseX, 0, 573);
 
-	const int8_t chEnd = (ui.channelOffset + ui.numChannelsShown) - 1;
+	const int16_t chEnd = (ui.channelOffset + ui.numChannelsShown) - 1;
 
-	int8_t ch = ui.channelOffset + (int8_t)(mouseX / ui.patternChannelWidth);
+	int16_t ch = ui.channelOffset + (int16_t)(mouseX / ui.patternChannelWidth);
 	ch = CLAMP(ch, 0, chEnd);
 
 	// in some setups there can be non-used channels to the right, do clamping
 	if (ch >= song.numChannels)
-		ch = (int8_t)(song.numChannels - 1);
+		ch = (int16_t)(song.numChannels - 1);
 
 	return ch;
 }
@@ -880,7 +880,7 @@ void handlePatternDataMouseDown(bool mouseButtonHeld)
 	{
 		lastMouseX = mouse.x;
 
-		int8_t chTmp = mouseXToCh();
+		int16_t chTmp = mouseXToCh();
 		if (chTmp < lastChMark)
 		{
 			pattMark.markX1 = chTmp;
@@ -1039,7 +1039,7 @@ void rowDown(uint16_t amount)
 
 void keybPattMarkUp(void)
 {
-	int8_t xPos = cursor.ch;
+	int32_t xPos = cursor.ch;
 	int16_t row = editor.row;
 
 	if (xPos != pattMark.markX1 && xPos != pattMark.markX2)
@@ -1073,7 +1073,7 @@ void keybPattMarkUp(void)
 
 void keybPattMarkDown(void)
 {
-	int8_t xPos = cursor.ch;
+	int32_t xPos = cursor.ch;
 	int16_t row = editor.row;
 
 	if (xPos != pattMark.markX1 && xPos != pattMark.markX2)
@@ -1106,7 +1106,7 @@ void keybPattMarkDown(void)
 
 void keybPattMarkLeft(void)
 {
-	int8_t xPos = cursor.ch;
+	int32_t xPos = cursor.ch;
 	int16_t row = editor.row;
 
 	if (row != pattMark.markY1-1 && row != pattMark.markY2)
@@ -1137,7 +1137,7 @@ void keybPattMarkLeft(void)
 
 void keybPattMarkRight(void)
 {
-	int8_t xPos = cursor.ch;
+	int32_t xPos = cursor.ch;
 	int16_t row = editor.row;
 
 	if (row != pattMark.markY1-1 && row != pattMark.markY2)
@@ -1823,7 +1823,7 @@ void pbDecAdd(void)
 
 void pbAddChan(void)
 {
-	if (song.numChannels > 30)
+	if (song.numChannels > MAX_CHANNELS-2)
 		return;
 
 	lockMixerCallback();
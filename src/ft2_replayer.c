@@ -20,6 +20,7 @@
 #include "ft2_sample_loader.h"
 #include "ft2_tables.h"
 #include "ft2_structs.h"
+#include "ft2_smp_kernels.h"
 #include "mixer/ft2_cubic_spline.h"
 #include "mixer/ft2_windowed_sinc.h"
 
@@ -2414,7 +2415,11 @@ void setPos(int16_t songPos, int16_t row, bool resetTimer)
 		unlockAudio();
 }
 
-void delta2Samp(int8_t *p, int32_t length, uint8_t smpFlags)
+/* Decodes delta-encoded sample data from 'src' into 'dst' (they can be the same buffer).
+** 'src' doesn't need to be aligned (it can point into a mapped file) and is read as little-endian.
+** Stereo samples (L and R after each other) are downmixed to mono, only 'length/2' samples are written.
+*/
+void delta2SampFrom(int8_t *dst, const int8_t *src, int32_t length, uint8_t smpFlags)
 {
 	bool sample16Bit = !!(smpFlags & SAMPLE_16BIT);
 	bool stereo = !!(smpFlags & SAMPLE_STEREO);
@@ -2424,103 +2429,30 @@ void delta2Samp(int8_t *p, int32_t length, uint8_t smpFlags)
 		length >>= 1;
 
 		if (sample16Bit)
-		{
-			int16_t *p16L = (int16_t *)p;
-			int16_t *p16R = (int16_t *)p + length;
-
-			int16_t olds16L = 0;
-			int16_t olds16R = 0;
-
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int16_t news16L = p16L[i] + olds16L;
-				p16L[i] = news16L;
-				olds16L = news16L;
-
-				const int16_t news16R = p16R[i] + olds16R;
-				p16R[i] = news16R;
-				olds16R = news16R;
-
-				p16L[i] = (int16_t)((olds16L + olds16R) >> 1);
-			}
-		}
-		else // 8-bit
-		{
-			int8_t *p8L = (int8_t *)p;
-			int8_t *p8R = (int8_t *)p + length;
-
-			int8_t olds8L = 0;
-			int8_t olds8R = 0;
-
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int8_t news8L = p8L[i] + olds8L;
-				p8L[i] = news8L;
-				olds8L = news8L;
-
-				const int8_t news8R = p8R[i] + olds8R;
-				p8R[i] = news8R;
-				olds8R = news8R;
-
-				p8L[i] = (int8_t)((olds8L + olds8R) >> 1);
-			}
-		}
+			smpKernels->deltaDecodeStereo16((int16_t *)dst, src, src + (length << 1), length);
+		else
+			smpKernels->deltaDecodeStereo8(dst, src, src + length, length);
 	}
 	else // mono (normal sample)
 	{
 		if (sample16Bit)
-		{
-			int16_t *p16 = (int16_t *)p;
-
-			int16_t olds16L = 0;
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int16_t news16 = p16[i] + olds16L;
-				p16[i] = news16;
-				olds16L = news16;
-			}
-		}
-		else // 8-bit
-		{
-			int8_t *p8 = (int8_t *)p;
-
-			int8_t olds8L = 0;
-			for (int32_t i = 0; i < length; i++)
-			{
-				const int8_t news8 = p8[i] + olds8L;
-				p8[i] = news8;
-				olds8L = news8;
-			}
-		}
+			smpKernels->deltaDecode16((int16_t *)dst, src, length);
+		else
+			smpKernels->deltaDecode8(dst, src, length);
 	}
 }
 
+void delta2Samp(int8_t *p, int32_t length, uint8_t smpFlags)
+{
+	delta2SampFrom(p, p, length, smpFlags);
+}
+
 void samp2Delta(int8_t *p, int32_t length, uint8_t smpFlags)
 {
 	if (smpFlags & SAMPLE_16BIT)
-	{
-		int16_t *p16 = (int16_t *)p;
-
-		int16_t newS16 = 0;
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int16_t oldS16 = p16[i];
-			p16[i] -= newS16;
-			newS16 = oldS16;
-		}
-	}
-	else // 8-bit
-	{
-		int8_t *p8 = (int8_t *)p;
-
-		int8_t newS8 = 0;
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int8_t oldS8 = p8[i];
-			p8[i] -= newS8;
-			newS8 = oldS8;
-		}
-	}
+		smpKernels->deltaEncode16((int16_t *)p, length);
+	else
+		smpKernels->deltaEncode8(p, length);
 }
 
 bool allocateInstr(int16_t insNum)
@@ -2753,44 +2685,26 @@ void conv8BitSample(int8_t *p, int32_t length, bool stereo) // changes sample si
 	if (stereo)
 	{
 		length >>= 1;
-
-		int8_t *p2 = &p[length];
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int8_t l = p[i] ^ 0x80;
-			const int8_t r = p2[i] ^ 0x80;
-
-			p[i] = (int8_t)((l + r) >> 1);
-		}
+		smpKernels->flipSignStereo8(p, p, &p[length], length);
 	}
 	else
 	{
-		for (int32_t i = 0; i < length; i++)
-			p[i] ^= 0x80;
+		smpKernels->flipSign8(p, length);
 	}
 }
 
 void conv16BitSample(int8_t *p, int32_t length, bool stereo) // changes sample sign
 {
-	int16_t *p16_1 = (int16_t *)p;
+	int16_t *p16 = (int16_t *)p;
 
 	if (stereo)
 	{
 		length >>= 1;
-
-		int16_t *p16_2 = (int16_t *)p + length;
-		for (int32_t i = 0; i < length; i++)
-		{
-			const int16_t l = p16_1[i] ^ 0x8000;
-			const int16_t r = p16_2[i] ^ 0x8000;
-
-			p16_1[i] = (int16_t)((l + r) >> 1);
-		}
+		smpKernels->flipSignStereo16(p16, p16, &p16[length], length);
 	}
 	else
 	{
-		for (int32_t i = 0; i < length; i++)
-			p16_1[i] ^= 0x8000;
+		smpKernels->flipSign16(p16, length);
 	}
 }
 
@@ -2920,7 +2834,7 @@ void stopPlaying(void)
 	}
 	else
 	{
-		for (uint8_t i = 0; i < MAX_CHANNELS; i++)
+		for (int32_t i = 0; i < MAX_CHANNELS; i++)
 			playTone(i, 0, NOTE_OFF, -1, 0, 0);
 	}
 
@@ -3313,48 +3227,32 @@ void setSyncedReplayerVars(void)
 
 	// handle channel sync queue
 
-	while (chQueueClearing);
 	while (chQueueReadSize() > 0)
 	{
 		if (frameTime64 < getChQueueTimestamp())
 			break; // we have no more stuff to render for now
 
-		chSyncEntry = chQueuePeek();
+		chSyncEntry = chQueuePop(scopeUpdateStatus);
 		if (chSyncEntry == NULL)
 			break;
-
-		for (int32_t i = 0; i < song.numChannels; i++)
-			scopeUpdateStatus[i] |= chSyncEntry->channels[i].status; // yes, OR the status
-
-		if (!chQueuePop())
-			break;
 	}
 
-	/* Extra validation because of possible issues when the buffer is full
-	** and positions are being reset, which is not entirely thread safe.
-	*/
+	// extra validation, in case an entry that was never written was read
 	if (chSyncEntry != NULL && chSyncEntry->timestamp == 0)
 		chSyncEntry = NULL;
 
 	// handle pattern sync queue
 
-	while (pattQueueClearing);
 	while (pattQueueReadSize() > 0)
 	{
 		if (frameTime64 < getPattQueueTimestamp())
 			break; // we have no more stuff to render for now
 
-		pattSyncEntry = pattQueuePeek();
+		pattSyncEntry = pattQueuePop();
 		if (pattSyncEntry == NULL)
 			break;
-
-		if (!pattQueuePop())
-			break;
 	}
 
-	/* Extra validation because of possible issues when the buffer is full
-	** and positions are being reset, which is not entirely thread safe.
-	*/
 	if (pattSyncEntry != NULL && pattSyncEntry->timestamp == 0)
 		pattSyncEntry = NULL;
 
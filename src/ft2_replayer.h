@@ -39,11 +39,24 @@ enum
 	CURSOR_EFX2 = 7
 };
 
+/* Max. number of channels (FT2: 32). It can be raised at build time (FT2_MAX_CHANNELS in CMakeLists.txt).
+** Patterns always have room for MAX_CHANNELS channels. Only the first 32 channels get scopes, and
+** songs with more than 32 channels can't be saved as MOD.
+*/
+#ifndef MAX_CHANNELS
+#define MAX_CHANNELS 32
+#endif
+
+#if MAX_CHANNELS < 32 || MAX_CHANNELS > 256 || (MAX_CHANNELS & 1)
+#error "MAX_CHANNELS must be an even number from 32 to 256"
+#endif
+
+#define MAX_SCOPES 32 // the scope area has room for two rows of 16 scopes
+
 // do not touch these!
 #define MIN_BPM 32
 #define MAX_BPM 255
 #define MAX_SPEED 31
-#define MAX_CHANNELS 32
 #define TRACK_WIDTH (5 * MAX_CHANNELS)
 #define C4_FREQ 8363
 #define NOTE_C4 (4*12)
@@ -325,6 +338,7 @@ void keyOff(channel_t *ch);
 void conv8BitSample(int8_t *p, int32_t length, bool stereo); // changes sample sign
 void conv16BitSample(int8_t *p, int32_t length, bool stereo); // changes sample sign
 void delta2Samp(int8_t *p, int32_t length, uint8_t smpFlags);
+void delta2SampFrom(int8_t *dst, const int8_t *src, int32_t length, uint8_t smpFlags);
 void samp2Delta(int8_t *p, int32_t length, uint8_t smpFlags);
 void setPatternLen(uint16_t pattNum, int16_t numRows);
 void setLinearPeriods(bool linearPeriodsFlag);
@@ -46,6 +46,20 @@ static double dScrPosScaled, dPos2ScrMul, dScr2SmpPosMul;
 static sample_t smpCopySample;
 static SDL_Thread *thread;
 
+// sample data replaced by replaceSample() that voices/scopes may still be playing
+#define MAX_RETIRED_SMP_DATA 16
+
+typedef struct retiredSmpData_t
+{
+	int8_t *origDataPtr, *dataPtr;
+	int8_t leftEdgeTapSamples8[32];
+	int16_t leftEdgeTapSamples16[32];
+} retiredSmpData_t;
+
+static volatile int32_t numRetiredSmpData;
+static SDL_SpinLock retiredSmpDataLock;
+static retiredSmpData_t retiredSmpData[MAX_RETIRED_SMP_DATA];
+
 // globals
 int32_t smpEd_Rx1 = 0, smpEd_Rx2 = 0;
 
@@ -148,6 +162,111 @@ void freeSmpData(sample_t *s)
 	s->isFixed = false;
 }
 
+// copies 'length' sample points from 'offset' as they were before fixSample() (the sample itself is not touched)
+void copyUnfixedSmpData(const sample_t *s, int8_t *dst, int32_t offset, int32_t length)
+{
+	if (length <= 0)
+		return;
+
+	const bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
+	memcpy(dst, &s->dataPtr[offset << sample16Bit], length << sample16Bit);
+
+	if (!s->isFixed)
+		return;
+
+	// put back the sample points that fixSample() replaced after the loop end
+	for (int32_t i = 0; i < MAX_RIGHT_TAPS; i++)
+	{
+		const int32_t pos = (s->fixedPos + i) - offset;
+		if (pos < 0 || pos >= length)
+			continue;
+
+		if (sample16Bit)
+			((int16_t *)dst)[pos] = s->fixedSmp[i];
+		else
+			dst[pos] = (int8_t)s->fixedSmp[i];
+	}
+}
+
+static bool retireSmpData(sample_t *s) // audio thread must be locked
+{
+	bool retired = false;
+
+	SDL_AtomicLock(&retiredSmpDataLock);
+
+	retiredSmpData_t *r = retiredSmpData;
+	for (int32_t i = 0; i < MAX_RETIRED_SMP_DATA; i++, r++)
+	{
+		if (r->origDataPtr != NULL)
+			continue;
+
+		r->origDataPtr = s->origDataPtr;
+		r->dataPtr = s->dataPtr;
+		memcpy(r->leftEdgeTapSamples8, s->leftEdgeTapSamples8, sizeof (r->leftEdgeTapSamples8));
+		memcpy(r->leftEdgeTapSamples16, s->leftEdgeTapSamples16, sizeof (r->leftEdgeTapSamples16));
+		moveVoiceLeftEdgeTaps(s, r->leftEdgeTapSamples8, r->leftEdgeTapSamples16);
+
+		numRetiredSmpData++;
+		retired = true;
+		break;
+	}
+
+	SDL_AtomicUnlock(&retiredSmpDataLock);
+	return retired;
+}
+
+/* Replaces sample 's' (header and data) with 'newSmp', without pausing the audio. 'newSmp' must
+** have its own (fixed) sample data, built while the old data was still playing.
+**
+** The audio thread is only locked for the swap itself. Voices that are playing the old data keep
+** playing it until they stop or get retriggered, new notes use the new data from the next replayer
+** tick on. The old data is freed by freeRetiredSmpData() once nothing is playing it anymore.
+*/
+void replaceSample(sample_t *s, const sample_t *newSmp)
+{
+	lockAudioThreads(); // not lockAudio(), this can run on a sample editing thread
+
+	if (s->origDataPtr != NULL && !retireSmpData(s))
+	{
+		// too much retired data, stop all voices and free it right away (like pauseAudio() would)
+		stopVoices();
+		freeSmpData(s);
+	}
+
+	memcpy(s, newSmp, sizeof (sample_t));
+
+	unlockAudioThreads();
+}
+
+// called every frame from the main thread (it also draws the sample data), or on exit with 'freeAll' set
+void freeRetiredSmpData(bool freeAll)
+{
+	if (numRetiredSmpData == 0)
+		return;
+
+	lockAudioThreads(); // not lockAudio(), replaceSample() can run on another thread at the same time
+
+	SDL_AtomicLock(&retiredSmpDataLock);
+
+	retiredSmpData_t *r = retiredSmpData;
+	for (int32_t i = 0; i < MAX_RETIRED_SMP_DATA; i++, r++)
+	{
+		if (r->origDataPtr == NULL)
+			continue;
+
+		if (!freeAll && (isSmpDataUsedByVoices(r->dataPtr) || isSmpDataUsedByScopes(r->dataPtr)))
+			continue;
+
+		free(r->origDataPtr);
+		r->origDataPtr = r->dataPtr = NULL;
+		numRetiredSmpData--;
+	}
+
+	SDL_AtomicUnlock(&retiredSmpDataLock);
+
+	unlockAudioThreads();
+}
+
 bool cloneSample(sample_t *src, sample_t *dst)
 {
 	smpPtr_t sp;
@@ -795,6 +914,7 @@ static void writeRange(void)
 	assert(start+rangeLen <= SCREEN_W);
 
 	uint32_t *ptr32 = &video.frameBuffer[(174 * SCREEN_W) + start];
+	markDirtyRect(start, 174, rangeLen, SAMPLE_AREA_HEIGHT);
 	for (int32_t y = 0; y < SAMPLE_AREA_HEIGHT; y++)
 	{
 		for (int32_t x = 0; x < rangeLen; x++)
@@ -854,6 +974,7 @@ void sampleLine(int32_t x1, int32_t x2, int32_t y1, int32_t y2)
 	const uint32_t pixVal = video.palette[PAL_PATTEXT];
 	const int32_t pitch = sy * SCREEN_W;
 	uint32_t *dst32 = &video.frameBuffer[(y * SCREEN_W) + x];
+	markDirtyRect(MIN(x1, x2), MIN(y1, y2), (ax >> 1) + 1, (ay >> 1) + 1);
 
 	// draw line
 	if (ax > ay)
@@ -1185,17 +1306,10 @@ static void getSpecialMinMax8(sample_t *s, int32_t index, int32_t scanEnd, int8_
 	*max8 = maxVal;
 }
 
-static void getSampleDataPeak(sample_t *s, int32_t index, int32_t length, int16_t *outMin, int16_t *outMax)
+// gets the min/max of the sample data (8-bit samples are scaled to 16-bit), skips the fixSample() samples
+static void scanSampleMinMax(sample_t *s, int32_t index, int32_t length, int16_t *min16, int16_t *max16)
 {
 	int8_t min8, max8;
-	int16_t min16, max16;
-
-	if (length == 0 || s->dataPtr == NULL || s->length <= 0)
-	{
-		*outMin = SAMPLE_AREA_Y_CENTER;
-		*outMax = SAMPLE_AREA_Y_CENTER;
-		return;
-	}
 
 	if (s->isFixed && s->length > s->loopLength+s->loopStart)
 	{
@@ -1209,15 +1323,13 @@ static void getSampleDataPeak(sample_t *s, int32_t index, int32_t length, int16_
 		{
 			if (s->flags & SAMPLE_16BIT)
 			{
-				getSpecialMinMax16(s, index, scanEnd, &min16, &max16);
-				*outMin = SAMPLE_AREA_Y_CENTER - ((min16 * SAMPLE_AREA_HEIGHT) >> 16);
-				*outMax = SAMPLE_AREA_Y_CENTER - ((max16 * SAMPLE_AREA_HEIGHT) >> 16);
+				getSpecialMinMax16(s, index, scanEnd, min16, max16);
 			}
 			else // 8-bit
 			{
 				getSpecialMinMax8(s, index, scanEnd, &min8, &max8);
-				*outMin = SAMPLE_AREA_Y_CENTER - ((min8 * SAMPLE_AREA_HEIGHT) >> 8);
-				*outMax = SAMPLE_AREA_Y_CENTER - ((max8 * SAMPLE_AREA_HEIGHT) >> 8);
+				*min16 = min8 << 8;
+				*max16 = max8 << 8;
 			}
 
 			return;
@@ -1227,22 +1339,287 @@ static void getSampleDataPeak(sample_t *s, int32_t index, int32_t length, int16_
 	if (s->flags & SAMPLE_16BIT)
 	{
 		const int16_t *smpPtr16 = (int16_t *)s->dataPtr;
-		getMinMax16(&smpPtr16[index], length, &min16, &max16);
-		*outMin = SAMPLE_AREA_Y_CENTER - ((min16 * SAMPLE_AREA_HEIGHT) >> 16);
-		*outMax = SAMPLE_AREA_Y_CENTER - ((max16 * SAMPLE_AREA_HEIGHT) >> 16);
+		getMinMax16(&smpPtr16[index], length, min16, max16);
 	}
 	else // 8-bit
 	{
 		getMinMax8(&s->dataPtr[index], length, &min8, &max8);
-		*outMin = SAMPLE_AREA_Y_CENTER - ((min8 * SAMPLE_AREA_HEIGHT) >> 8);
-		*outMax = SAMPLE_AREA_Y_CENTER - ((max8 * SAMPLE_AREA_HEIGHT) >> 8);
+		*min16 = min8 << 8;
+		*max16 = max8 << 8;
 	}
 }
 
+/* Min/max summary of the sample shown in the sample editor, so that zoomed out views of long
+** samples don't have to scan all of the sample data on every redraw. Level 0 has the min/max
+** of every SMP_PEAKS_BLOCK_LEN sample points, and each level above it has the min/max of two
+** entries in the level below. A screen column then needs about two entries per level, plus a
+** scan of the partial blocks at its edges.
+**
+** It's built a bit every frame (see handleSamplerRedrawing()), and the sample data is scanned
+** directly until it's done. writeSample(true) throws it away (the sample data may have been
+** changed), hand-drawing only updates the blocks that were drawn over.
+*/
+
+#define SMP_PEAKS_BLOCK_BITS 8
+#define SMP_PEAKS_BLOCK_LEN (1 << SMP_PEAKS_BLOCK_BITS)
+#define SMP_PEAKS_MIN_LENGTH (1 << 18) // shorter samples are always scanned directly
+#define SMP_PEAKS_BUILD_LEN (1 << 22) // sample points to summarize per frame
+#define SMP_PEAKS_MAX_LEVELS (31 - SMP_PEAKS_BLOCK_BITS + 1)
+
+typedef struct smpPeak_t
+{
+	int16_t min, max;
+} smpPeak_t;
+
+static struct
+{
+	// the sample the summary is for
+	const sample_t *s;
+	const int8_t *dataPtr;
+	int32_t length;
+	bool sample16Bit;
+
+	bool ready; // all levels are built
+	int32_t numLevels, builtBlocks, dataLength;
+	int32_t levelLength[SMP_PEAKS_MAX_LEVELS];
+	smpPeak_t *level[SMP_PEAKS_MAX_LEVELS], *data; // levels point into 'data'
+} smpPeaks;
+
+static bool smpPeaksMatch(const sample_t *s)
+{
+	return smpPeaks.s == s && smpPeaks.dataPtr == s->dataPtr && smpPeaks.length == s->length &&
+	       smpPeaks.sample16Bit == !!(s->flags & SAMPLE_16BIT);
+}
+
+static void clearSmpPeaks(void)
+{
+	smpPeaks.s = NULL;
+	smpPeaks.ready = false;
+}
+
+void freeSmpPeaks(void)
+{
+	clearSmpPeaks();
+
+	if (smpPeaks.data != NULL)
+	{
+		free(smpPeaks.data);
+		smpPeaks.data = NULL;
+	}
+
+	smpPeaks.dataLength = 0;
+}
+
+static bool setupSmpPeaks(sample_t *s)
+{
+	clearSmpPeaks();
+
+	int32_t numEntries = 0;
+	int32_t levelLength = s->length >> SMP_PEAKS_BLOCK_BITS;
+
+	smpPeaks.numLevels = 0;
+	while (levelLength > 0)
+	{
+		smpPeaks.levelLength[smpPeaks.numLevels++] = levelLength;
+		numEntries += levelLength;
+		levelLength >>= 1;
+	}
+
+	if (numEntries > smpPeaks.dataLength)
+	{
+		freeSmpPeaks();
+
+		smpPeaks.data = (smpPeak_t *)malloc(numEntries * sizeof (smpPeak_t));
+		if (smpPeaks.data == NULL)
+			return false; // not a problem, the sample data is scanned directly instead
+
+		smpPeaks.dataLength = numEntries;
+	}
+
+	smpPeak_t *ptr = smpPeaks.data;
+	for (int32_t i = 0; i < smpPeaks.numLevels; i++)
+	{
+		smpPeaks.level[i] = ptr;
+		ptr += smpPeaks.levelLength[i];
+	}
+
+	smpPeaks.s = s;
+	smpPeaks.dataPtr = s->dataPtr;
+	smpPeaks.length = s->length;
+	smpPeaks.sample16Bit = !!(s->flags & SAMPLE_16BIT);
+	smpPeaks.builtBlocks = 0;
+
+	return true;
+}
+
+static void setSmpPeaksBlock(sample_t *s, int32_t block)
+{
+	smpPeak_t *p = &smpPeaks.level[0][block];
+	scanSampleMinMax(s, block << SMP_PEAKS_BLOCK_BITS, SMP_PEAKS_BLOCK_LEN, &p->min, &p->max);
+}
+
+static void setSmpPeaksEntry(int32_t level, int32_t entry)
+{
+	const smpPeak_t *src = &smpPeaks.level[level-1][entry << 1];
+	smpPeak_t *dst = &smpPeaks.level[level][entry];
+
+	dst->min = (src[0].min < src[1].min) ? src[0].min : src[1].min;
+	dst->max = (src[0].max > src[1].max) ? src[0].max : src[1].max;
+}
+
+// builds the summary of the current sample, SMP_PEAKS_BUILD_LEN sample points per call
+static void buildSmpPeaks(void)
+{
+	if (editor.busy) // the sample data may be changed by another thread
+		return;
+
+	sample_t *s = getCurSample();
+	if (s == NULL || s->dataPtr == NULL || s->length < SMP_PEAKS_MIN_LENGTH)
+		return;
+
+	if (!smpPeaksMatch(s) && !setupSmpPeaks(s))
+		return;
+
+	if (smpPeaks.ready)
+		return;
+
+	int32_t endBlock = smpPeaks.builtBlocks + (SMP_PEAKS_BUILD_LEN >> SMP_PEAKS_BLOCK_BITS);
+	if (endBlock > smpPeaks.levelLength[0])
+		endBlock = smpPeaks.levelLength[0];
+
+	for (int32_t i = smpPeaks.builtBlocks; i < endBlock; i++)
+		setSmpPeaksBlock(s, i);
+
+	smpPeaks.builtBlocks = endBlock;
+	if (smpPeaks.builtBlocks < smpPeaks.levelLength[0])
+		return;
+
+	// level 0 is done, the rest is quick
+	for (int32_t i = 1; i < smpPeaks.numLevels; i++)
+	{
+		for (int32_t j = 0; j < smpPeaks.levelLength[i]; j++)
+			setSmpPeaksEntry(i, j);
+	}
+
+	smpPeaks.ready = true;
+}
+
+// the sample data in this range was changed (f.ex. by hand-drawing)
+static void updateSmpPeaks(sample_t *s, int32_t index, int32_t length)
+{
+	if (length <= 0 || !smpPeaksMatch(s))
+		return;
+
+	int32_t first = index >> SMP_PEAKS_BLOCK_BITS;
+	int32_t last = (index + length - 1) >> SMP_PEAKS_BLOCK_BITS;
+
+	// blocks that aren't built yet will get the new data anyway
+	if (last > smpPeaks.builtBlocks-1)
+		last = smpPeaks.builtBlocks-1;
+
+	for (int32_t i = first; i <= last; i++)
+		setSmpPeaksBlock(s, i);
+
+	if (!smpPeaks.ready)
+		return; // the levels above 0 are built when level 0 is done
+
+	for (int32_t i = 1; i < smpPeaks.numLevels; i++)
+	{
+		first >>= 1;
+		last >>= 1;
+
+		if (last > smpPeaks.levelLength[i]-1)
+			last = smpPeaks.levelLength[i]-1;
+
+		for (int32_t j = first; j <= last; j++)
+			setSmpPeaksEntry(i, j);
+	}
+}
+
+// returns false if there's no summary of this sample (or if the range is too short to use it)
+static bool getSmpPeaksMinMax(sample_t *s, int32_t index, int32_t length, int16_t *min16, int16_t *max16)
+{
+	int16_t edgeMin, edgeMax;
+
+	if (!smpPeaks.ready || !smpPeaksMatch(s))
+		return false;
+
+	const int32_t end = index + length;
+	int32_t first = (index + (SMP_PEAKS_BLOCK_LEN-1)) >> SMP_PEAKS_BLOCK_BITS; // first whole block
+	int32_t last = end >> SMP_PEAKS_BLOCK_BITS; // block after the last whole block
+
+	if (last-first < 2)
+		return false;
+
+	int16_t minVal =  32767;
+	int16_t maxVal = -32768;
+
+	// partial blocks at the edges
+	const int32_t firstPos = first << SMP_PEAKS_BLOCK_BITS;
+	const int32_t lastPos = last << SMP_PEAKS_BLOCK_BITS;
+
+	if (index < firstPos)
+		scanSampleMinMax(s, index, firstPos-index, &minVal, &maxVal);
+
+	if (end > lastPos)
+	{
+		scanSampleMinMax(s, lastPos, end-lastPos, &edgeMin, &edgeMax);
+		if (edgeMin < minVal) minVal = edgeMin;
+		if (edgeMax > maxVal) maxVal = edgeMax;
+	}
+
+	// whole blocks, use the largest entries that fit in the range
+	for (int32_t i = 0; first < last; i++)
+	{
+		const smpPeak_t *level = smpPeaks.level[i];
+
+		if (first & 1)
+		{
+			if (level[first].min < minVal) minVal = level[first].min;
+			if (level[first].max > maxVal) maxVal = level[first].max;
+			first++;
+		}
+
+		if (last & 1)
+		{
+			last--;
+			if (level[last].min < minVal) minVal = level[last].min;
+			if (level[last].max > maxVal) maxVal = level[last].max;
+		}
+
+		first >>= 1;
+		last >>= 1;
+	}
+
+	*min16 = minVal;
+	*max16 = maxVal;
+
+	return true;
+}
+
+static void getSampleDataPeak(sample_t *s, int32_t index, int32_t length, int16_t *outMin, int16_t *outMax)
+{
+	int16_t min16, max16;
+
+	if (length == 0 || s->dataPtr == NULL || s->length <= 0)
+	{
+		*outMin = SAMPLE_AREA_Y_CENTER;
+		*outMax = SAMPLE_AREA_Y_CENTER;
+		return;
+	}
+
+	if (!getSmpPeaksMinMax(s, index, length, &min16, &max16))
+		scanSampleMinMax(s, index, length, &min16, &max16);
+
+	*outMin = SAMPLE_AREA_Y_CENTER - ((min16 * SAMPLE_AREA_HEIGHT) >> 16);
+	*outMax = SAMPLE_AREA_Y_CENTER - ((max16 * SAMPLE_AREA_HEIGHT) >> 16);
+}
+
 static void writeWaveform(void)
 {
 	// clear sample data area
 	memset(&video.frameBuffer[174 * SCREEN_W], 0, SAMPLE_AREA_WIDTH * SAMPLE_AREA_HEIGHT * sizeof (int32_t));
+	markDirtyRect(0, 174, SAMPLE_AREA_WIDTH, SAMPLE_AREA_HEIGHT);
 
 	// draw center line
 	hLine(0, SAMPLE_AREA_Y_CENTER, SAMPLE_AREA_WIDTH, PAL_DESKTOP);
@@ -1315,7 +1692,7 @@ static void writeWaveform(void)
 	}
 }
 
-void writeSample(bool forceSmpRedraw)
+static void writeSampleView(bool forceSmpRedraw)
 {
 	int32_t tmpRx1, tmpRx2;
 	sample_t *s;
@@ -1415,6 +1792,19 @@ void writeSample(bool forceSmpRedraw)
 	updateSampleEditor();
 }
 
+void writeSample(bool forceSmpRedraw)
+{
+	if (forceSmpRedraw)
+		clearSmpPeaks(); // the sample data may have changed
+
+	writeSampleView(forceSmpRedraw);
+}
+
+void writeSampleKeepPeaks(void)
+{
+	writeSampleView(true);
+}
+
 static void setSampleRange(int32_t start, int32_t end)
 {
 	if (instr[editor.curInstr] == NULL)
@@ -1883,61 +2273,74 @@ void saveRange(void)
 
 static bool cutRange(bool cropMode, int32_t r1, int32_t r2)
 {
+	smpPtr_t sp;
+	sample_t newSmp;
+
 	sample_t *s = getCurSample();
 	if (s == NULL)
 		return false;
 
 	bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
 
+	/* Crop mode works on the sample directly (sampCropThread() has paused the audio), otherwise the
+	** new sample is built off to the side while the old one keeps playing (see replaceSample()).
+	*/
+	sample_t *d = cropMode ? s : &newSmp;
+
 	if (!cropMode)
 	{
 		if (editor.curInstr == 0 || s->dataPtr == NULL || s->length == 0)
 			return false;
 
-		pauseAudio();
-		unfixSample(s);
-
 		if (config.smpCutToBuffer)
 		{
 			if (!getCopyBuffer(r2-r1, sample16Bit))
 			{
-				fixSample(s);
-				resumeAudio();
-
 				okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
 				return false;
 			}
 
-			memcpy(smpCopyBuff, &s->dataPtr[r1 << sample16Bit], (r2-r1) << sample16Bit);
+			copyUnfixedSmpData(s, smpCopyBuff, r1, r2-r1);
 			smpCopyBits = sample16Bit ? 16 : 8;
 		}
-	}
 
-	memmove(&s->dataPtr[r1 << sample16Bit], &s->dataPtr[r2 << sample16Bit], (s->length-r2) << sample16Bit);
+		memcpy(&newSmp, s, sizeof (sample_t));
+	}
 
 	int32_t length = s->length - r2+r1;
 	if (length > 0)
 	{
-		if (!reallocateSmpData(s, length, sample16Bit))
+		if (cropMode)
 		{
-			freeSample(editor.curInstr, editor.curSmp);
-			editor.updateCurSmp = true;
+			memmove(&s->dataPtr[r1 << sample16Bit], &s->dataPtr[r2 << sample16Bit], (s->length-r2) << sample16Bit);
 
-			if (!cropMode)
-				resumeAudio();
+			if (!reallocateSmpData(s, length, sample16Bit))
+			{
+				freeSample(editor.curInstr, editor.curSmp);
+				editor.updateCurSmp = true;
 
-			okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
-			return false;
+				okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+				return false;
+			}
+		}
+		else
+		{
+			if (!allocateSmpDataPtr(&sp, length, sample16Bit))
+				return false;
+
+			copyUnfixedSmpData(s, sp.ptr, 0, r1);
+			copyUnfixedSmpData(s, &sp.ptr[r1 << sample16Bit], r2, s->length-r2);
+			setSmpDataPtr(d, &sp);
 		}
 
-		s->length = length;
+		d->length = length;
 
-		int32_t loopEnd = s->loopStart + s->loopLength;
-		if (s->loopStart > r1)
+		int32_t loopEnd = d->loopStart + d->loopLength;
+		if (d->loopStart > r1)
 		{
-			s->loopStart -= r2-r1;
-			if (s->loopStart < r1)
-				s->loopStart = r1;
+			d->loopStart -= r2-r1;
+			if (d->loopStart < r1)
+				d->loopStart = r1;
 		}
 
 		if (loopEnd > r1)
@@ -1947,31 +2350,43 @@ static bool cutRange(bool cropMode, int32_t r1, int32_t r2)
 				loopEnd = r1;
 		}
 
-		s->loopLength = loopEnd - s->loopStart;
-		if (s->loopLength < 0)
-			s->loopLength = 0;
+		d->loopLength = loopEnd - d->loopStart;
+		if (d->loopLength < 0)
+			d->loopLength = 0;
 
-		if (s->loopStart+s->loopLength > length)
-			s->loopLength = length - s->loopStart;
+		if (d->loopStart+d->loopLength > length)
+			d->loopLength = length - d->loopStart;
 
-		if (s->loopLength <= 0)
+		if (d->loopLength <= 0)
 		{
-			s->loopStart = 0;
-			DISABLE_LOOP(s->flags);
+			d->loopStart = 0;
+			DISABLE_LOOP(d->flags);
 		}
 
 		if (!cropMode)
-			fixSample(s);
+		{
+			fixSample(d);
+			replaceSample(s, d);
+		}
 	}
-	else
+	else if (cropMode)
 	{
 		freeSample(editor.curInstr, editor.curSmp);
 		editor.updateCurSmp = true;
 	}
+	else
+	{
+		// the whole sample was cut, replace it with an empty one (like freeSample())
+		memset(d, 0, sizeof (sample_t));
+		d->panning = 128;
+		d->volume = 64;
+
+		replaceSample(s, d);
+		editor.updateCurSmp = true;
+	}
 
 	if (!cropMode)
 	{
-		resumeAudio();
 		setSongModifiedFlag();
 
 		setMouseBusy(false);
@@ -2024,9 +2439,7 @@ static int32_t SDLCALL sampCopyThread(void *ptr)
 		return true;
 	}
 
-	unfixSample(s);
-	memcpy(smpCopyBuff, &s->dataPtr[smpEd_Rx1 << sample16Bit], (smpEd_Rx2-smpEd_Rx1) << sample16Bit);
-	fixSample(s);
+	copyUnfixedSmpData(s, smpCopyBuff, smpEd_Rx1, smpEd_Rx2-smpEd_Rx1);
 
 	setMouseBusy(false);
 
@@ -2062,48 +2475,53 @@ void sampCopy(void)
 
 static void pasteOverwrite(sample_t *s)
 {
+	smpPtr_t sp;
+	sample_t newSmp;
+
 	bool sample16Bit = (smpCopyBits == 16);
 
-	if (!reallocateSmpData(s, smpCopySize, sample16Bit))
+	if (!allocateSmpDataPtr(&sp, smpCopySize, sample16Bit))
 	{
 		okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
 		return;
 	}
 
-	pauseAudio();
+	memcpy(sp.ptr, smpCopyBuff, smpCopySize << sample16Bit);
 
-	memcpy(s->dataPtr, smpCopyBuff, smpCopySize << sample16Bit);
+	sample_t *d = &newSmp;
+	memcpy(d, s, sizeof (sample_t));
+	setSmpDataPtr(d, &sp);
 
 	if (smpCopyDidCopyWholeSample)
 	{
 		sample_t *src = &smpCopySample;
-		memcpy(s->name, src->name, 23);
-		s->length = src->length;
-		s->loopStart = src->loopStart;
-		s->loopLength = src->loopLength;
-		s->volume = src->volume;
-		s->panning = src->panning;
-		s->finetune = src->finetune;
-		s->relativeNote = src->relativeNote;
-		s->flags = src->flags;
+		memcpy(d->name, src->name, 23);
+		d->length = src->length;
+		d->loopStart = src->loopStart;
+		d->loopLength = src->loopLength;
+		d->volume = src->volume;
+		d->panning = src->panning;
+		d->finetune = src->finetune;
+		d->relativeNote = src->relativeNote;
+		d->flags = src->flags;
 	}
 	else
 	{
-		s->name[0] = '\0';
-		s->length = smpCopySize;
-		s->loopStart = 0;
-		s->loopLength = 0;
-		s->volume = 64;
-		s->panning = 128;
-		s->finetune = 0;
-		s->relativeNote = 0;
-		s->flags = (smpCopyBits == 16) ? SAMPLE_16BIT : 0;
+		d->name[0] = '\0';
+		d->length = smpCopySize;
+		d->loopStart = 0;
+		d->loopLength = 0;
+		d->volume = 64;
+		d->panning = 128;
+		d->finetune = 0;
+		d->relativeNote = 0;
+		d->flags = (smpCopyBits == 16) ? SAMPLE_16BIT : 0;
 	}
 
-	s->isFixed = false;
+	d->isFixed = false;
 
-	fixSample(s);
-	resumeAudio();
+	fixSample(d);
+	replaceSample(s, d);
 
 	editor.updateCurSmp = true;
 	setSongModifiedFlag();
@@ -2149,6 +2567,7 @@ static void pasteCopiedData(int8_t *dataPtr, int32_t offset, int32_t length, boo
 static int32_t SDLCALL sampPasteThread(void *ptr)
 {
 	smpPtr_t sp;
+	sample_t newSmp;
 
 	if (instr[editor.curInstr] == NULL && !allocateInstr(editor.curInstr))
 	{
@@ -2187,51 +2606,49 @@ static int32_t SDLCALL sampPasteThread(void *ptr)
 		return true;
 	}
 
-	pauseAudio();
-	unfixSample(s);
+	// the sample keeps playing while we build the new one (see replaceSample())
 
 	// paste left part of original sample
-	if (smpEd_Rx1 > 0)
-		memcpy(sp.ptr, s->dataPtr, smpEd_Rx1 << sample16Bit);
+	copyUnfixedSmpData(s, sp.ptr, 0, smpEd_Rx1);
 
 	// paste copied data
 	pasteCopiedData(sp.ptr, smpEd_Rx1, smpCopySize, sample16Bit);
 
 	// paste right part of original sample
-	if (smpEd_Rx2 < s->length)
-		memmove(&sp.ptr[(smpEd_Rx1+smpCopySize) << sample16Bit], &s->dataPtr[smpEd_Rx2 << sample16Bit], (s->length-smpEd_Rx2) << sample16Bit);
+	copyUnfixedSmpData(s, &sp.ptr[(smpEd_Rx1+smpCopySize) << sample16Bit], smpEd_Rx2, s->length-smpEd_Rx2);
 
-	freeSmpData(s);
-	setSmpDataPtr(s, &sp);
+	sample_t *d = &newSmp;
+	memcpy(d, s, sizeof (sample_t));
+	setSmpDataPtr(d, &sp);
 
 	// adjust loop points if necessary
 	if (smpEd_Rx2-smpEd_Rx1 != smpCopySize)
 	{
 		int32_t loopAdjust = smpCopySize - (smpEd_Rx1 - smpEd_Rx2);
 
-		if (s->loopStart > smpEd_Rx2)
+		if (d->loopStart > smpEd_Rx2)
 		{
-			s->loopStart += loopAdjust;
-			s->loopLength -= loopAdjust;
+			d->loopStart += loopAdjust;
+			d->loopLength -= loopAdjust;
 		}
 
-		if (s->loopStart+s->loopLength > smpEd_Rx2)
-			s->loopLength += loopAdjust;
+		if (d->loopStart+d->loopLength > smpEd_Rx2)
+			d->loopLength += loopAdjust;
 
-		if (s->loopStart > newLength)
+		if (d->loopStart > newLength)
 		{
-			s->loopStart = 0;
-			s->loopLength = 0;
+			d->loopStart = 0;
+			d->loopLength = 0;
 		}
 
-		if (s->loopStart+s->loopLength > newLength)
-			s->loopLength = newLength - s->loopStart;
+		if (d->loopStart+d->loopLength > newLength)
+			d->loopLength = newLength - d->loopStart;
 	}
 
-	s->length = newLength;
+	d->length = newLength;
 
-	fixSample(s);
-	resumeAudio();
+	fixSample(d);
+	replaceSample(s, d);
 
 	setSongModifiedFlag();
 	setMouseBusy(false);
@@ -2590,7 +3007,7 @@ void rbSampleNoLoop(void)
 	unlockMixerCallback();
 
 	updateSampleEditor();
-	writeSample(true);
+	writeSampleKeepPeaks();
 	setSongModifiedFlag();
 }
 
@@ -2616,7 +3033,7 @@ void rbSampleForwardLoop(void)
 	unlockMixerCallback();
 
 	updateSampleEditor();
-	writeSample(true);
+	writeSampleKeepPeaks();
 	setSongModifiedFlag();
 }
 
@@ -2642,7 +3059,7 @@ void rbSamplePingpongLoop(void)
 	unlockMixerCallback();
 
 	updateSampleEditor();
-	writeSample(true);
+	writeSampleKeepPeaks();
 	setSongModifiedFlag();
 }
 
@@ -3044,6 +3461,7 @@ static void invertSamplePosLine(int32_t x)
 		return;
 
 	uint32_t *ptr32 = &video.frameBuffer[(174 * SCREEN_W) + x];
+	markDirtyRect(x, 174, 1, SAMPLE_AREA_HEIGHT);
 	for (int32_t y = 0; y < SAMPLE_AREA_HEIGHT; y++, ptr32 += SCREEN_W)
 		*ptr32 = video.palette[(*ptr32 >> 24) ^ 1]; // ">> 24" to get palette, XOR 1 to switch between normal/inverted mode
 }
@@ -3111,6 +3529,7 @@ void handleSamplerRedrawing(void)
 	}
 
 	writeSamplePosLine();
+	buildSmpPeaks();
 }
 
 static void setLeftLoopPinPos(int32_t x)
@@ -3325,7 +3744,8 @@ static void editSampleData(bool mouseButtonHeld)
 	lastDrawY = rvl;
 	lastDrawX = r;
 
-	writeSample(true);
+	updateSmpPeaks(s, start, end-start);
+	writeSampleKeepPeaks();
 }
 
 void handleSampleDataMouseDown(bool mouseButtonHeld)
@@ -3862,7 +4282,7 @@ void testSmpEdMouseUp(void) // used for setting new loop points
 			unlockMixerCallback();
 
 			setSongModifiedFlag();
-			writeSample(true);
+			writeSampleKeepPeaks();
 		}
 	}
 }
@@ -19,6 +19,11 @@ void setSmpDataPtr(sample_t *s, smpPtr_t *sp);
 void freeSmpDataPtr(smpPtr_t *sp);
 void freeSmpData(sample_t *s);
 
+// for long sample operations, instead of pauseAudio() (see ft2_sample_ed.c)
+void copyUnfixedSmpData(const sample_t *s, int8_t *dst, int32_t offset, int32_t length);
+void replaceSample(sample_t *s, const sample_t *newSmp);
+void freeRetiredSmpData(bool freeAll);
+
 bool cloneSample(sample_t *src, sample_t *dst);
 sample_t *getCurSample(void);
 void sanitizeSample(sample_t *s);
@@ -64,7 +69,9 @@ void sampReplenUp(void);
 void sampReplenDown(void);
 double getSampleValue(int8_t *smpData, int32_t position, bool sample16Bit);
 void putSampleValue(int8_t *smpData, int32_t position, double dSample, bool sample16Bit);
-void writeSample(bool forceSmpRedraw);
+void writeSample(bool forceSmpRedraw); // forceSmpRedraw = sample data may have changed
+void writeSampleKeepPeaks(void); // like writeSample(true), for when the sample data has not changed
+void freeSmpPeaks(void);
 void handleSampleDataMouseDown(bool mouseButtonHeld);
 void updateSampleEditorSample(void);
 void updateSampleEditor(void);
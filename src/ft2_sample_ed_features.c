@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <math.h>
 #include "ft2_header.h"
 #include "ft2_mouse.h"
@@ -25,11 +26,25 @@
 #include "ft2_keyboard.h"
 #include "ft2_tables.h"
 #include "ft2_structs.h"
+#include "ft2_parallel.h"
+#include "mixer/ft2_windowed_sinc.h"
+
+#define RESAMPLE_BLOCK_LEN 32768 // output sample points per resampling job
+#define RESAMPLE_SINC_WIDTH 16 // fKaiserSinc_16
+
+typedef struct resampleJob_t
+{
+	const float *fSrc; // has padding on both sides, see getPaddedSmpData()
+	int8_t *dst;
+	bool sample16Bit;
+	int32_t dstLength;
+	double dStep; // source sample points per output sample point
+} resampleJob_t;
 
 static volatile bool stopThread;
 
 static int8_t smpEd_RelReSmp, mix_Balance = 50;
-static bool echo_AddMemory, exitFlag, outOfMemory;
+static bool echo_AddMemory, resample_Sinc = true, exitFlag, outOfMemory;
 static int16_t echo_nEcho = 1, echo_VolChange = 30;
 static int32_t echo_Distance = 0x100;
 static double dVol_StartVol = 100.0, dVol_EndVol = 100.0;
@@ -62,6 +77,20 @@ static void windowClose(bool rewriteSample)
 	mouseAnimOff();
 }
 
+// returns NULL if out of memory or if the sample is empty, free() it after use
+static int8_t *cloneUnfixedSmpData(const sample_t *s)
+{
+	if (s->dataPtr == NULL || s->length <= 0)
+		return NULL;
+
+	int8_t *p = (int8_t *)malloc(s->length << !!(s->flags & SAMPLE_16BIT));
+	if (p == NULL)
+		return NULL;
+
+	copyUnfixedSmpData(s, p, 0, s->length);
+	return p;
+}
+
 static void sbSetResampleTones(uint32_t pos)
 {
 	if (smpEd_RelReSmp != (int8_t)(pos - 36))
@@ -80,9 +109,189 @@ static void pbResampleTonesUp(void)
 		smpEd_RelReSmp++;
 }
 
+/* Returns the unfixed sample data as floats, with 'pad' extra points on both sides (NULL if out of
+** memory). The left side holds the first point, the right side continues a forward loop that ends
+** at the sample end, or holds the last point.
+*/
+static float *getPaddedSmpData(const sample_t *s, int32_t pad)
+{
+	const int32_t length = s->length;
+
+	float *fDst = (float *)malloc((size_t)(length + (pad * 2)) * sizeof (float));
+	if (fDst == NULL)
+		return NULL;
+
+	int8_t *src = cloneUnfixedSmpData(s);
+	if (src == NULL)
+	{
+		free(fDst);
+		return NULL;
+	}
+
+	float *fSmp = fDst + pad;
+	if (s->flags & SAMPLE_16BIT)
+	{
+		const int16_t *src16 = (const int16_t *)src;
+		for (int32_t i = 0; i < length; i++)
+			fSmp[i] = src16[i];
+	}
+	else
+	{
+		for (int32_t i = 0; i < length; i++)
+			fSmp[i] = src[i];
+	}
+
+	free(src);
+
+	for (int32_t i = 1; i <= pad; i++)
+		fSmp[-i] = fSmp[0];
+
+	const bool loopToEnd = (GET_LOOPTYPE(s->flags) == LOOP_FWD) && s->loopLength > 0 && s->loopStart+s->loopLength == length;
+	for (int32_t i = 0; i < pad; i++)
+		fSmp[length+i] = loopToEnd ? fSmp[s->loopStart + (i % s->loopLength)] : fSmp[length-1];
+
+	return fDst;
+}
+
+/* Polyphase windowed-sinc resampling of one block of output points, using the 16-point Kaiser
+** table of the mixer. When downsampling, the kernel is stretched by the step (more taps) so that
+** its cutoff follows the new Nyquist frequency. Each point is divided by the sum of its weights,
+** so the DC gain is exactly 1.
+*/
+static void resampleBlockJob(void *userData, int32_t jobIndex)
+{
+	const resampleJob_t *job = (const resampleJob_t *)userData;
+
+	const int32_t start = jobIndex * RESAMPLE_BLOCK_LEN;
+	int32_t end = start + RESAMPLE_BLOCK_LEN;
+	if (end > job->dstLength)
+		end = job->dstLength;
+
+	const double dScale = (job->dStep > 1.0) ? job->dStep : 1.0;
+	const double dInvScale = 1.0 / dScale;
+	const double dHalfWidth = (RESAMPLE_SINC_WIDTH / 2) * dScale;
+	const float *fSrc = job->fSrc;
+
+	for (int32_t i = start; i < end; i++)
+	{
+		const double dPos = i * job->dStep;
+		double dSum = 0.0, dWeightSum = 0.0;
+
+		if (dScale == 1.0) // upsampling, all taps have the same phase
+		{
+			const int32_t pos = (int32_t)dPos;
+			const int32_t phase = (int32_t)((dPos - pos) * SINC_PHASES);
+			const float *fTaps = &fKaiserSinc_16[phase * RESAMPLE_SINC_WIDTH];
+			const float *fSmp = &fSrc[pos - ((RESAMPLE_SINC_WIDTH / 2) - 1)];
+
+			float fSum = 0.0f, fWeightSum = 0.0f; // 16 taps, float precision is plenty
+			for (int32_t j = 0; j < RESAMPLE_SINC_WIDTH; j++)
+			{
+				fSum += fSmp[j] * fTaps[j];
+				fWeightSum += fTaps[j];
+			}
+
+			dSum = fSum;
+			dWeightSum = fWeightSum;
+		}
+		else
+		{
+			const int32_t first = (int32_t)floor(dPos - dHalfWidth) + 1;
+			const int32_t last = (int32_t)floor(dPos + dHalfWidth);
+
+			/* Distance from dPos to each tap (-8.0 .. 8.0 after scaling), offset by +8.0 and in
+			** table phases, so that the integer part is the tap and the fraction is the phase.
+			*/
+			double dDist = ((((dPos - first) * dInvScale) + (RESAMPLE_SINC_WIDTH / 2)) * SINC_PHASES);
+			if (dDist > (RESAMPLE_SINC_WIDTH * SINC_PHASES) - 1)
+				dDist = (RESAMPLE_SINC_WIDTH * SINC_PHASES) - 1;
+
+			const double dDistDelta = dInvScale * SINC_PHASES;
+			for (int32_t k = first; k <= last; k++, dDist -= dDistDelta)
+			{
+				const int32_t dist = (int32_t)dDist; // truncation, dDist is >= 0.0 (or very close to it)
+				const int32_t tap = (RESAMPLE_SINC_WIDTH - 1) - (dist >> SINC_PHASES_BITS);
+				const int32_t phase = dist & (SINC_PHASES - 1);
+
+				const float fWeight = fKaiserSinc_16[(phase * RESAMPLE_SINC_WIDTH) + tap];
+				dSum += fSrc[k] * fWeight;
+				dWeightSum += fWeight;
+			}
+		}
+
+		double dOut = (dWeightSum != 0.0) ? (dSum / dWeightSum) : 0.0;
+		DROUND(dOut);
+
+		int32_t smp32 = (int32_t)dOut;
+		if (job->sample16Bit)
+		{
+			CLAMP16(smp32);
+			((int16_t *)job->dst)[i] = (int16_t)smp32;
+		}
+		else
+		{
+			CLAMP8(smp32);
+			job->dst[i] = (int8_t)smp32;
+		}
+	}
+}
+
+static bool resampleSinc(const sample_t *s, int8_t *dst, int32_t dstLength, double dStep)
+{
+	resampleJob_t job;
+
+	// enough room for all taps of the first and last output points
+	const int32_t pad = (int32_t)ceil((RESAMPLE_SINC_WIDTH / 2) * ((dStep > 1.0) ? dStep : 1.0)) + 1;
+
+	float *fPadded = getPaddedSmpData(s, pad);
+	if (fPadded == NULL)
+		return false;
+
+	job.fSrc = fPadded + pad;
+	job.dst = dst;
+	job.sample16Bit = !!(s->flags & SAMPLE_16BIT);
+	job.dstLength = dstLength;
+	job.dStep = dStep;
+
+	runParallelJobs(resampleBlockJob, &job, (dstLength + (RESAMPLE_BLOCK_LEN-1)) / RESAMPLE_BLOCK_LEN);
+
+	free(fPadded);
+	return true;
+}
+
+static void resampleNearest(const int8_t *src, int8_t *dst, uint32_t dstLength, double dRatio, bool sample16Bit)
+{
+	// 32.32 fixed-point logic
+	const uint64_t delta64 = (const uint64_t)round((UINT32_MAX+1.0) / dRatio);
+	uint64_t posFrac64 = 0;
+
+	if (sample16Bit)
+	{
+		const int16_t *src16 = (const int16_t *)src;
+		int16_t *dst16 = (int16_t *)dst;
+
+		for (uint32_t i = 0; i < dstLength; i++)
+		{
+			const uint32_t position = posFrac64 >> 32;
+			dst16[i] = src16[position];
+			posFrac64 += delta64;
+		}
+	}
+	else // 8-bit
+	{
+		for (uint32_t i = 0; i < dstLength; i++)
+		{
+			const uint32_t position = posFrac64 >> 32;
+			dst[i] = src[position];
+			posFrac64 += delta64;
+		}
+	}
+}
+
 static int32_t SDLCALL resampleThread(void *ptr)
 {
 	smpPtr_t sp;
+	sample_t newSmp;
 
 	if (instr[editor.curInstr] == NULL)
 		return true;
@@ -105,63 +314,50 @@ static int32_t SDLCALL resampleThread(void *ptr)
 		return true;
 	}
 
-	int8_t *dst = sp.ptr;
-	int8_t *src = s->dataPtr;
-
-	// 32.32 fixed-point logic
-	const uint64_t delta64 = (const uint64_t)round((UINT32_MAX+1.0) / dRatio);
-	uint64_t posFrac64 = 0;
-
-	pauseAudio();
-	unfixSample(s);
-
-	/* Nearest-neighbor resampling (no interpolation).
-	**
-	** Could benefit from windowed-sinc interpolation,
-	** but it seems like some people prefer no resampling
-	** interpolation (like FT2).
+	/* Windowed-sinc or nearest-neighbor resampling (no interpolation, like FT2).
+	** The sample keeps playing while we resample, so both work on unfixed copies of it.
 	*/
-
 	if (newLen > 0)
 	{
-		if (sample16Bit)
+		bool ok;
+		if (resample_Sinc)
 		{
-			const int16_t *src16 = (const int16_t *)src;
-			int16_t *dst16 = (int16_t *)dst;
-
-			for (uint32_t i = 0; i < newLen; i++)
-			{
-				const uint32_t position = posFrac64 >> 32;
-				dst16[i] = src16[position];
-				posFrac64 += delta64;
-			}
+			ok = resampleSinc(s, sp.ptr, newLen, 1.0 / dRatio);
 		}
-		else // 8-bit
+		else
 		{
-			const int8_t *src8 = src;
-			int8_t *dst8 = dst;
+			int8_t *src = cloneUnfixedSmpData(s);
 
-			for (uint32_t i = 0; i < newLen; i++)
+			ok = (src != NULL);
+			if (ok)
 			{
-				const uint32_t position = posFrac64 >> 32;
-				dst8[i] = src8[position];
-				posFrac64 += delta64;
+				resampleNearest(src, sp.ptr, newLen, dRatio, sample16Bit);
+				free(src);
 			}
 		}
+
+		if (!ok)
+		{
+			freeSmpDataPtr(&sp);
+			outOfMemory = true;
+			setMouseBusy(false);
+			ui.sysReqShown = false;
+			return true;
+		}
 	}
 
-	freeSmpData(s);
-	setSmpDataPtr(s, &sp);
+	memcpy(&newSmp, s, sizeof (sample_t));
+	setSmpDataPtr(&newSmp, &sp);
 
-	s->relativeNote += smpEd_RelReSmp;
-	s->length = newLen;
-	s->loopStart = (int32_t)(s->loopStart * dRatio);
-	s->loopLength = (int32_t)(s->loopLength * dRatio);
+	newSmp.relativeNote += smpEd_RelReSmp;
+	newSmp.length = newLen;
+	newSmp.loopStart = (int32_t)(newSmp.loopStart * dRatio);
+	newSmp.loopLength = (int32_t)(newSmp.loopLength * dRatio);
 
-	sanitizeSample(s);
+	sanitizeSample(&newSmp);
 
-	fixSample(s);
-	resumeAudio();
+	fixSample(&newSmp);
+	replaceSample(s, &newSmp);
 
 	setSongModifiedFlag();
 	setMouseBusy(false);
@@ -172,6 +368,11 @@ static int32_t SDLCALL resampleThread(void *ptr)
 	(void)ptr;
 }
 
+static void cbResampleSinc(void)
+{
+	resample_Sinc ^= 1;
+}
+
 static void pbDoResampling(void)
 {
 	mouseAnimOn();
@@ -189,9 +390,9 @@ static void drawResampleBox(void)
 {
 	char sign;
 	const int16_t x = 209;
-	const int16_t y = 230;
+	const int16_t y = 224;
 	const int16_t w = 214;
-	const int16_t h = 54;
+	const int16_t h = 68;
 
 	// main fill
 	fillRect(x + 1, y + 1, w - 2, h - 2, PAL_BUTTONS);
@@ -216,9 +417,10 @@ static void drawResampleBox(void)
 	if (dNewLen > (double)MAX_SAMPLE_LEN)
 		dNewLen = (double)MAX_SAMPLE_LEN;
 
-	textOutShadow(215, 236, PAL_FORGRND, PAL_BUTTON2, "Rel. h.tones");
-	textOutShadow(215, 250, PAL_FORGRND, PAL_BUTTON2, "New sample size");
-	hexOut(361, 250, PAL_FORGRND, (int32_t)dNewLen, 8);
+	textOutShadow(215, 230, PAL_FORGRND, PAL_BUTTON2, "Rel. h.tones");
+	textOutShadow(215, 244, PAL_FORGRND, PAL_BUTTON2, "New sample size");
+	hexOut(361, 244, PAL_FORGRND, (int32_t)dNewLen, 8);
+	textOutShadow(230, 258, PAL_FORGRND, PAL_BUTTON2, "Windowed-sinc interpolation");
 
 	     if (smpEd_RelReSmp == 0) sign = ' ';
 	else if (smpEd_RelReSmp  < 0) sign = '-';
@@ -227,28 +429,40 @@ static void drawResampleBox(void)
 	uint16_t val = ABS(smpEd_RelReSmp);
 	if (val > 9)
 	{
-		charOut(291, 236, PAL_FORGRND, sign);
-		charOut(298, 236, PAL_FORGRND, '0' + ((val / 10) % 10));
-		charOut(305, 236, PAL_FORGRND, '0' + (val % 10));
+		charOut(291, 230, PAL_FORGRND, sign);
+		charOut(298, 230, PAL_FORGRND, '0' + ((val / 10) % 10));
+		charOut(305, 230, PAL_FORGRND, '0' + (val % 10));
 	}
 	else
 	{
-		charOut(298, 236, PAL_FORGRND, sign);
-		charOut(305, 236, PAL_FORGRND, '0' + (val % 10));
+		charOut(298, 230, PAL_FORGRND, sign);
+		charOut(305, 230, PAL_FORGRND, '0' + (val % 10));
 	}
 }
 
 static void setupResampleBoxWidgets(void)
 {
 	pushButton_t *p;
+	checkBox_t *c;
 	scrollBar_t *s;
 
+	// "Windowed-sinc interpolation" checkbox
+	c = &checkBoxes[0];
+	memset(c, 0, sizeof (checkBox_t));
+	c->x = 214;
+	c->y = 256;
+	c->clickAreaWidth = 178;
+	c->clickAreaHeight = 12;
+	c->callbackFunc = cbResampleSinc;
+	c->checked = resample_Sinc ? CHECKBOX_CHECKED : CHECKBOX_UNCHECKED;
+	c->visible = true;
+
 	// "Apply" pushbutton
 	p = &pushButtons[0];
 	memset(p, 0, sizeof (pushButton_t));
 	p->caption = "Apply";
 	p->x = 214;
-	p->y = 264;
+	p->y = 272;
 	p->w = 73;
 	p->h = 16;
 	p->callbackFuncOnUp = pbDoResampling;
@@ -259,7 +473,7 @@ static void setupResampleBoxWidgets(void)
 	memset(p, 0, sizeof (pushButton_t));
 	p->caption = "Exit";
 	p->x = 345;
-	p->y = 264;
+	p->y = 272;
 	p->w = 73;
 	p->h = 16;
 	p->callbackFuncOnUp = pbExit;
@@ -271,7 +485,7 @@ static void setupResampleBoxWidgets(void)
 	memset(p, 0, sizeof (pushButton_t));
 	p->caption = ARROW_LEFT_STRING;
 	p->x = 314;
-	p->y = 234;
+	p->y = 228;
 	p->w = 23;
 	p->h = 13;
 	p->preDelay = 1;
@@ -283,7 +497,7 @@ static void setupResampleBoxWidgets(void)
 	memset(p, 0, sizeof (pushButton_t));
 	p->caption = ARROW_RIGHT_STRING;
 	p->x = 395;
-	p->y = 234;
+	p->y = 228;
 	p->w = 23;
 	p->h = 13;
 	p->preDelay = 1;
@@ -295,7 +509,7 @@ static void setupResampleBoxWidgets(void)
 	s = &scrollBars[0];
 	memset(s, 0, sizeof (scrollBar_t));
 	s->x = 337;
-	s->y = 234;
+	s->y = 228;
 	s->w = 58;
 	s->h = 13;
 	s->callbackFunc = sbSetResampleTones;
@@ -339,6 +553,7 @@ void pbSampleResample(void)
 		flipFrame();
 	}
 
+	hideCheckBox(0);
 	for (i = 0; i < 4; i++) hidePushButton(i);
 	hideScrollBar(0);
 
@@ -410,6 +625,7 @@ static void pbEchoFadeoutUp(void)
 static int32_t SDLCALL createEchoThread(void *ptr)
 {
 	smpPtr_t sp;
+	sample_t newSmp;
 
 	if (echo_nEcho < 1)
 	{
@@ -420,7 +636,6 @@ static int32_t SDLCALL createEchoThread(void *ptr)
 	sample_t *s = &instr[editor.curInstr]->smp[editor.curSmp];
 
 	int32_t readLen = s->length;
-	int8_t *readPtr = s->dataPtr;
 	bool sample16Bit = !!(s->flags & SAMPLE_16BIT);
 	int32_t distance = echo_Distance * 16;
 	double dVolChange = echo_VolChange / 100.0;
@@ -459,8 +674,16 @@ static int32_t SDLCALL createEchoThread(void *ptr)
 		return false;
 	}
 
-	pauseAudio();
-	unfixSample(s);
+	// the sample keeps playing while the echo is made, so read from an unfixed copy of it
+	int8_t *readPtr = cloneUnfixedSmpData(s);
+	if (readPtr == NULL && readLen > 0)
+	{
+		freeSmpDataPtr(&sp);
+		outOfMemory = true;
+		setMouseBusy(false);
+		ui.sysReqShown = false;
+		return false;
+	}
 
 	int32_t writeIdx = 0;
 
@@ -527,20 +750,24 @@ static int32_t SDLCALL createEchoThread(void *ptr)
 		}
 	}
 
-	freeSmpData(s);
-	setSmpDataPtr(s, &sp);
+	if (readPtr != NULL)
+		free(readPtr);
 
 	if (stopThread) // we stopped before echo was done, realloc length
 	{
 		writeLen = writeIdx;
-		reallocateSmpData(s, writeLen, sample16Bit);
+		reallocateSmpDataPtr(&sp, writeLen, sample16Bit);
 		editor.updateCurSmp = true;
 	}
 
-	s->length = writeLen;
+	memcpy(&newSmp, s, sizeof (sample_t));
+	setSmpDataPtr(&newSmp, &sp);
+	newSmp.length = writeLen;
 
-	fixSample(s);
-	resumeAudio();
+	sanitizeSample(&newSmp);
+
+	fixSample(&newSmp);
+	replaceSample(s, &newSmp);
 
 	setSongModifiedFlag();
 	setMouseBusy(false);
@@ -809,6 +1036,7 @@ void pbSampleEcho(void)
 static int32_t SDLCALL mixThread(void *ptr)
 {
 	smpPtr_t sp;
+	sample_t newSmp;
 
 	int8_t *dstPtr, *mixPtr;
 	uint8_t mixFlags, dstFlags;
@@ -889,18 +1117,30 @@ static int32_t SDLCALL mixThread(void *ptr)
 
 	if (instr[dstIns] == NULL && !allocateInstr(dstIns))
 	{
+		freeSmpDataPtr(&sp);
 		outOfMemory = true;
 		setMouseBusy(false);
 		ui.sysReqShown = false;
 		return true;
 	}
 
-	pauseAudio();
-	unfixSample(s);
+	s = &instr[dstIns]->smp[dstSmp]; // the instrument may have just been allocated
+
+	// both samples keep playing while we mix, so read from unfixed copies of them
+	mixPtr = (mixLen > 0) ? cloneUnfixedSmpData(sSrc) : NULL;
+	dstPtr = (dstLen > 0) ? cloneUnfixedSmpData(s) : NULL;
 
-	// unfix source sample
-	if (instr[mixIns] != NULL)
-		unfixSample(sSrc);
+	if ((mixLen > 0 && mixPtr == NULL) || (dstLen > 0 && dstPtr == NULL))
+	{
+		if (mixPtr != NULL) free(mixPtr);
+		if (dstPtr != NULL) free(dstPtr);
+		freeSmpDataPtr(&sp);
+
+		outOfMemory = true;
+		setMouseBusy(false);
+		ui.sysReqShown = false;
+		return true;
+	}
 
 	const double dAmp1 = mix_Balance / 100.0;
 	const double dAmp2 = 1.0 - dAmp1;
@@ -917,19 +1157,17 @@ static int32_t SDLCALL mixThread(void *ptr)
 		putSampleValue(sp.ptr, i, dSmp, dst16Bits);
 	}
 
-	freeSmpData(s);
-	setSmpDataPtr(s, &sp);
-
-	s->length = maxLen;
-	s->flags = dstFlags;
+	if (mixPtr != NULL) free(mixPtr);
+	if (dstPtr != NULL) free(dstPtr);
 
-	fixSample(s);
+	memcpy(&newSmp, s, sizeof (sample_t));
+	setSmpDataPtr(&newSmp, &sp);
 
-	// re-fix source sample again
-	if (instr[mixIns] != NULL)
-		fixSample(sSrc);
+	newSmp.length = maxLen;
+	newSmp.flags = dstFlags;
 
-	resumeAudio();
+	fixSample(&newSmp);
+	replaceSample(s, &newSmp);
 
 	setSongModifiedFlag();
 	setMouseBusy(false);
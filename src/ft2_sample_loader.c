@@ -19,16 +19,17 @@
 #include "ft2_mouse.h"
 #include "ft2_diskop.h"
 #include "ft2_structs.h"
+#include "ft2_sample_loader.h"
 
 #ifdef HAS_LIBFLAC
-bool loadFLAC(FILE* f, uint32_t filesize);
+bool loadFLAC(MEMFILE* f, uint32_t filesize);
 #endif
 
-bool loadAIFF(FILE* f, uint32_t filesize);
-bool loadIFF(FILE* f, uint32_t filesize);
-bool loadRAW(FILE* f, uint32_t filesize);
-bool loadWAV(FILE* f, uint32_t filesize);
-bool loadBRR(FILE* f, uint32_t filesize);
+bool loadAIFF(MEMFILE* f, uint32_t filesize);
+bool loadIFF(MEMFILE* f, uint32_t filesize);
+bool loadRAW(MEMFILE* f, uint32_t filesize);
+bool loadWAV(MEMFILE* f, uint32_t filesize);
+bool loadBRR(MEMFILE* f, uint32_t filesize);
 
 static char* _strcasestr(const char* haystack, const char* needle);
 
@@ -64,15 +65,15 @@ static SDL_Thread* thread;
 static void freeTmpSample(sample_t* s);
 
 // Crude sample detection routine. These aren't always accurate detections!
-static int8_t detectSample(FILE* f)
+static int8_t detectSample(MEMFILE* f)
 {
 	uint8_t D[512];
 
-	uint32_t oldPos = ftell(f);
-	rewind(f);
+	uint32_t oldPos = mtell(f);
+	mrewind(f);
 	memset(D, 0, sizeof(D));
-	fread(D, 1, sizeof(D), f);
-	fseek(f, oldPos, SEEK_SET);
+	mread(D, 1, sizeof(D), f);
+	mseek(f, oldPos, SEEK_SET);
 
 	if (!memcmp("fLaC", &D[0], 4)) // XXX: Kinda lousy detection...
 		return FORMAT_FLAC;
@@ -92,6 +93,123 @@ static int8_t detectSample(FILE* f)
 	return FORMAT_UNKNOWN;
 }
 
+static uint32_t readLE32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t readLE16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t readBE32(const uint8_t* p) { return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+static uint16_t readBE16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+
+// finds a RIFF/IFF chunk and reads up to 'dataLen' bytes of it, returns the chunk size (or -1)
+static int64_t findChunk(MEMFILE* f, const char* id, bool bigEndian, uint8_t* data, uint32_t dataLen)
+{
+	uint8_t hdr[8];
+
+	mseek(f, 12, SEEK_SET);
+	for (int32_t i = 0; i < 64; i++) // don't loop forever on broken files
+	{
+		if (mread(hdr, 1, 8, f) != 8)
+			return -1;
+
+		const uint32_t chunkSize = bigEndian ? readBE32(&hdr[4]) : readLE32(&hdr[4]);
+		if (!memcmp(hdr, id, 4))
+		{
+			memset(data, 0, dataLen);
+			mread(data, 1, (chunkSize < dataLen) ? chunkSize : dataLen, f);
+			return chunkSize;
+		}
+
+		if (mseek(f, chunkSize + (chunkSize & 1), SEEK_CUR) != 0) // chunks are word-aligned
+			return -1;
+	}
+
+	return -1;
+}
+
+// reads format, rate, length etc. from the header (for the Disk Op. file info cache)
+bool getSampleFileInfo(MEMFILE* f, fileInfo_t* info)
+{
+	uint8_t D[64];
+
+	switch (detectSample(f))
+	{
+		case FORMAT_WAV:
+		{
+			if (findChunk(f, "fmt ", false, D, 16) < 16)
+				return false;
+
+			const uint16_t blockAlign = readLE16(&D[12]);
+			strcpy(info->formatName, "WAV");
+			info->numChannels = (uint8_t)readLE16(&D[2]);
+			info->sampleRate = (int32_t)readLE32(&D[4]);
+			info->bitDepth = (uint8_t)readLE16(&D[14]);
+
+			const int64_t dataSize = findChunk(f, "data", false, D, 0);
+			if (dataSize > 0 && blockAlign > 0)
+				info->sampleLength = (int32_t)(dataSize / blockAlign);
+		}
+		break;
+
+		case FORMAT_AIFF:
+		{
+			if (findChunk(f, "COMM", true, D, 18) < 18)
+				return false;
+
+			strcpy(info->formatName, "AIFF");
+			info->numChannels = (uint8_t)readBE16(&D[0]);
+			info->sampleLength = (int32_t)readBE32(&D[2]);
+			info->bitDepth = (uint8_t)readBE16(&D[6]);
+
+			// sample rate is an 80-bit float (we only need the integer part)
+			const int32_t exponent = (readBE16(&D[8]) & 0x7FFF) - 16383;
+			const uint32_t mantissaHi = readBE32(&D[10]);
+			if (exponent >= 0 && exponent < 32)
+				info->sampleRate = (int32_t)(mantissaHi >> (31 - exponent));
+		}
+		break;
+
+		case FORMAT_IFF:
+		{
+			if (findChunk(f, "VHDR", true, D, 20) < 20)
+				return false;
+
+			mseek(f, 8, SEEK_SET);
+			uint8_t formType[4];
+			mread(formType, 1, 4, f);
+
+			strcpy(info->formatName, "IFF");
+			info->numChannels = 1;
+			info->bitDepth = !memcmp("16SV", formType, 4) ? 16 : 8;
+			info->sampleRate = readBE16(&D[12]);
+			info->sampleLength = (int32_t)(readBE32(&D[0]) + readBE32(&D[4])); // oneShotHiSamples + repeatHiSamples
+		}
+		break;
+
+		case FORMAT_FLAC:
+		{
+			// STREAMINFO is always the first metadata block
+			mseek(f, 8, SEEK_SET);
+			if (mread(D, 1, 34, f) != 34)
+				return false;
+
+			strcpy(info->formatName, "FLAC");
+			info->sampleRate = (D[10] << 12) | (D[11] << 4) | (D[12] >> 4);
+			info->numChannels = ((D[12] >> 1) & 7) + 1;
+			info->bitDepth = (((D[12] & 1) << 4) | (D[13] >> 4)) + 1;
+
+			const uint64_t totalSamples = ((uint64_t)(D[13] & 15) << 32) | readBE32(&D[14]);
+			info->sampleLength = (totalSamples > INT32_MAX) ? INT32_MAX : (int32_t)totalSamples;
+		}
+		break;
+
+		default: return false;
+	}
+
+	if (info->sampleLength < 0)
+		info->sampleLength = 0;
+
+	info->type = FILEINFO_SAMPLE;
+	return true;
+}
+
 static int32_t SDLCALL loadSampleThread(void* ptr)
 {
 	if (editor.tmpFilenameU == NULL)
@@ -100,7 +218,7 @@ static int32_t SDLCALL loadSampleThread(void* ptr)
 		return false;
 	}
 
-	FILE* f = UNICHAR_FOPEN(editor.tmpFilenameU, "rb");
+	MEMFILE* f = mopen(editor.tmpFilenameU);
 	if (f == NULL)
 	{
 		loaderMsgBox("General I/O error during loading! Is the file in use?");
@@ -114,19 +232,19 @@ static int32_t SDLCALL loadSampleThread(void* ptr)
 	else
 		format = detectSample(f);
 
-	fseek(f, 0, SEEK_END);
-	uint32_t filesize = ftell(f);
+	mseek(f, 0, SEEK_END);
+	uint32_t filesize = mtell(f);
 
 	if (filesize == 0)
 	{
-		fclose(f);
+		mclose(f);
 		loaderMsgBox("Error loading sample: The file is empty!");
 		return false;
 	}
 
 	bool sampleLoaded = false;
 
-	rewind(f);
+	mrewind(f);
 	switch (format)
 	{
 	case FORMAT_FLAC:
@@ -145,7 +263,7 @@ static int32_t SDLCALL loadSampleThread(void* ptr)
 	case FORMAT_BRR: sampleLoaded = loadBRR(f, filesize); break;
 	default: sampleLoaded = loadRAW(f, filesize); break;
 	}
-	fclose(f);
+	mclose(f);
 
 	if (!sampleLoaded)
 		goto loadError;
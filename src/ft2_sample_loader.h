@@ -4,6 +4,8 @@
 #include <stdbool.h>
 #include "ft2_header.h"
 #include "ft2_unicode.h"
+#include "ft2_memfile.h"
+#include "ft2_diskop_cache.h"
 
 enum
 {
@@ -18,6 +20,7 @@ void normalize64BitFloatToSigned16Bit(double *dSampleData, uint32_t sampleLength
 
 bool loadSample(UNICHAR *filenameU, uint8_t sampleSlot, bool loadAsInstrFlag);
 void removeSampleIsLoadingFlag(void);
+bool getSampleFileInfo(MEMFILE *f, fileInfo_t *info); // for Disk Op. (header only)
 
 // globals for sample loaders
 extern bool loadAsInstrFlag, smpFilenameSet;
@@ -5,6 +5,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h> // malloc()/calloc()
 #include "ft2_config.h"
 #include "ft2_gui.h"
 #include "ft2_mouse.h"
@@ -30,49 +31,145 @@
 #define PREVIEW_SAMPLES 8192
 #endif
 
+/* The input callbacks write into fixed-size chunks, and the sample is only put together when
+** sampling stops. This way, no already recorded data is moved around while sampling.
+*/
+#define SAMPLING_CHUNK_BITS 16
+#define SAMPLING_CHUNK_LEN (1 << SAMPLING_CHUNK_BITS) // in samples (per channel)
+#define SAMPLING_CHUNK_MASK (SAMPLING_CHUNK_LEN-1)
+#define SAMPLING_MAX_CHUNKS ((MAX_SAMPLE_LEN >> SAMPLING_CHUNK_BITS) + 1)
+
 static bool sampleInStereo;
 static volatile bool drawSamplingBufferFlag, outOfMemoryFlag, noMoreRoomFlag;
 static int16_t previewBufL[2][PREVIEW_SAMPLES], previewBufR[2][PREVIEW_SAMPLES];
+static int16_t **chunksL, **chunksR;
 static int32_t samplesSampled, samplingBufferSize, currPreviewBufNum, oldPreviewSmpPos, currSampleLen;
 static uint32_t samplingRate;
 static sample_t *smpL, *smpR;
 static SDL_AudioDeviceID recordDev;
 
-static void SDLCALL stereoSamplingCallback(void *userdata, Uint8 *stream, int len)
+static void freeSamplingChunks(int16_t ***chunks)
 {
-	const int32_t samples = len >> 2;
-	if (instr[editor.curInstr] == NULL || samples < 0 || samples > samplingBufferSize)
+	if (*chunks == NULL)
 		return;
 
-	if (!reallocateSmpData(smpL, smpL->length + samples, true) || !reallocateSmpData(smpR, smpR->length + samples, true))
+	for (int32_t i = 0; i < SAMPLING_MAX_CHUNKS; i++)
 	{
-		drawSamplingBufferFlag = false;
-		outOfMemoryFlag = true;
-		return;
+		if ((*chunks)[i] != NULL)
+			free((*chunks)[i]);
 	}
 
-	const int16_t *src16 = (int16_t *)stream;
-	int16_t *dst16_L = (int16_t *)smpL->dataPtr + smpL->length;
-	int16_t *dst16_R = (int16_t *)smpR->dataPtr + smpR->length;
+	free(*chunks);
+	*chunks = NULL;
+}
+
+// makes sure that the chunks for the sample positions pos..pos+length-1 exist
+static bool allocateSamplingChunks(int16_t **chunks, int32_t pos, int32_t length)
+{
+	const int32_t lastChunk = (pos + length - 1) >> SAMPLING_CHUNK_BITS;
+	for (int32_t i = pos >> SAMPLING_CHUNK_BITS; i <= lastChunk; i++)
+	{
+		if (chunks[i] == NULL)
+		{
+			chunks[i] = (int16_t *)malloc(SAMPLING_CHUNK_LEN * sizeof (int16_t));
+			if (chunks[i] == NULL)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static void writeToSamplingChunks(int16_t **chunks, int32_t pos, const int16_t *src16, int32_t srcStride, int32_t length)
+{
+	while (length > 0)
+	{
+		int16_t *dst16 = chunks[pos >> SAMPLING_CHUNK_BITS] + (pos & SAMPLING_CHUNK_MASK);
+
+		int32_t samples = SAMPLING_CHUNK_LEN - (pos & SAMPLING_CHUNK_MASK);
+		if (samples > length)
+			samples = length;
 
-	for (int32_t i = 0; i < samples; i++)
+		if (srcStride == 1)
+		{
+			memcpy(dst16, src16, samples * sizeof (int16_t));
+		}
+		else
+		{
+			for (int32_t i = 0; i < samples; i++)
+				dst16[i] = src16[i * srcStride];
+		}
+
+		src16 += samples * srcStride;
+		pos += samples;
+		length -= samples;
+	}
+}
+
+static void readFromSamplingChunks(int16_t **chunks, int32_t pos, int16_t *dst16, int32_t length)
+{
+	while (length > 0)
 	{
-		dst16_L[i] = *src16++;
-		dst16_R[i] = *src16++;
+		const int16_t *src16 = chunks[pos >> SAMPLING_CHUNK_BITS] + (pos & SAMPLING_CHUNK_MASK);
+
+		int32_t samples = SAMPLING_CHUNK_LEN - (pos & SAMPLING_CHUNK_MASK);
+		if (samples > length)
+			samples = length;
+
+		memcpy(dst16, src16, samples * sizeof (int16_t));
+
+		dst16 += samples;
+		pos += samples;
+		length -= samples;
 	}
+}
 
-	smpL->length += samples;
-	smpR->length += samples;
+// puts the recorded chunks together into the sample (the chunks are freed)
+static bool assembleSampledData(sample_t *s, int16_t ***chunks, int32_t length)
+{
+	bool result = true;
 
-	if (smpL->length > MAX_SAMPLE_LEN) // length overflow
+	if (length > 0)
+	{
+		if (allocateSmpData(s, length, true))
+		{
+			readFromSamplingChunks(*chunks, 0, (int16_t *)s->dataPtr, length);
+			s->length = length;
+		}
+		else
+		{
+			result = false;
+		}
+	}
+
+	freeSamplingChunks(chunks);
+	return result;
+}
+
+static void SDLCALL stereoSamplingCallback(void *userdata, Uint8 *stream, int len)
+{
+	const int32_t samples = len >> 2;
+	if (instr[editor.curInstr] == NULL || samples <= 0 || samples > samplingBufferSize)
+		return;
+
+	if (currSampleLen+samples > MAX_SAMPLE_LEN) // length overflow
 	{
-		smpL->length -= samples;
-		smpR->length -= samples;
 		noMoreRoomFlag = true;
 		return;
 	}
 
-	currSampleLen = smpL->length;
+	if (!allocateSamplingChunks(chunksL, currSampleLen, samples) || !allocateSamplingChunks(chunksR, currSampleLen, samples))
+	{
+		drawSamplingBufferFlag = false;
+		outOfMemoryFlag = true;
+		return;
+	}
+
+	const int16_t *src16 = (int16_t *)stream;
+	writeToSamplingChunks(chunksL, currSampleLen, &src16[0], 2, samples);
+	writeToSamplingChunks(chunksR, currSampleLen, &src16[1], 2, samples);
+
+	currSampleLen += samples;
 
 	// if we have gathared enough samples, fill the current display buffer
 
@@ -83,18 +180,13 @@ static void SDLCALL stereoSamplingCallback(void *userdata, Uint8 *stream, int le
 
 		if (oldPreviewSmpPos > 0)
 		{
-			int16_t *dstL = previewBufL[currPreviewBufNum^1];
-			int16_t *dstR = previewBufR[currPreviewBufNum^1];
-			const int16_t *srcL = (int16_t *)smpL->dataPtr + oldPreviewSmpPos;
-			const int16_t *srcR = (int16_t *)smpR->dataPtr + oldPreviewSmpPos;
-
-			memcpy(dstL, srcL, PREVIEW_SAMPLES * sizeof (int16_t));
-			memcpy(dstR, srcR, PREVIEW_SAMPLES * sizeof (int16_t));
+			readFromSamplingChunks(chunksL, oldPreviewSmpPos, previewBufL[currPreviewBufNum^1], PREVIEW_SAMPLES);
+			readFromSamplingChunks(chunksR, oldPreviewSmpPos, previewBufR[currPreviewBufNum^1], PREVIEW_SAMPLES);
 
 			drawSamplingBufferFlag = true;
 		}
 
-		oldPreviewSmpPos = smpL->length - PREVIEW_SAMPLES;
+		oldPreviewSmpPos = currSampleLen - PREVIEW_SAMPLES;
 	}
 
 	(void)userdata;
@@ -103,28 +195,25 @@ static void SDLCALL stereoSamplingCallback(void *userdata, Uint8 *stream, int le
 static void SDLCALL monoSamplingCallback(void *userdata, Uint8 *stream, int len)
 {
 	const int32_t samples = len >> 1;
-	if (instr[editor.curInstr] == NULL || samples < 0 || samples > samplingBufferSize)
+	if (instr[editor.curInstr] == NULL || samples <= 0 || samples > samplingBufferSize)
 		return;
 
-	if (!reallocateSmpData(smpL, smpL->length + samples, true))
+	if (currSampleLen+samples > MAX_SAMPLE_LEN) // length overflow
 	{
-		drawSamplingBufferFlag = false;
-		outOfMemoryFlag = true;
+		noMoreRoomFlag = true;
 		return;
 	}
 
-	const int16_t *src16 = (int16_t *)stream;
-	int16_t *dst16 = (int16_t *)smpL->dataPtr + smpL->length;
-	memcpy(dst16, src16, samples * sizeof (int16_t));
-
-	smpL->length += samples;
-	if (smpL->length > MAX_SAMPLE_LEN) // length overflow
+	if (!allocateSamplingChunks(chunksL, currSampleLen, samples))
 	{
-		smpL->length -= samples;
-		noMoreRoomFlag = true;
+		drawSamplingBufferFlag = false;
+		outOfMemoryFlag = true;
 		return;
 	}
 
+	writeToSamplingChunks(chunksL, currSampleLen, (int16_t *)stream, 1, samples);
+	currSampleLen += samples;
+
 	// if we have gathared enough samples, fill the current display buffer
 
 	samplesSampled += samples;
@@ -134,18 +223,13 @@ static void SDLCALL monoSamplingCallback(void *userdata, Uint8 *stream, int len)
 
 		if (oldPreviewSmpPos > 0)
 		{
-			int16_t *dst = previewBufL[currPreviewBufNum^1];
-			const int16_t *src = (int16_t *)smpL->dataPtr + oldPreviewSmpPos;
-			memcpy(dst, src, PREVIEW_SAMPLES * sizeof (int16_t));
-
+			readFromSamplingChunks(chunksL, oldPreviewSmpPos, previewBufL[currPreviewBufNum^1], PREVIEW_SAMPLES);
 			drawSamplingBufferFlag = true;
 		}
 
-		oldPreviewSmpPos = smpL->length - PREVIEW_SAMPLES;
+		oldPreviewSmpPos = currSampleLen - PREVIEW_SAMPLES;
 	}
 
-	currSampleLen = smpL->length;
-
 	(void)userdata;
 }
 
@@ -154,13 +238,20 @@ void stopSampling(void)
 	resumeAudio();
 	mouseAnimOff();
 
-	SDL_CloseAudioDevice(recordDev);
+	SDL_CloseAudioDevice(recordDev); // the input callback is not running after this
+
+	bool outOfMemory = false;
+	if (chunksL != NULL && !assembleSampledData(smpL, &chunksL, currSampleLen)) outOfMemory = true;
+	if (chunksR != NULL && !assembleSampledData(smpR, &chunksR, currSampleLen)) outOfMemory = true;
 
 	if (smpL != NULL) fixSample(smpL);
 	if (smpR != NULL) fixSample(smpR);
 
 	editor.samplingAudioFlag = false;
 
+	if (outOfMemory)
+		okBox(0, "System message", "Not enough memory!", NULL);
+
 	updateSampleEditorSample();
 	editor.updateCurInstr = true;
 }
@@ -196,6 +287,7 @@ static void drawSamplingPreview(void)
 
 	// clear sample data area
 	memset(&video.frameBuffer[174 * SCREEN_W], 0, SAMPLE_AREA_WIDTH * SAMPLE_AREA_HEIGHT * sizeof (int32_t));
+	markDirtyRect(0, 174, SAMPLE_AREA_WIDTH, SAMPLE_AREA_HEIGHT);
 
 	if (sampleInStereo) // stereo sampling
 	{
@@ -381,6 +473,19 @@ void startSampling(void)
 		return;
 	}
 
+	chunksL = (int16_t **)calloc(SAMPLING_MAX_CHUNKS, sizeof (int16_t *));
+	if (sampleInStereo)
+		chunksR = (int16_t **)calloc(SAMPLING_MAX_CHUNKS, sizeof (int16_t *));
+
+	if (chunksL == NULL || (sampleInStereo && chunksR == NULL))
+	{
+		freeSamplingChunks(&chunksL);
+		freeSamplingChunks(&chunksR);
+		stopSampling();
+		okBox(0, "System message", "Not enough memory!", NULL);
+		return;
+	}
+
 	smpL = &instr[editor.curInstr]->smp[editor.curSmp];
 	freeSample(editor.curInstr, editor.curSmp); // also sets pan to 128 and vol to 64
 	tuneSample(smpL, samplingRate, audio.linearPeriodsFlag);
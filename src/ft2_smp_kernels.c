@@ -0,0 +1,425 @@
+#include <stdint.h>
+#include <stdbool.h>
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+#include <emmintrin.h>
+#endif
+#include "ft2_structs.h"
+#include "ft2_smp_kernels.h"
+
+// reads a little-endian 16-bit sample from an unaligned pointer
+#define READ_LE16(p, i) ((int16_t)(((const uint8_t *)(p))[((i)<<1)+0] | (((const uint8_t *)(p))[((i)<<1)+1] << 8)))
+
+// ------------------------------------------------------------------------------------------------
+// plain C (reference)
+// ------------------------------------------------------------------------------------------------
+
+static void deltaDecode8C(int8_t *dst, const int8_t *src, int32_t length)
+{
+	int8_t old = 0;
+	for (int32_t i = 0; i < length; i++)
+	{
+		old += src[i];
+		dst[i] = old;
+	}
+}
+
+static void deltaDecode16C(int16_t *dst, const int8_t *src, int32_t length)
+{
+	int16_t old = 0;
+	for (int32_t i = 0; i < length; i++)
+	{
+		old += READ_LE16(src, i);
+		dst[i] = old;
+	}
+}
+
+static void deltaDecodeStereo8C(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length)
+{
+	int8_t oldL = 0, oldR = 0;
+	for (int32_t i = 0; i < length; i++)
+	{
+		oldL += srcL[i];
+		oldR += srcR[i];
+		dst[i] = (int8_t)((oldL + oldR) >> 1);
+	}
+}
+
+static void deltaDecodeStereo16C(int16_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length)
+{
+	int16_t oldL = 0, oldR = 0;
+	for (int32_t i = 0; i < length; i++)
+	{
+		oldL += READ_LE16(srcL, i);
+		oldR += READ_LE16(srcR, i);
+		dst[i] = (int16_t)((oldL + oldR) >> 1);
+	}
+}
+
+static void deltaEncode8C(int8_t *p, int32_t length)
+{
+	int8_t prev = 0;
+	for (int32_t i = 0; i < length; i++)
+	{
+		const int8_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+static void deltaEncode16C(int16_t *p, int32_t length)
+{
+	int16_t prev = 0;
+	for (int32_t i = 0; i < length; i++)
+	{
+		const int16_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+static void flipSign8C(int8_t *p, int32_t length)
+{
+	for (int32_t i = 0; i < length; i++)
+		p[i] ^= 0x80;
+}
+
+static void flipSign16C(int16_t *p, int32_t length)
+{
+	for (int32_t i = 0; i < length; i++)
+		p[i] ^= 0x8000;
+}
+
+static void flipSignStereo8C(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length)
+{
+	for (int32_t i = 0; i < length; i++)
+	{
+		const int8_t l = srcL[i] ^ 0x80;
+		const int8_t r = srcR[i] ^ 0x80;
+		dst[i] = (int8_t)((l + r) >> 1);
+	}
+}
+
+static void flipSignStereo16C(int16_t *dst, const int16_t *srcL, const int16_t *srcR, int32_t length)
+{
+	for (int32_t i = 0; i < length; i++)
+	{
+		const int16_t l = srcL[i] ^ 0x8000;
+		const int16_t r = srcR[i] ^ 0x8000;
+		dst[i] = (int16_t)((l + r) >> 1);
+	}
+}
+
+const smpKernels_t smpKernelsC =
+{
+	"C",
+	deltaDecode8C, deltaDecode16C, deltaDecodeStereo8C, deltaDecodeStereo16C,
+	deltaEncode8C, deltaEncode16C,
+	flipSign8C, flipSign16C, flipSignStereo8C, flipSignStereo16C
+};
+
+// ------------------------------------------------------------------------------------------------
+// SSE2
+// ------------------------------------------------------------------------------------------------
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+
+/* Delta decoding is a prefix sum: each vector is summed in log2(n) shift+add steps,
+** and the last value of the previous vector (broadcasted) is added to all elements.
+*/
+
+static inline __m128i prefixSum8(__m128i x, __m128i carry)
+{
+	x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+	x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+	x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+	x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+
+	return _mm_add_epi8(x, carry);
+}
+
+static inline __m128i prefixSum16(__m128i x, __m128i carry)
+{
+	x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+	x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+	x = _mm_add_epi16(x, _mm_slli_si128(x, 8));
+
+	return _mm_add_epi16(x, carry);
+}
+
+static inline __m128i broadcastLast8(__m128i x)
+{
+	x = _mm_unpackhi_epi8(x, x);
+	x = _mm_unpackhi_epi16(x, x);
+
+	return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static inline __m128i broadcastLast16(__m128i x)
+{
+	x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+
+	return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// floor((a+b)/2) of signed values, stored as unsigned (biased) values
+static inline __m128i avgFloorBiased8(__m128i a, __m128i b)
+{
+	return _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+}
+
+static inline __m128i avgFloorBiased16(__m128i a, __m128i b)
+{
+	return _mm_sub_epi16(_mm_avg_epu16(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi16(1)));
+}
+
+static void deltaDecode8SSE2(int8_t *dst, const int8_t *src, int32_t length)
+{
+	__m128i carry = _mm_setzero_si128();
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+	{
+		const __m128i x = prefixSum8(_mm_loadu_si128((const __m128i *)&src[i]), carry);
+		_mm_storeu_si128((__m128i *)&dst[i], x);
+		carry = broadcastLast8(x);
+	}
+
+	int8_t old = (i > 0) ? dst[i-1] : 0;
+	for (; i < length; i++)
+	{
+		old += src[i];
+		dst[i] = old;
+	}
+}
+
+static void deltaDecode16SSE2(int16_t *dst, const int8_t *src, int32_t length)
+{
+	__m128i carry = _mm_setzero_si128();
+
+	int32_t i = 0;
+	for (; i+8 <= length; i += 8)
+	{
+		const __m128i x = prefixSum16(_mm_loadu_si128((const __m128i *)&src[i<<1]), carry);
+		_mm_storeu_si128((__m128i *)&dst[i], x);
+		carry = broadcastLast16(x);
+	}
+
+	int16_t old = (i > 0) ? dst[i-1] : 0;
+	for (; i < length; i++)
+	{
+		old += READ_LE16(src, i);
+		dst[i] = old;
+	}
+}
+
+static void deltaDecodeStereo8SSE2(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length)
+{
+	const __m128i bias = _mm_set1_epi8(-128);
+	__m128i carryL = _mm_setzero_si128();
+	__m128i carryR = _mm_setzero_si128();
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+	{
+		const __m128i l = prefixSum8(_mm_loadu_si128((const __m128i *)&srcL[i]), carryL);
+		const __m128i r = prefixSum8(_mm_loadu_si128((const __m128i *)&srcR[i]), carryR);
+		carryL = broadcastLast8(l);
+		carryR = broadcastLast8(r);
+
+		const __m128i avg = avgFloorBiased8(_mm_xor_si128(l, bias), _mm_xor_si128(r, bias));
+		_mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(avg, bias));
+	}
+
+	// get the channel values back for the rest
+	int8_t oldL = (int8_t)(_mm_cvtsi128_si32(carryL) & 0xFF);
+	int8_t oldR = (int8_t)(_mm_cvtsi128_si32(carryR) & 0xFF);
+	for (; i < length; i++)
+	{
+		oldL += srcL[i];
+		oldR += srcR[i];
+		dst[i] = (int8_t)((oldL + oldR) >> 1);
+	}
+}
+
+static void deltaDecodeStereo16SSE2(int16_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length)
+{
+	const __m128i bias = _mm_set1_epi16(-32768);
+	__m128i carryL = _mm_setzero_si128();
+	__m128i carryR = _mm_setzero_si128();
+
+	int32_t i = 0;
+	for (; i+8 <= length; i += 8)
+	{
+		const __m128i l = prefixSum16(_mm_loadu_si128((const __m128i *)&srcL[i<<1]), carryL);
+		const __m128i r = prefixSum16(_mm_loadu_si128((const __m128i *)&srcR[i<<1]), carryR);
+		carryL = broadcastLast16(l);
+		carryR = broadcastLast16(r);
+
+		const __m128i avg = avgFloorBiased16(_mm_xor_si128(l, bias), _mm_xor_si128(r, bias));
+		_mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(avg, bias));
+	}
+
+	int16_t oldL = (int16_t)(_mm_cvtsi128_si32(carryL) & 0xFFFF);
+	int16_t oldR = (int16_t)(_mm_cvtsi128_si32(carryR) & 0xFFFF);
+	for (; i < length; i++)
+	{
+		oldL += READ_LE16(srcL, i);
+		oldR += READ_LE16(srcR, i);
+		dst[i] = (int16_t)((oldL + oldR) >> 1);
+	}
+}
+
+// in place, so the previous vector's original samples are kept in a register
+static void deltaEncode8SSE2(int8_t *p, int32_t length)
+{
+	__m128i prevX = _mm_setzero_si128();
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i *)&p[i]);
+		const __m128i prev = _mm_or_si128(_mm_slli_si128(x, 1), _mm_srli_si128(prevX, 15));
+		_mm_storeu_si128((__m128i *)&p[i], _mm_sub_epi8(x, prev));
+		prevX = x;
+	}
+
+	int8_t prev = (int8_t)(_mm_extract_epi16(prevX, 7) >> 8);
+	for (; i < length; i++)
+	{
+		const int8_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+static void deltaEncode16SSE2(int16_t *p, int32_t length)
+{
+	__m128i prevX = _mm_setzero_si128();
+
+	int32_t i = 0;
+	for (; i+8 <= length; i += 8)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i *)&p[i]);
+		const __m128i prev = _mm_or_si128(_mm_slli_si128(x, 2), _mm_srli_si128(prevX, 14));
+		_mm_storeu_si128((__m128i *)&p[i], _mm_sub_epi16(x, prev));
+		prevX = x;
+	}
+
+	int16_t prev = (int16_t)_mm_extract_epi16(prevX, 7);
+	for (; i < length; i++)
+	{
+		const int16_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+static void flipSign8SSE2(int8_t *p, int32_t length)
+{
+	const __m128i bias = _mm_set1_epi8(-128);
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+		_mm_storeu_si128((__m128i *)&p[i], _mm_xor_si128(_mm_loadu_si128((const __m128i *)&p[i]), bias));
+
+	for (; i < length; i++)
+		p[i] ^= 0x80;
+}
+
+static void flipSign16SSE2(int16_t *p, int32_t length)
+{
+	const __m128i bias = _mm_set1_epi16(-32768);
+
+	int32_t i = 0;
+	for (; i+8 <= length; i += 8)
+		_mm_storeu_si128((__m128i *)&p[i], _mm_xor_si128(_mm_loadu_si128((const __m128i *)&p[i]), bias));
+
+	for (; i < length; i++)
+		p[i] ^= 0x8000;
+}
+
+// unsigned input is already biased, so only the result needs its sign flipped back
+static void flipSignStereo8SSE2(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length)
+{
+	const __m128i bias = _mm_set1_epi8(-128);
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+	{
+		const __m128i l = _mm_loadu_si128((const __m128i *)&srcL[i]);
+		const __m128i r = _mm_loadu_si128((const __m128i *)&srcR[i]);
+		_mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(avgFloorBiased8(l, r), bias));
+	}
+
+	flipSignStereo8C(&dst[i], &srcL[i], &srcR[i], length-i);
+}
+
+static void flipSignStereo16SSE2(int16_t *dst, const int16_t *srcL, const int16_t *srcR, int32_t length)
+{
+	const __m128i bias = _mm_set1_epi16(-32768);
+
+	int32_t i = 0;
+	for (; i+8 <= length; i += 8)
+	{
+		const __m128i l = _mm_loadu_si128((const __m128i *)&srcL[i]);
+		const __m128i r = _mm_loadu_si128((const __m128i *)&srcR[i]);
+		_mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(avgFloorBiased16(l, r), bias));
+	}
+
+	flipSignStereo16C(&dst[i], &srcL[i], &srcR[i], length-i);
+}
+
+const smpKernels_t smpKernelsSSE2 =
+{
+	"SSE2",
+	deltaDecode8SSE2, deltaDecode16SSE2, deltaDecodeStereo8SSE2, deltaDecodeStereo16SSE2,
+	deltaEncode8SSE2, deltaEncode16SSE2,
+	flipSign8SSE2, flipSign16SSE2, flipSignStereo8SSE2, flipSignStereo16SSE2
+};
+
+#if SMP_KERNELS_HAS_AVX2
+
+// ft2_smp_kernels_avx2.c
+void deltaDecode8AVX2(int8_t *dst, const int8_t *src, int32_t length);
+void deltaDecode16AVX2(int16_t *dst, const int8_t *src, int32_t length);
+void deltaEncode8AVX2(int8_t *p, int32_t length);
+void deltaEncode16AVX2(int16_t *p, int32_t length);
+void flipSign8AVX2(int8_t *p, int32_t length);
+void flipSign16AVX2(int16_t *p, int32_t length);
+void flipSignStereo8AVX2(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length);
+void flipSignStereo16AVX2(int16_t *dst, const int16_t *srcL, const int16_t *srcR, int32_t length);
+
+const smpKernels_t smpKernelsAVX2 =
+{
+	"AVX2",
+	deltaDecode8AVX2, deltaDecode16AVX2, deltaDecodeStereo8SSE2, deltaDecodeStereo16SSE2,
+	deltaEncode8AVX2, deltaEncode16AVX2,
+	flipSign8AVX2, flipSign16AVX2, flipSignStereo8AVX2, flipSignStereo16AVX2
+};
+
+#endif
+
+const smpKernels_t *smpKernels = &smpKernelsSSE2;
+
+#else
+
+const smpKernels_t *smpKernels = &smpKernelsC;
+
+#endif
+
+void selectSmpKernels(void)
+{
+#if SMP_KERNELS_HAS_AVX2
+	if (cpu.hasAVX2)
+	{
+		smpKernels = &smpKernelsAVX2;
+		return;
+	}
+#endif
+
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+	smpKernels = &smpKernelsSSE2;
+#else
+	smpKernels = &smpKernelsC;
+#endif
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Sample data conversion kernels (delta decoding/encoding and sign flipping), used by the
+** module/sample loaders and savers (see delta2Samp()/samp2Delta()/conv8BitSample()/
+** conv16BitSample() in ft2_replayer.c).
+**
+** There's a plain C version, an SSE2 version (always used on x86/x86_64) and an AVX2 version
+** (ft2_smp_kernels_avx2.c, x86_64 only). selectSmpKernels() picks one on startup. They all
+** give exactly the same output (ft2-smpbench --check verifies this).
+**
+** 'src' pointers don't need to be aligned. 16-bit data in 'src' is little-endian.
+** 'dst' can be the same as 'src' (or 'srcL'), but the buffers must not overlap otherwise.
+** Stereo functions downmix the left and right channels to mono ((L+R)>>1).
+*/
+
+// AVX2 kernels (ft2_smp_kernels_avx2.c) are only built for x86_64
+#if defined __amd64__ || defined _M_X64
+#define SMP_KERNELS_HAS_AVX2 1
+#else
+#define SMP_KERNELS_HAS_AVX2 0
+#endif
+
+typedef struct smpKernels_t
+{
+	const char *name;
+
+	void (*deltaDecode8)(int8_t *dst, const int8_t *src, int32_t length);
+	void (*deltaDecode16)(int16_t *dst, const int8_t *src, int32_t length);
+	void (*deltaDecodeStereo8)(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length);
+	void (*deltaDecodeStereo16)(int16_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length);
+	void (*deltaEncode8)(int8_t *p, int32_t length); // in place
+	void (*deltaEncode16)(int16_t *p, int32_t length); // in place
+	void (*flipSign8)(int8_t *p, int32_t length); // in place
+	void (*flipSign16)(int16_t *p, int32_t length); // in place
+	void (*flipSignStereo8)(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length);
+	void (*flipSignStereo16)(int16_t *dst, const int16_t *srcL, const int16_t *srcR, int32_t length);
+} smpKernels_t;
+
+extern const smpKernels_t *smpKernels; // ft2_smp_kernels.c
+
+extern const smpKernels_t smpKernelsC; // reference versions
+#if defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+extern const smpKernels_t smpKernelsSSE2;
+#endif
+#if SMP_KERNELS_HAS_AVX2
+extern const smpKernels_t smpKernelsAVX2; // functions are in ft2_smp_kernels_avx2.c
+#endif
+
+void selectSmpKernels(void); // called once on startup, after the CPU features have been detected
@@ -0,0 +1,228 @@
+/* AVX2 versions of the sample conversion kernels (see ft2_smp_kernels.h).
+**
+** The stereo delta decoders don't have AVX2 versions (they are rarely used), the SSE2 ones
+** are used instead. The function table is in ft2_smp_kernels.c, and selectSmpKernels() uses
+** it on startup if the CPU supports AVX2.
+*/
+
+#include <stdint.h>
+#include "ft2_smp_kernels.h"
+
+#if SMP_KERNELS_HAS_AVX2
+
+#if defined __clang__
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined __GNUC__
+#pragma GCC target("avx2")
+#endif
+
+#include <immintrin.h>
+
+#define READ_LE16(p, i) ((int16_t)(((const uint8_t *)(p))[((i)<<1)+0] | (((const uint8_t *)(p))[((i)<<1)+1] << 8)))
+
+/* The byte shifts work within each 128-bit lane, so after summing the lanes separately,
+** the last value of the low lane is added to the high lane.
+*/
+
+static inline __m256i prefixSum8(__m256i x, __m256i carry)
+{
+	x = _mm256_add_epi8(x, _mm256_slli_si256(x, 1));
+	x = _mm256_add_epi8(x, _mm256_slli_si256(x, 2));
+	x = _mm256_add_epi8(x, _mm256_slli_si256(x, 4));
+	x = _mm256_add_epi8(x, _mm256_slli_si256(x, 8));
+
+	const __m256i lastInLane = _mm256_shuffle_epi8(x, _mm256_set1_epi8(15));
+	x = _mm256_add_epi8(x, _mm256_permute2x128_si256(lastInLane, lastInLane, 0x08)); // low lane -> high lane
+
+	return _mm256_add_epi8(x, carry);
+}
+
+static inline __m256i prefixSum16(__m256i x, __m256i carry)
+{
+	x = _mm256_add_epi16(x, _mm256_slli_si256(x, 2));
+	x = _mm256_add_epi16(x, _mm256_slli_si256(x, 4));
+	x = _mm256_add_epi16(x, _mm256_slli_si256(x, 8));
+
+	const __m256i lastInLane = _mm256_shuffle_epi8(x, _mm256_set1_epi16(0x0F0E));
+	x = _mm256_add_epi16(x, _mm256_permute2x128_si256(lastInLane, lastInLane, 0x08));
+
+	return _mm256_add_epi16(x, carry);
+}
+
+static inline __m256i broadcastLast8(__m256i x)
+{
+	x = _mm256_shuffle_epi8(x, _mm256_set1_epi8(15));
+	return _mm256_permute2x128_si256(x, x, 0x11); // high lane -> both lanes
+}
+
+static inline __m256i broadcastLast16(__m256i x)
+{
+	x = _mm256_shuffle_epi8(x, _mm256_set1_epi16(0x0F0E));
+	return _mm256_permute2x128_si256(x, x, 0x11);
+}
+
+// floor((a+b)/2) of signed values, stored as unsigned (biased) values
+static inline __m256i avgFloorBiased8(__m256i a, __m256i b)
+{
+	return _mm256_sub_epi8(_mm256_avg_epu8(a, b), _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi8(1)));
+}
+
+static inline __m256i avgFloorBiased16(__m256i a, __m256i b)
+{
+	return _mm256_sub_epi16(_mm256_avg_epu16(a, b), _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi16(1)));
+}
+
+void deltaDecode8AVX2(int8_t *dst, const int8_t *src, int32_t length)
+{
+	__m256i carry = _mm256_setzero_si256();
+
+	int32_t i = 0;
+	for (; i+32 <= length; i += 32)
+	{
+		const __m256i x = prefixSum8(_mm256_loadu_si256((const __m256i *)&src[i]), carry);
+		_mm256_storeu_si256((__m256i *)&dst[i], x);
+		carry = broadcastLast8(x);
+	}
+
+	int8_t old = (i > 0) ? dst[i-1] : 0;
+	for (; i < length; i++)
+	{
+		old += src[i];
+		dst[i] = old;
+	}
+}
+
+void deltaDecode16AVX2(int16_t *dst, const int8_t *src, int32_t length)
+{
+	__m256i carry = _mm256_setzero_si256();
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+	{
+		const __m256i x = prefixSum16(_mm256_loadu_si256((const __m256i *)&src[i<<1]), carry);
+		_mm256_storeu_si256((__m256i *)&dst[i], x);
+		carry = broadcastLast16(x);
+	}
+
+	int16_t old = (i > 0) ? dst[i-1] : 0;
+	for (; i < length; i++)
+	{
+		old += READ_LE16(src, i);
+		dst[i] = old;
+	}
+}
+
+// in place, the previous vector's original samples are shifted in from a register
+void deltaEncode8AVX2(int8_t *p, int32_t length)
+{
+	__m256i prevX = _mm256_setzero_si256();
+
+	int32_t i = 0;
+	for (; i+32 <= length; i += 32)
+	{
+		const __m256i x = _mm256_loadu_si256((const __m256i *)&p[i]);
+		const __m256i prev = _mm256_alignr_epi8(x, _mm256_permute2x128_si256(prevX, x, 0x21), 15);
+		_mm256_storeu_si256((__m256i *)&p[i], _mm256_sub_epi8(x, prev));
+		prevX = x;
+	}
+
+	int8_t prev = (i > 0) ? (int8_t)(_mm256_extract_epi8(prevX, 31)) : 0;
+	for (; i < length; i++)
+	{
+		const int8_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+void deltaEncode16AVX2(int16_t *p, int32_t length)
+{
+	__m256i prevX = _mm256_setzero_si256();
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+	{
+		const __m256i x = _mm256_loadu_si256((const __m256i *)&p[i]);
+		const __m256i prev = _mm256_alignr_epi8(x, _mm256_permute2x128_si256(prevX, x, 0x21), 14);
+		_mm256_storeu_si256((__m256i *)&p[i], _mm256_sub_epi16(x, prev));
+		prevX = x;
+	}
+
+	int16_t prev = (i > 0) ? (int16_t)(_mm256_extract_epi16(prevX, 15)) : 0;
+	for (; i < length; i++)
+	{
+		const int16_t smp = p[i];
+		p[i] -= prev;
+		prev = smp;
+	}
+}
+
+void flipSign8AVX2(int8_t *p, int32_t length)
+{
+	const __m256i bias = _mm256_set1_epi8(-128);
+
+	int32_t i = 0;
+	for (; i+32 <= length; i += 32)
+		_mm256_storeu_si256((__m256i *)&p[i], _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&p[i]), bias));
+
+	for (; i < length; i++)
+		p[i] ^= 0x80;
+}
+
+void flipSign16AVX2(int16_t *p, int32_t length)
+{
+	const __m256i bias = _mm256_set1_epi16(-32768);
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+		_mm256_storeu_si256((__m256i *)&p[i], _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&p[i]), bias));
+
+	for (; i < length; i++)
+		p[i] ^= 0x8000;
+}
+
+void flipSignStereo8AVX2(int8_t *dst, const int8_t *srcL, const int8_t *srcR, int32_t length)
+{
+	const __m256i bias = _mm256_set1_epi8(-128);
+
+	int32_t i = 0;
+	for (; i+32 <= length; i += 32)
+	{
+		const __m256i l = _mm256_loadu_si256((const __m256i *)&srcL[i]);
+		const __m256i r = _mm256_loadu_si256((const __m256i *)&srcR[i]);
+		_mm256_storeu_si256((__m256i *)&dst[i], _mm256_xor_si256(avgFloorBiased8(l, r), bias));
+	}
+
+	for (; i < length; i++)
+	{
+		const int8_t l = srcL[i] ^ 0x80;
+		const int8_t r = srcR[i] ^ 0x80;
+		dst[i] = (int8_t)((l + r) >> 1);
+	}
+}
+
+void flipSignStereo16AVX2(int16_t *dst, const int16_t *srcL, const int16_t *srcR, int32_t length)
+{
+	const __m256i bias = _mm256_set1_epi16(-32768);
+
+	int32_t i = 0;
+	for (; i+16 <= length; i += 16)
+	{
+		const __m256i l = _mm256_loadu_si256((const __m256i *)&srcL[i]);
+		const __m256i r = _mm256_loadu_si256((const __m256i *)&srcR[i]);
+		_mm256_storeu_si256((__m256i *)&dst[i], _mm256_xor_si256(avgFloorBiased16(l, r), bias));
+	}
+
+	for (; i < length; i++)
+	{
+		const int16_t l = srcL[i] ^ 0x8000;
+		const int16_t r = srcR[i] ^ 0x8000;
+		dst[i] = (int16_t)((l + r) >> 1);
+	}
+}
+
+#if defined __clang__
+#pragma clang attribute pop
+#endif
+
+#endif
@@ -6,7 +6,7 @@
 
 typedef struct cpu_t
 {
-	bool hasSSE, hasSSE2;
+	bool hasSSE, hasSSE2, hasAVX2, hasFMA;
 } cpu_t;
 
 typedef struct editor_t
@@ -16,7 +16,7 @@ typedef struct editor_t
 
 	volatile bool mainLoopOngoing;
 	volatile bool busy, scopeThreadBusy, programRunning, wavIsRendering, wavReachedEndFlag;
-	volatile bool updateCurSmp, updateCurInstr, diskOpReadDir, diskOpReadDone, updateWindowTitle;
+	volatile bool updateCurSmp, updateCurInstr, diskOpReadDir, diskOpReadDone, diskOpReadUpdate, updateWindowTitle;
 	volatile uint8_t loadMusicEvent;
 	volatile FILE *wavRendererFileHandle;
 
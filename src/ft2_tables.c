@@ -694,8 +694,8 @@ const uint8_t pattCursorWTab[2 * 4 * 8] =
 	24,  4,  4,  4,  4,  4,  4,  4  // 12 columns visible
 };
 
-// these two are for channel numbering on pattern data/scopes
-const char chDecTab1[MAX_CHANNELS+1] = 
+// these two are for channel numbering on scopes
+const char chDecTab1[MAX_SCOPES+1] = 
 {
 	'0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
 	'1', '1', '1', '1', '1', '1', '1', '1', '1', '1',
@@ -703,7 +703,7 @@ const char chDecTab1[MAX_CHANNELS+1] =
 	'3', '3', '3'
 };
 
-const char chDecTab2[MAX_CHANNELS+1] = 
+const char chDecTab2[MAX_SCOPES+1] = 
 {
 	'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
 	'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
@@ -37,8 +37,8 @@ extern const pattCoord2_t pattCoord2Table[2][2][2];
 extern const markCoord_t markCoordTable[2][2][2];
 extern const uint8_t pattCursorXTab[2 * 4 * 8];
 extern const uint8_t pattCursorWTab[2 * 4 * 8];
-extern const char chDecTab1[MAX_CHANNELS+1];
-extern const char chDecTab2[MAX_CHANNELS+1];
+extern const char chDecTab1[MAX_SCOPES+1];
+extern const char chDecTab2[MAX_SCOPES+1];
 extern const SDL_Keycode key2VolTab[16];
 extern const SDL_Keycode key2EfxTab[36];
 extern const SDL_Keycode key2HexTab[16];
@@ -788,7 +788,7 @@ static int64_t calculateTrimSize(void)
 			if (highestChan & 1)
 				highestChan++;
 
-			numChannels = (uint8_t)(CLAMP(highestChan, 2, numChannels));
+			numChannels = CLAMP(highestChan, 2, numChannels);
 		}
 	}
 
@@ -901,7 +901,7 @@ static int32_t SDLCALL trimThreadFunc(void *ptr)
 			if (highestChan & 1)
 				highestChan++;
 
-			song.numChannels = (uint8_t)(CLAMP(highestChan, 2, song.numChannels));
+			song.numChannels = CLAMP(highestChan, 2, song.numChannels);
 		}
 
 		// clear potentially unused channel data
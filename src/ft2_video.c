@@ -35,6 +35,7 @@
 #include "ft2_bmp.h"
 #include "ft2_structs.h"
 #include "ft2_cpu.h"
+#include "ft2_audio.h"
 
 static const uint8_t textCursorData[12] =
 {
@@ -61,6 +62,23 @@ static sprite_t sprites[SPRITE_NUM];
 static char fpsTextBuf[1024];
 static uint64_t frameStartTime;
 static double dRunningFrameDuration, dAvgFPS;
+
+// for audio stats box (right of the FPS counter)
+#define AUDSTATS_LINES 15
+#define AUDSTATS_RENDER_W 205
+#define AUDSTATS_RENDER_H (((FONT1_CHAR_H + 1) * AUDSTATS_LINES) + 1)
+#define AUDSTATS_RENDER_X (FPS_RENDER_X+FPS_RENDER_W+5)
+#define AUDSTATS_RENDER_Y FPS_RENDER_Y
+#define AUDSTATS_LOG_SECONDS 5
+
+static char audStatsTextBuf[1024];
+static uint32_t audStatsSeconds;
+static uint64_t lastRenders, lastDeadlineMisses, lastReplayerTime64, lastMixTime64, lastOutputTime64, lastPeriodTime64;
+
+// for dirty rectangle tracking (see markDirtyRect() and updateTexture())
+static int16_t dirtyX1[SCREEN_H], dirtyX2[SCREEN_H]; // dirty span of each line (x2 is exclusive, clean if x1 >= x2)
+static uint32_t *textureBuffer; // copy of what's currently in the texture
+static bool textureIsStale, lastFrameWasPresented;
 // ------------------
 
 static void drawReplayerData(void);
@@ -70,6 +88,12 @@ void resetFPSCounter(void)
 	editor.framesPassed = 0;
 	fpsTextBuf[0] = '\0';
 	dRunningFrameDuration = 1000.0 / VBLANK_HZ;
+
+	audStatsTextBuf[0] = '\0';
+	audStatsSeconds = 0;
+	lastRenders = lastDeadlineMisses = 0;
+	lastReplayerTime64 = lastMixTime64 = lastOutputTime64 = lastPeriodTime64 = 0;
+	audioStats.resetFlag = true; // handled by the audio thread on its next render
 }
 
 void beginFPSCounter(void)
@@ -179,6 +203,124 @@ static void drawFPSCounter(void)
 	charOut(164 + x, 16, PAL_FORGRND, '*');
 }
 
+static void drawStatsBox(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const char *text)
+{
+	clearRect(x+2, y+2, w, h);
+	vLineDouble(x, y+1, h+2, PAL_FORGRND);
+	vLineDouble(x+w, y+1, h+2, PAL_FORGRND);
+	hLineDouble(x+1, y, w, PAL_FORGRND);
+	hLineDouble(x+1, y+h+2, w, PAL_FORGRND);
+
+	uint16_t xPos = x+3;
+	uint16_t yPos = y+3;
+
+	while (*text != '\0')
+	{
+		const char ch = *text++;
+		if (ch == '\n')
+		{
+			yPos += FONT1_CHAR_H+1;
+			xPos = x+3;
+			continue;
+		}
+
+		charOut(xPos, yPos, PAL_FORGRND, ch);
+		xPos += charWidth(ch);
+	}
+}
+
+// called once a second
+static void updateAudioStatsText(void)
+{
+	// take a snapshot (the audio thread keeps writing, so small inconsistencies are possible)
+	const uint64_t renders = audioStats.renders;
+	const uint64_t deadlineMisses = audioStats.deadlineMisses;
+	const uint64_t replayerTime64 = audioStats.replayerTime64;
+	const uint64_t mixTime64 = audioStats.mixTime64;
+	const uint64_t outputTime64 = audioStats.outputTime64;
+	const uint64_t periodTime64 = audioStats.periodTime64;
+	const uint64_t worstTime64 = audioStats.worstTime64;
+	const uint64_t worstPeriod64 = audioStats.worstPeriod64;
+
+	uint32_t histogram[AUDIO_STATS_HIST_BINS];
+	for (int32_t i = 0; i < AUDIO_STATS_HIST_BINS; i++)
+		histogram[i] = audioStats.histogram[i];
+
+	if (renders < lastRenders) // stats were reset by the audio thread
+		lastRenders = lastDeadlineMisses = lastReplayerTime64 = lastMixTime64 = lastOutputTime64 = lastPeriodTime64 = 0;
+
+	const uint64_t newRenders = renders - lastRenders;
+	const double dMul = (newRenders > 0) ? (hpcFreq.dFreqMulMs / newRenders) : 0.0;
+	const double dReplayerMs = (replayerTime64 - lastReplayerTime64) * dMul;
+	const double dMixMs = (mixTime64 - lastMixTime64) * dMul;
+	const double dOutputMs = (outputTime64 - lastOutputTime64) * dMul;
+	const double dPeriodMs = (periodTime64 - lastPeriodTime64) * dMul;
+	const double dLoad = (dPeriodMs > 0.0) ? (((dReplayerMs + dMixMs + dOutputMs) * 100.0) / dPeriodMs) : 0.0;
+	const double dWorstLoad = (worstPeriod64 > 0) ? ((worstTime64 * 100.0) / worstPeriod64) : 0.0;
+	const double dWorstMs = worstTime64 * hpcFreq.dFreqMulMs;
+	const uint64_t newDeadlineMisses = deadlineMisses - lastDeadlineMisses;
+
+	lastRenders = renders;
+	lastDeadlineMisses = deadlineMisses;
+	lastReplayerTime64 = replayerTime64;
+	lastMixTime64 = mixTime64;
+	lastOutputTime64 = outputTime64;
+	lastPeriodTime64 = periodTime64;
+
+	sprintf(audStatsTextBuf,
+	             "Audio thread (per render, last sec.)\n" \
+	             "Mode: %s\n" \
+	             "Renders: %u (%.2fms each)\n" \
+	             "Replayer: %.4fms\n" \
+	             "Mixer: %.4fms\n" \
+	             "Output: %.4fms\n" \
+	             "Load: %.2f%%\n" \
+	             "Worst: %.2f%% (%.3fms)\n" \
+	             "Deadline misses: %u (total %u)\n" \
+	             "Underruns: %u\n" \
+	             "Load histogram (renders):\n" \
+	             "0%%:%u 10%%:%u 20%%:%u\n" \
+	             "30%%:%u 40%%:%u 50%%:%u\n" \
+	             "60%%:%u 70%%:%u 80%%:%u\n" \
+	             "90%%:%u >=100%%:%u\n",
+	             (config.renderAheadMs > 0) ? "render-ahead thread" : "audio callback",
+	             (uint32_t)newRenders, dPeriodMs,
+	             dReplayerMs,
+	             dMixMs,
+	             dOutputMs,
+	             dLoad,
+	             dWorstLoad, dWorstMs,
+	             (uint32_t)newDeadlineMisses, (uint32_t)deadlineMisses,
+	             (uint32_t)audioStats.underruns,
+	             histogram[0], histogram[1], histogram[2],
+	             histogram[3], histogram[4], histogram[5],
+	             histogram[6], histogram[7], histogram[8],
+	             histogram[9], histogram[10]);
+
+	// periodic log for long sessions (stdout)
+	if (++audStatsSeconds >= AUDSTATS_LOG_SECONDS)
+	{
+		audStatsSeconds = 0;
+
+		printf("audio: replayer %.4fms, mixer %.4fms, output %.4fms, load %.2f%%, worst %.2f%% (%.3fms), " \
+		       "misses %u/%u, underruns %u\n",
+		       dReplayerMs, dMixMs, dOutputMs, dLoad, dWorstLoad, dWorstMs,
+		       (uint32_t)newDeadlineMisses, (uint32_t)deadlineMisses, (uint32_t)audioStats.underruns);
+		fflush(stdout);
+	}
+}
+
+static void drawAudioStats(void)
+{
+	if (editor.framesPassed < FPS_SCAN_FRAMES)
+		return; // the FPS counter box shows "Gathering frame information..." during this time
+
+	if ((editor.framesPassed % FPS_SCAN_FRAMES) == 0 || audStatsTextBuf[0] == '\0')
+		updateAudioStatsText();
+
+	drawStatsBox(AUDSTATS_RENDER_X, AUDSTATS_RENDER_Y, AUDSTATS_RENDER_W, AUDSTATS_RENDER_H, audStatsTextBuf);
+}
+
 void endFPSCounter(void)
 {
 	if (video.showFPSCounter && frameStartTime > 0)
@@ -191,6 +333,108 @@ void endFPSCounter(void)
 	}
 }
 
+void markDirtyRect(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	int32_t x2 = x + w;
+	int32_t y2 = y + h;
+
+	if (x < 0) x = 0;
+	if (y < 0) y = 0;
+	if (x2 > SCREEN_W) x2 = SCREEN_W;
+	if (y2 > SCREEN_H) y2 = SCREEN_H;
+
+	if (x >= x2)
+		return;
+
+	for (; y < y2; y++)
+	{
+		if (x < dirtyX1[y]) dirtyX1[y] = (int16_t)x;
+		if (x2 > dirtyX2[y]) dirtyX2[y] = (int16_t)x2;
+	}
+}
+
+// the whole texture gets uploaded (and presented) on the next frame, even if the frame buffer didn't change
+void markScreenDirty(void)
+{
+	for (int32_t y = 0; y < SCREEN_H; y++)
+	{
+		dirtyX1[y] = 0;
+		dirtyX2[y] = SCREEN_W;
+	}
+
+	textureIsStale = true;
+}
+
+/* Uploads the dirty parts of the frame buffer to the texture. Consecutive dirty lines with
+** overlapping spans are merged into one rectangle, and the lines in it that are still equal
+** to the texture's content are trimmed off. Returns false if the texture didn't change.
+*/
+static bool updateTexture(void)
+{
+	bool textureChanged = false;
+
+	int32_t y = 0;
+	while (y < SCREEN_H)
+	{
+		int32_t x1 = dirtyX1[y];
+		int32_t x2 = dirtyX2[y];
+
+		if (x1 >= x2) // line is clean
+		{
+			y++;
+			continue;
+		}
+
+		const int32_t y1 = y;
+		for (y++; y < SCREEN_H; y++)
+		{
+			if (dirtyX1[y] >= dirtyX2[y] || dirtyX1[y] >= x2 || dirtyX2[y] <= x1)
+				break;
+
+			x1 = MIN(x1, dirtyX1[y]);
+			x2 = MAX(x2, dirtyX2[y]);
+		}
+
+		const int32_t y2 = y;
+		const size_t spanBytes = (x2 - x1) * sizeof (int32_t);
+
+		int32_t changedY1 = -1, changedY2 = -1;
+		for (int32_t i = y1; i < y2; i++)
+		{
+			dirtyX1[i] = SCREEN_W; // mark line as clean
+			dirtyX2[i] = 0;
+
+			const uint32_t *src32 = &video.frameBuffer[(i * SCREEN_W) + x1];
+			uint32_t *dst32 = &textureBuffer[(i * SCREEN_W) + x1];
+
+			if (textureIsStale || memcmp(dst32, src32, spanBytes) != 0)
+			{
+				memcpy(dst32, src32, spanBytes);
+
+				if (changedY1 == -1)
+					changedY1 = i;
+				changedY2 = i;
+			}
+		}
+
+		if (changedY1 != -1)
+		{
+			const SDL_Rect rect = { x1, changedY1, x2 - x1, (changedY2 + 1) - changedY1 };
+			SDL_UpdateTexture(video.texture, &rect, &video.frameBuffer[(changedY1 * SCREEN_W) + x1], SCREEN_W * sizeof (int32_t));
+
+			textureChanged = true;
+		}
+	}
+
+	if (textureIsStale)
+	{
+		textureIsStale = false;
+		textureChanged = true; // present it even if nothing was dirty
+	}
+
+	return textureChanged;
+}
+
 void flipFrame(void)
 {
 	const uint32_t windowFlags = SDL_GetWindowFlags(video.window);
@@ -199,16 +443,22 @@ void flipFrame(void)
 	renderSprites();
 
 	if (video.showFPSCounter)
+	{
 		drawFPSCounter();
+		drawAudioStats();
+	}
 
-	SDL_UpdateTexture(video.texture, NULL, video.frameBuffer, SCREEN_W * sizeof (int32_t));
-
-	// SDL 2.0.14 bug on Windows (?): This function consumes ever-increasing memory if the program is minimized
-	if (!minimized)
-		SDL_RenderClear(video.renderer);
+	// only upload the changed parts of the frame, and don't present at all if nothing changed
+	const bool textureChanged = updateTexture();
+	if (textureChanged)
+	{
+		// SDL 2.0.14 bug on Windows (?): This function consumes ever-increasing memory if the program is minimized
+		if (!minimized)
+			SDL_RenderClear(video.renderer);
 
-	SDL_RenderCopy(video.renderer, video.texture, NULL, NULL);
-	SDL_RenderPresent(video.renderer);
+		SDL_RenderCopy(video.renderer, video.texture, NULL, NULL);
+		SDL_RenderPresent(video.renderer);
+	}
 
 	eraseSprites();
 
@@ -217,6 +467,16 @@ void flipFrame(void)
 		// we have no VSync, do crude thread sleeping to sync to ~60Hz
 		hpc_Wait(&video.vblankHpc);
 	}
+	else if (!textureChanged)
+	{
+		/* Nothing was presented, so there was no VSync wait either. Sleep instead, but restart
+		** the timer first if the last frame was synced by VSync (the timer is out of date then).
+		*/
+		if (lastFrameWasPresented)
+			hpc_ResetCounters(&video.vblankHpc);
+
+		hpc_Wait(&video.vblankHpc);
+	}
 	else
 	{
 		/* We have VSync, but it can unexpectedly get inactive in certain scenarios.
@@ -240,6 +500,7 @@ void flipFrame(void)
 #endif
 	}
 
+	lastFrameWasPresented = textureChanged;
 	editor.framesPassed++;
 
 	/* Reset audio/video sync timestamp every half an hour to prevent
@@ -548,6 +809,9 @@ void renderSprites(void)
 		if (i == SPRITE_LEFT_LOOP_PIN || i == SPRITE_RIGHT_LOOP_PIN)
 			continue; // these need special drawing (done elsewhere)
 
+		// the sprite was erased from its old position after the last frame, and is drawn again below
+		markDirtyRect(s->x, s->y, s->w, s->h);
+
 		// don't render the text edit cursor if window is inactive
 		if (i == SPRITE_TEXT_CURSOR)
 		{
@@ -564,6 +828,8 @@ void renderSprites(void)
 		if (s->x >= SCREEN_W || s->y >= SCREEN_H) // sprite is hidden, don't draw nor fill clear buffer
 			continue;
 
+		markDirtyRect(s->x, s->y, s->w, s->h);
+
 		assert(s->data != NULL && s->refreshBuffer != NULL);
 
 		int32_t sw = s->w;
@@ -665,12 +931,15 @@ void renderLoopPins(void)
 	sprite_t *s = &sprites[SPRITE_LEFT_LOOP_PIN];
 	assert(s->data != NULL && s->refreshBuffer != NULL);
 
+	markDirtyRect(s->x, s->y, s->w, s->h); // it was erased from its old position after the last frame
+
 	// set new sprite position
 	s->x = s->newX;
 	s->y = s->newY;
 
 	if (s->x < SCREEN_W) // loop pin shown?
 	{
+		markDirtyRect(s->x, s->y, s->w, s->h);
 		sw = s->w;
 		sh = s->h;
 		sx = s->x;
@@ -721,12 +990,15 @@ void renderLoopPins(void)
 	s = &sprites[SPRITE_RIGHT_LOOP_PIN];
 	assert(s->data != NULL && s->refreshBuffer != NULL);
 
+	markDirtyRect(s->x, s->y, s->w, s->h); // it was erased from its old position after the last frame
+
 	// set new sprite position
 	s->x = s->newX;
 	s->y = s->newY;
 
 	if (s->x < SCREEN_W) // loop pin shown?
 	{
+		markDirtyRect(s->x, s->y, s->w, s->h);
 		s->x = s->newX;
 		s->y = s->newY;
 
@@ -811,6 +1083,12 @@ void closeVideo(void)
 		free(video.frameBuffer);
 		video.frameBuffer = NULL;
 	}
+
+	if (textureBuffer != NULL)
+	{
+		free(textureBuffer);
+		textureBuffer = NULL;
+	}
 }
 
 void setWindowSizeFromConfig(bool updateRenderer)
@@ -931,6 +1209,8 @@ bool recreateTexture(void)
 	}
 
 	SDL_SetTextureBlendMode(video.texture, SDL_BLENDMODE_NONE);
+
+	markScreenDirty(); // the new texture is empty
 	return true;
 }
 
@@ -1022,7 +1302,8 @@ bool setupRenderer(void)
 
 	// framebuffer used by SDL (for texture)
 	video.frameBuffer = (uint32_t *)malloc(SCREEN_W * SCREEN_H * sizeof (int32_t));
-	if (video.frameBuffer == NULL)
+	textureBuffer = (uint32_t *)malloc(SCREEN_W * SCREEN_H * sizeof (int32_t));
+	if (video.frameBuffer == NULL || textureBuffer == NULL)
 	{
 		showErrorMsgBox("Not enough memory!");
 		return false;
@@ -1122,6 +1403,9 @@ void handleRedrawing(void)
 	else if (ui.sampleEditorShown)
 		handleSamplerRedrawing();
 
+	if (ui.diskOpShown)
+		diskOp_HandleFileInfo();
+
 	// blink text edit cursor
 	if (editor.editTextFlag && mouse.lastEditBox != -1)
 	{
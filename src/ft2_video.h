@@ -51,6 +51,8 @@ extern video_t video; // ft2_video.c
 void resetFPSCounter(void);
 void beginFPSCounter(void);
 void endFPSCounter(void);
+void markDirtyRect(int32_t x, int32_t y, int32_t w, int32_t h); // call after drawing to video.frameBuffer
+void markScreenDirty(void);
 void flipFrame(void);
 void showErrorMsgBox(const char *fmt, ...);
 void updateWindowTitle(bool forceUpdate);
@@ -326,22 +326,9 @@ static void updateVisuals(void)
 	ui.updatePatternEditor = true;
 }
 
-static int32_t SDLCALL renderWavThread(void *ptr)
+// returns the amount of rendered samples (both channels)
+static uint32_t dump_RenderSong(FILE *f, bool updateVisualsFlag, bool *overflowOut)
 {
-	(void)ptr;
-
-	FILE *f = (FILE *)editor.wavRendererFileHandle;
-	fseek(f, sizeof (wavHeader_t), SEEK_SET);
-
-	pauseAudio();
-
-	if (!dump_Init(WDFrequency, WDAmp, WDStartPos))
-	{
-		resumeAudio();
-		okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
-		return true;
-	}
-
 	uint32_t sampleCounter = 0;
 	bool overflow = false, renderDone = false;
 	uint8_t tickCounter = UPDATE_VISUALS_AT_TICK;
@@ -402,7 +389,7 @@ static int32_t SDLCALL renderWavThread(void *ptr)
 				break;
 			}
 
-			if (++tickCounter >= UPDATE_VISUALS_AT_TICK)
+			if (updateVisualsFlag && ++tickCounter >= UPDATE_VISUALS_AT_TICK)
 			{
 				tickCounter = 0;
 				updateVisuals();
@@ -419,6 +406,29 @@ static int32_t SDLCALL renderWavThread(void *ptr)
 		}
 	}
 
+	*overflowOut = overflow;
+	return sampleCounter;
+}
+
+static int32_t SDLCALL renderWavThread(void *ptr)
+{
+	(void)ptr;
+
+	FILE *f = (FILE *)editor.wavRendererFileHandle;
+	fseek(f, sizeof (wavHeader_t), SEEK_SET);
+
+	pauseAudio();
+
+	if (!dump_Init(WDFrequency, WDAmp, WDStartPos))
+	{
+		resumeAudio();
+		okBoxThreadSafe(0, "System message", "Not enough memory!", NULL);
+		return true;
+	}
+
+	bool overflow;
+	const uint32_t sampleCounter = dump_RenderSong(f, true, &overflow);
+
 	updateVisuals();
 	drawPlaybackTime(); // this is needed after the song stopped
 
@@ -432,6 +442,40 @@ static int32_t SDLCALL renderWavThread(void *ptr)
 	return true;
 }
 
+bool renderWavNoGUI(const char *filename, uint32_t freq, uint8_t bitDepth) // for command-line rendering
+{
+	FILE *f = fopen(filename, "wb");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Error: Couldn't open \"%s\" for writing!\n", filename);
+		return false;
+	}
+
+	WDFrequency = CLAMP(freq, MIN_WAV_RENDER_FREQ, MAX_WAV_RENDER_FREQ);
+	WDBitDepth = (bitDepth == 32) ? 32 : 16;
+	WDAmp = config.boostLevel;
+	WDStartPos = 0;
+	WDStopPos = (uint8_t)song.songLength - 1;
+
+	fseek(f, sizeof (wavHeader_t), SEEK_SET);
+
+	if (!dump_Init(WDFrequency, WDAmp, WDStartPos))
+	{
+		fclose(f);
+		fprintf(stderr, "Error: Not enough memory!\n");
+		return false;
+	}
+
+	bool overflow;
+	const uint32_t sampleCounter = dump_RenderSong(f, false, &overflow);
+	dump_Close(f, sampleCounter);
+
+	if (overflow)
+		fprintf(stderr, "Warning: Rendering stopped, file exceeded 2GB!\n");
+
+	return true;
+}
+
 static void wavRender(bool checkOverwrite)
 {
 	WDStartPos = (uint8_t)(MAX(0, MIN(WDStartPos, song.songLength - 1)));
@@ -33,3 +33,4 @@ void pbWavSongEndDown(void);
 void resetWavRenderer(void);
 void rbWavRenderBitDepth16(void);
 void rbWavRenderBitDepth32(void);
+bool renderWavNoGUI(const char *filename, uint32_t freq, uint8_t bitDepth); // for command-line rendering
@@ -4,6 +4,7 @@
 #include "ft2_mix_macros.h"
 #include "ft2_center_mix.h"
 #include "../ft2_cpu.h"
+#include "../ft2_structs.h" // cpu.hasAVX2/cpu.hasFMA
 
 /*
 ** ------------ 32-bit floating-point audio channel mixer ------------
@@ -14,6 +15,7 @@
 ** - FT2-styled linear volume ramping (can be turned off)
 ** - 32.32 (16.16 if 32-bit CPU) fixed-point precision for resampling delta/position
 ** - 32-bit floating-point precision for mixing and interpolation
+** - SSE2 (or AVX2/FMA, chosen at runtime) interpolation kernels on x86/x86_64 (ft2_mix_simd.h)
 **
 ** This file has separate routines for EVERY possible sampling variation:
 ** Interpolation none/sinc/linear/cubic, volumeramp on/off, 8-bit, 16-bit, no loop, loop, bidi.
@@ -3497,7 +3499,11 @@ static void mix16bRampBidiLoopCIntrp(voice_t *v, uint32_t bufferPos, uint32_t nu
 
 // -----------------------------------------------------------------------
 
-const mixFunc mixFuncTab[] =
+#ifdef MIXER_AVX2
+const mixFunc mixFuncTabAVX2[] = // ft2_mix_avx2.c (this file, compiled for AVX2/FMA)
+#else
+static const mixFunc mixFuncTabDefault[] =
+#endif
 {
 	/*
 	** ---------------------------------
@@ -3655,3 +3661,22 @@ const mixFunc mixFuncTab[] =
 	(mixFunc)centerMix16bRampLoopCIntrp,
 	(mixFunc)centerMix16bRampBidiLoopCIntrp
 };
+
+#ifndef MIXER_AVX2
+
+const mixFunc *mixFuncTab = mixFuncTabDefault;
+
+void selectMixFuncs(void) // called once on startup, after the CPU features have been detected
+{
+#if MIXER_HAS_AVX2
+	if (cpu.hasAVX2 && cpu.hasFMA)
+	{
+		mixFuncTab = mixFuncTabAVX2;
+		return;
+	}
+#endif
+
+	mixFuncTab = mixFuncTabDefault;
+}
+
+#endif
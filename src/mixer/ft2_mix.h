@@ -17,6 +17,34 @@
 #define MIXER_FRAC_SCALE ((intCPUWord_t)1 << MIXER_FRAC_BITS)
 #define MIXER_FRAC_MASK (MIXER_FRAC_SCALE-1)
 
+/* Mix buffer layout. 0 = separate L and R float arrays (audio.fMixBufferL/fMixBufferR),
+** 1 = one interleaved LRLR... array where audio.fMixBufferR = audio.fMixBufferL + 1.
+** Both are bit-exact, this only changes the memory access pattern of the mixer and output stage.
+** Off by default (the interleaved layout measured slower for linear and sinc16 interpolation in
+** ft2-mixbench), it can be turned on with the MIXER_INTERLEAVED_BUFFER option in CMakeLists.txt.
+*/
+#ifndef MIXER_INTERLEAVED_BUFFER
+#define MIXER_INTERLEAVED_BUFFER 0
+#endif
+
+#if MIXER_INTERLEAVED_BUFFER
+#define MIX_BUFFER_STRIDE 2
+#else
+#define MIX_BUFFER_STRIDE 1
+#endif
+
+// AVX2/FMA mixers (ft2_mix_avx2.c) are only built for x86_64
+#if defined __amd64__ || defined _M_X64
+#define MIXER_HAS_AVX2 1
+#else
+#define MIXER_HAS_AVX2 0
+#endif
+
 typedef void (*mixFunc)(void *, uint32_t, uint32_t);
 
-extern const mixFunc mixFuncTab[]; // ft2_mix.c
+extern const mixFunc *mixFuncTab; // ft2_mix.c
+#if MIXER_HAS_AVX2
+extern const mixFunc mixFuncTabAVX2[]; // ft2_mix_avx2.c
+#endif
+
+void selectMixFuncs(void);
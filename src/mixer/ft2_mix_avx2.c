@@ -0,0 +1,89 @@
+/* AVX2/FMA build of the channel mixers (ft2_mix.c and ft2_center_mix.c).
+**
+** The mixers are compiled a second time here with the AVX2/FMA interpolation kernels
+** from ft2_mix_simd.h, and selectMixFuncs() (ft2_mix.c) switches to this table on
+** startup if the CPU supports it. The center-mixing routines are exported from
+** ft2_center_mix.c, so they need to be renamed to not collide with the default ones.
+*/
+
+#include "ft2_mix.h"
+
+#if MIXER_HAS_AVX2
+
+#if defined __clang__
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined __GNUC__
+#pragma GCC target("avx2,fma")
+#endif
+
+#define MIXER_AVX2
+
+#define centerMix8bNoLoop centerMix8bNoLoopAVX2
+#define centerMix8bLoop centerMix8bLoopAVX2
+#define centerMix8bBidiLoop centerMix8bBidiLoopAVX2
+#define centerMix8bNoLoopS8Intrp centerMix8bNoLoopS8IntrpAVX2
+#define centerMix8bLoopS8Intrp centerMix8bLoopS8IntrpAVX2
+#define centerMix8bBidiLoopS8Intrp centerMix8bBidiLoopS8IntrpAVX2
+#define centerMix8bNoLoopLIntrp centerMix8bNoLoopLIntrpAVX2
+#define centerMix8bLoopLIntrp centerMix8bLoopLIntrpAVX2
+#define centerMix8bBidiLoopLIntrp centerMix8bBidiLoopLIntrpAVX2
+#define centerMix8bNoLoopS16Intrp centerMix8bNoLoopS16IntrpAVX2
+#define centerMix8bLoopS16Intrp centerMix8bLoopS16IntrpAVX2
+#define centerMix8bBidiLoopS16Intrp centerMix8bBidiLoopS16IntrpAVX2
+#define centerMix8bNoLoopCIntrp centerMix8bNoLoopCIntrpAVX2
+#define centerMix8bLoopCIntrp centerMix8bLoopCIntrpAVX2
+#define centerMix8bBidiLoopCIntrp centerMix8bBidiLoopCIntrpAVX2
+#define centerMix8bRampNoLoop centerMix8bRampNoLoopAVX2
+#define centerMix8bRampLoop centerMix8bRampLoopAVX2
+#define centerMix8bRampBidiLoop centerMix8bRampBidiLoopAVX2
+#define centerMix8bRampNoLoopS8Intrp centerMix8bRampNoLoopS8IntrpAVX2
+#define centerMix8bRampLoopS8Intrp centerMix8bRampLoopS8IntrpAVX2
+#define centerMix8bRampBidiLoopS8Intrp centerMix8bRampBidiLoopS8IntrpAVX2
+#define centerMix8bRampNoLoopLIntrp centerMix8bRampNoLoopLIntrpAVX2
+#define centerMix8bRampLoopLIntrp centerMix8bRampLoopLIntrpAVX2
+#define centerMix8bRampBidiLoopLIntrp centerMix8bRampBidiLoopLIntrpAVX2
+#define centerMix8bRampNoLoopS16Intrp centerMix8bRampNoLoopS16IntrpAVX2
+#define centerMix8bRampLoopS16Intrp centerMix8bRampLoopS16IntrpAVX2
+#define centerMix8bRampBidiLoopS16Intrp centerMix8bRampBidiLoopS16IntrpAVX2
+#define centerMix8bRampNoLoopCIntrp centerMix8bRampNoLoopCIntrpAVX2
+#define centerMix8bRampLoopCIntrp centerMix8bRampLoopCIntrpAVX2
+#define centerMix8bRampBidiLoopCIntrp centerMix8bRampBidiLoopCIntrpAVX2
+#define centerMix16bNoLoop centerMix16bNoLoopAVX2
+#define centerMix16bLoop centerMix16bLoopAVX2
+#define centerMix16bBidiLoop centerMix16bBidiLoopAVX2
+#define centerMix16bNoLoopS8Intrp centerMix16bNoLoopS8IntrpAVX2
+#define centerMix16bLoopS8Intrp centerMix16bLoopS8IntrpAVX2
+#define centerMix16bBidiLoopS8Intrp centerMix16bBidiLoopS8IntrpAVX2
+#define centerMix16bNoLoopLIntrp centerMix16bNoLoopLIntrpAVX2
+#define centerMix16bLoopLIntrp centerMix16bLoopLIntrpAVX2
+#define centerMix16bBidiLoopLIntrp centerMix16bBidiLoopLIntrpAVX2
+#define centerMix16bNoLoopS16Intrp centerMix16bNoLoopS16IntrpAVX2
+#define centerMix16bLoopS16Intrp centerMix16bLoopS16IntrpAVX2
+#define centerMix16bBidiLoopS16Intrp centerMix16bBidiLoopS16IntrpAVX2
+#define centerMix16bNoLoopCIntrp centerMix16bNoLoopCIntrpAVX2
+#define centerMix16bLoopCIntrp centerMix16bLoopCIntrpAVX2
+#define centerMix16bBidiLoopCIntrp centerMix16bBidiLoopCIntrpAVX2
+#define centerMix16bRampNoLoop centerMix16bRampNoLoopAVX2
+#define centerMix16bRampLoop centerMix16bRampLoopAVX2
+#define centerMix16bRampBidiLoop centerMix16bRampBidiLoopAVX2
+#define centerMix16bRampNoLoopS8Intrp centerMix16bRampNoLoopS8IntrpAVX2
+#define centerMix16bRampLoopS8Intrp centerMix16bRampLoopS8IntrpAVX2
+#define centerMix16bRampBidiLoopS8Intrp centerMix16bRampBidiLoopS8IntrpAVX2
+#define centerMix16bRampNoLoopLIntrp centerMix16bRampNoLoopLIntrpAVX2
+#define centerMix16bRampLoopLIntrp centerMix16bRampLoopLIntrpAVX2
+#define centerMix16bRampBidiLoopLIntrp centerMix16bRampBidiLoopLIntrpAVX2
+#define centerMix16bRampNoLoopS16Intrp centerMix16bRampNoLoopS16IntrpAVX2
+#define centerMix16bRampLoopS16Intrp centerMix16bRampLoopS16IntrpAVX2
+#define centerMix16bRampBidiLoopS16Intrp centerMix16bRampBidiLoopS16IntrpAVX2
+#define centerMix16bRampNoLoopCIntrp centerMix16bRampNoLoopCIntrpAVX2
+#define centerMix16bRampLoopCIntrp centerMix16bRampLoopCIntrpAVX2
+#define centerMix16bRampBidiLoopCIntrp centerMix16bRampBidiLoopCIntrpAVX2
+
+#include "ft2_center_mix.c"
+#include "ft2_mix.c"
+
+#if defined __clang__
+#pragma clang attribute pop
+#endif
+
+#endif
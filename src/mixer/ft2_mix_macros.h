@@ -2,6 +2,7 @@
 
 #include "../ft2_audio.h"
 #include "ft2_windowed_sinc.h"
+#include "ft2_mix_simd.h"
 
 /* ----------------------------------------------------------------------- */
 /*                          GENERAL MIXER MACROS                           */
@@ -31,15 +32,15 @@
 
 #define GET_MIXER_VARS \
 	const uintCPUWord_t delta = v->delta; \
-	fMixBufferL = audio.fMixBufferL + bufferPos; \
-	fMixBufferR = audio.fMixBufferR + bufferPos; \
+	fMixBufferL = audio.fMixBufferL + (bufferPos * MIX_BUFFER_STRIDE); \
+	fMixBufferR = audio.fMixBufferR + (bufferPos * MIX_BUFFER_STRIDE); \
 	position = v->position; \
 	positionFrac = v->positionFrac;
 
 #define GET_MIXER_VARS_RAMP \
 	const uintCPUWord_t delta = v->delta; \
-	fMixBufferL = audio.fMixBufferL + bufferPos; \
-	fMixBufferR = audio.fMixBufferR + bufferPos; \
+	fMixBufferL = audio.fMixBufferL + (bufferPos * MIX_BUFFER_STRIDE); \
+	fMixBufferR = audio.fMixBufferR + (bufferPos * MIX_BUFFER_STRIDE); \
 	fVolumeLDelta = v->fVolumeLDelta; \
 	fVolumeRDelta = v->fVolumeRDelta; \
 	position = v->position; \
@@ -47,8 +48,8 @@
 
 #define GET_MIXER_VARS_MONO_RAMP \
 	const uintCPUWord_t delta = v->delta; \
-	fMixBufferL = audio.fMixBufferL + bufferPos; \
-	fMixBufferR = audio.fMixBufferR + bufferPos; \
+	fMixBufferL = audio.fMixBufferL + (bufferPos * MIX_BUFFER_STRIDE); \
+	fMixBufferR = audio.fMixBufferR + (bufferPos * MIX_BUFFER_STRIDE); \
 	fVolumeLDelta = v->fVolumeLDelta; \
 	position = v->position; \
 	positionFrac = v->positionFrac;
@@ -96,6 +97,13 @@
 /*                          SAMPLE RENDERING MACROS                        */
 /* ----------------------------------------------------------------------- */
 
+// MIX_BUFFER_STRIDE is 2 with an interleaved LR mix buffer (see ft2_mix.h)
+#define ADD_TO_MIX_BUFFERS(fL, fR) \
+	*fMixBufferL += (fL); \
+	*fMixBufferR += (fR); \
+	fMixBufferL += MIX_BUFFER_STRIDE; \
+	fMixBufferR += MIX_BUFFER_STRIDE;
+
 #define VOLUME_RAMPING \
 	fVolumeL += fVolumeLDelta; \
 	fVolumeR += fVolumeRDelta;
@@ -105,23 +113,19 @@
 
 #define RENDER_8BIT_SMP \
 	fSample = *smpPtr * (1.0f / 128.0f); \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO \
 	fSample = (*smpPtr * (1.0f / 128.0f)) * fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP \
 	fSample = *smpPtr * (1.0f / 32768.0f); \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO \
 	fSample = (*smpPtr * (1.0f / 32768.0f)) * fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 /* ----------------------------------------------------------------------- */
 /*                          LINEAR INTERPOLATION                           */
@@ -140,25 +144,21 @@
 
 #define RENDER_8BIT_SMP_LINTRP \
 	LINEAR_INTERPOLATION(smpPtr, positionFrac, 128) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO_LINTRP \
 	LINEAR_INTERPOLATION(smpPtr, positionFrac, 128) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP_LINTRP \
 	LINEAR_INTERPOLATION(smpPtr, positionFrac, 32768) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO_LINTRP \
 	LINEAR_INTERPOLATION(smpPtr, positionFrac, 32768) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 /* ----------------------------------------------------------------------- */
 /*                       CUBIC SPLINE INTERPOLATION                        */
@@ -175,46 +175,36 @@
 */
 
 #if CUBIC_FSHIFT>=0
-#define CUBIC_SPLINE_INTERPOLATION(s, f, scale) \
+#define CUBIC_SPLINE_INTERPOLATION(s, f, bits) \
 { \
 	const float *t = fCubicSplineLUT + (((uint32_t)(f) >> CUBIC_SPLINE_FSHIFT) & CUBIC_SPLINE_FMASK); \
-	fSample = ((s[-1] * t[0]) + \
-	           ( s[0] * t[1]) + \
-	           ( s[1] * t[2]) + \
-	           ( s[2] * t[3])) * (1.0f / scale); \
+	fSample = cubicIntrp##bits##bit(s, t); \
 }
 #else
-#define CUBIC_SPLINE_INTERPOLATION(s, f, scale) \
+#define CUBIC_SPLINE_INTERPOLATION(s, f, bits) \
 { \
 	const float *t = fCubicSplineLUT + (((uint32_t)(f) << -CUBIC_SPLINE_FSHIFT) & CUBIC_SPLINE_FMASK); \
-	fSample = ((s[-1] * t[0]) + \
-	           ( s[0] * t[1]) + \
-	           ( s[1] * t[2]) + \
-	           ( s[2] * t[3])) * (1.0f / scale); \
+	fSample = cubicIntrp##bits##bit(s, t); \
 }
 #endif
 
 #define RENDER_8BIT_SMP_CINTRP \
-	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 128) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 8) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO_CINTRP \
-	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 128) \
+	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 8) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP_CINTRP \
-	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 32768) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 16) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO_CINTRP \
-	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 32768) \
+	CUBIC_SPLINE_INTERPOLATION(smpPtr, positionFrac, 16) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 
 /* Special left-edge case mixers to get proper tap data after one loop cycle.
@@ -223,29 +213,25 @@
 
 #define RENDER_8BIT_SMP_CINTRP_TAP_FIX  \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
-	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 128) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 8) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO_CINTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
-	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 128) \
+	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 8) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP_CINTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
-	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 16) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO_CINTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
-	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
+	CUBIC_SPLINE_INTERPOLATION(smpTapPtr, positionFrac, 16) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 /* ----------------------------------------------------------------------- */
 /*                       WINDOWED-SINC INTERPOLATION                       */
@@ -262,120 +248,68 @@
 */
 
 #if SINC8_FSHIFT>=0
-#define WINDOWED_SINC8_INTERPOLATION(s, f, scale) \
+#define WINDOWED_SINC8_INTERPOLATION(s, f, bits) \
 { \
 	const float *t = v->fSincLUT + (((uint32_t)(f) >> SINC8_FSHIFT) & SINC8_FMASK); \
-	fSample = ((s[-3] * t[0]) + \
-	           (s[-2] * t[1]) + \
-	           (s[-1] * t[2]) + \
-	           ( s[0] * t[3]) + \
-	           ( s[1] * t[4]) + \
-	           ( s[2] * t[5]) + \
-	           ( s[3] * t[6]) + \
-	           ( s[4] * t[7])) * (1.0f / scale); \
+	fSample = sinc8Intrp##bits##bit(s, t); \
 }
 #else
-#define WINDOWED_SINC8_INTERPOLATION(s, f, scale) \
+#define WINDOWED_SINC8_INTERPOLATION(s, f, bits) \
 { \
 	const float *t = v->fSincLUT + (((uint32_t)(f) << -SINC8_FSHIFT) & SINC8_FMASK); \
-	fSample = ((s[-3] * t[0]) + \
-	           (s[-2] * t[1]) + \
-	           (s[-1] * t[2]) + \
-	           ( s[0] * t[3]) + \
-	           ( s[1] * t[4]) + \
-	           ( s[2] * t[5]) + \
-	           ( s[3] * t[6]) + \
-	           ( s[4] * t[7])) * (1.0f / scale); \
+	fSample = sinc8Intrp##bits##bit(s, t); \
 }
 #endif
 
 #if SINC16_FSHIFT>=0
-#define WINDOWED_SINC16_INTERPOLATION(s, f, scale) \
+#define WINDOWED_SINC16_INTERPOLATION(s, f, bits) \
 { \
 	const float *t = v->fSincLUT + (((uint32_t)(f) >> SINC16_FSHIFT) & SINC16_FMASK); \
-	fSample = ((s[-7] * t[0]) + \
-	           (s[-6] * t[1]) + \
-	           (s[-5] * t[2]) + \
-	           (s[-4] * t[3]) + \
-	           (s[-3] * t[4]) + \
-	           (s[-2] * t[5]) + \
-	           (s[-1] * t[6]) + \
-	           ( s[0] * t[7]) + \
-	           ( s[1] * t[8]) + \
-	           ( s[2] * t[9]) + \
-	           ( s[3] * t[10]) + \
-	           ( s[4] * t[11]) + \
-	           ( s[5] * t[12]) + \
-	           ( s[6] * t[13]) + \
-	           ( s[7] * t[14]) + \
-	           ( s[8] * t[15])) * (1.0f / scale); \
+	fSample = sinc16Intrp##bits##bit(s, t); \
 }
 #else
-#define WINDOWED_SINC16_INTERPOLATION(s, f, scale) \
+#define WINDOWED_SINC16_INTERPOLATION(s, f, bits) \
 { \
 	const float *t = v->fSincLUT + (((uint32_t)(f) << -SINC16_FSHIFT) & SINC16_FMASK); \
-	fSample = ((s[-7] * t[0]) + \
-	           (s[-6] * t[1]) + \
-	           (s[-5] * t[2]) + \
-	           (s[-4] * t[3]) + \
-	           (s[-3] * t[4]) + \
-	           (s[-2] * t[5]) + \
-	           (s[-1] * t[6]) + \
-	           ( s[0] * t[7]) + \
-	           ( s[1] * t[8]) + \
-	           ( s[2] * t[9]) + \
-	           ( s[3] * t[10]) + \
-	           ( s[4] * t[11]) + \
-	           ( s[5] * t[12]) + \
-	           ( s[6] * t[13]) + \
-	           ( s[7] * t[14]) + \
-	           ( s[8] * t[15])) * (1.0f / scale); \
+	fSample = sinc16Intrp##bits##bit(s, t); \
 }
 #endif
 
 #define RENDER_8BIT_SMP_S8INTRP \
-	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 128) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 8) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO_S8INTRP \
-	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 128) \
+	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 8) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP_S8INTRP \
-	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 32768) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 16) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO_S8INTRP \
-	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 32768) \
+	WINDOWED_SINC8_INTERPOLATION(smpPtr, positionFrac, 16) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_8BIT_SMP_S16INTRP \
-	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 128) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 8) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO_S16INTRP \
-	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 128) \
+	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 8) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP_S16INTRP \
-	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 32768) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 16) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO_S16INTRP \
-	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 32768) \
+	WINDOWED_SINC16_INTERPOLATION(smpPtr, positionFrac, 16) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 /* Special left-edge case mixers to get proper tap data after one loop cycle.
 ** These are only used with sinc interpolation on looped samples.
@@ -383,55 +317,47 @@
 
 #define RENDER_8BIT_SMP_S8INTRP_TAP_FIX  \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
-	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 128) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 8) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO_S8INTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
-	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 128) \
+	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 8) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP_S8INTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
-	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 16) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO_S8INTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
-	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
+	WINDOWED_SINC8_INTERPOLATION(smpTapPtr, positionFrac, 16) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_8BIT_SMP_S16INTRP_TAP_FIX  \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
-	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 128) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 8) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_8BIT_SMP_MONO_S16INTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int8_t *)&v->leftEdgeTaps8[(int32_t)(smpPtr-loopStartPtr)] : (int8_t *)smpPtr; \
-	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 128) \
+	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 8) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 #define RENDER_16BIT_SMP_S16INTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
-	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
-	*fMixBufferL++ += fSample * fVolumeL; \
-	*fMixBufferR++ += fSample * fVolumeR;
+	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 16) \
+	ADD_TO_MIX_BUFFERS(fSample * fVolumeL, fSample * fVolumeR)
 
 #define RENDER_16BIT_SMP_MONO_S16INTRP_TAP_FIX \
 	smpTapPtr = (smpPtr <= leftEdgePtr) ? (int16_t *)&v->leftEdgeTaps16[(int32_t)(smpPtr-loopStartPtr)] : (int16_t *)smpPtr; \
-	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 32768) \
+	WINDOWED_SINC16_INTERPOLATION(smpTapPtr, positionFrac, 16) \
 	fSample *= fVolumeL; \
-	*fMixBufferL++ += fSample; \
-	*fMixBufferR++ += fSample;
+	ADD_TO_MIX_BUFFERS(fSample, fSample)
 
 /* ----------------------------------------------------------------------- */
 /*                      SAMPLES-TO-MIX LIMITING MACROS                     */
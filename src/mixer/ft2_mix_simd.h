@@ -0,0 +1,241 @@
+#pragma once
+
+/* Interpolation kernels for the mixer (cubic spline, 8-point and 16-point windowed-sinc).
+**
+** These return the interpolated sample point (dot product of taps and sample points),
+** normalized to -1.0f .. 1.0f. Three variants exist, selected at compile time:
+**
+** - MIXER_AVX2 defined: AVX2/FMA (only ft2_mix_avx2.c, picked at runtime by selectMixFuncs())
+** - x86/x86_64 with SSE2: SSE2 (always present, the program won't start without it)
+** - Other CPUs: plain C
+**
+** It may look like we are potentially going out of bounds while looking up the sample points,
+** but the sample data is padded on both sides (see ft2_mix_macros.h).
+*/
+
+#include <stdint.h>
+#include <string.h> // memcpy()
+
+#if defined MIXER_AVX2
+#include <immintrin.h>
+#define MIXER_SIMD_AVX2 1
+#elif defined _WIN32 || defined __amd64__ || (defined __i386__ && defined __SSE2__)
+#include <emmintrin.h>
+#define MIXER_SIMD_SSE2 1
+#endif
+
+#if defined MIXER_SIMD_AVX2 || defined MIXER_SIMD_SSE2
+
+static inline float hsum128(__m128 fSum)
+{
+	__m128 fShuf = _mm_shuffle_ps(fSum, fSum, _MM_SHUFFLE(2, 3, 0, 1));
+	fSum = _mm_add_ps(fSum, fShuf);
+	fShuf = _mm_movehl_ps(fShuf, fSum);
+	fSum = _mm_add_ss(fSum, fShuf);
+
+	return _mm_cvtss_f32(fSum);
+}
+
+#endif
+
+#if defined MIXER_SIMD_AVX2
+
+static inline float hsum256(__m256 fSum)
+{
+	return hsum128(_mm_add_ps(_mm256_castps256_ps128(fSum), _mm256_extractf128_ps(fSum, 1)));
+}
+
+static inline __m128 load4Smp8(const int8_t *s)
+{
+	int32_t smp32;
+	memcpy(&smp32, s, 4);
+
+	return _mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(smp32)));
+}
+
+static inline __m128 load4Smp16(const int16_t *s)
+{
+	return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)s)));
+}
+
+static inline __m256 load8Smp8(const int8_t *s)
+{
+	return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)s)));
+}
+
+static inline __m256 load8Smp16(const int16_t *s)
+{
+	return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)s)));
+}
+
+static inline float cubicIntrp8bit(const int8_t *s, const float *t)
+{
+	return hsum128(_mm_mul_ps(load4Smp8(&s[-1]), _mm_loadu_ps(t))) * (1.0f / 128.0f);
+}
+
+static inline float cubicIntrp16bit(const int16_t *s, const float *t)
+{
+	return hsum128(_mm_mul_ps(load4Smp16(&s[-1]), _mm_loadu_ps(t))) * (1.0f / 32768.0f);
+}
+
+static inline float sinc8Intrp8bit(const int8_t *s, const float *t)
+{
+	return hsum256(_mm256_mul_ps(load8Smp8(&s[-3]), _mm256_loadu_ps(t))) * (1.0f / 128.0f);
+}
+
+static inline float sinc8Intrp16bit(const int16_t *s, const float *t)
+{
+	return hsum256(_mm256_mul_ps(load8Smp16(&s[-3]), _mm256_loadu_ps(t))) * (1.0f / 32768.0f);
+}
+
+static inline float sinc16Intrp8bit(const int8_t *s, const float *t)
+{
+	__m256 fSum = _mm256_mul_ps(load8Smp8(&s[-7]), _mm256_loadu_ps(&t[0]));
+	fSum = _mm256_fmadd_ps(load8Smp8(&s[1]), _mm256_loadu_ps(&t[8]), fSum);
+
+	return hsum256(fSum) * (1.0f / 128.0f);
+}
+
+static inline float sinc16Intrp16bit(const int16_t *s, const float *t)
+{
+	__m256 fSum = _mm256_mul_ps(load8Smp16(&s[-7]), _mm256_loadu_ps(&t[0]));
+	fSum = _mm256_fmadd_ps(load8Smp16(&s[1]), _mm256_loadu_ps(&t[8]), fSum);
+
+	return hsum256(fSum) * (1.0f / 32768.0f);
+}
+
+#elif defined MIXER_SIMD_SSE2
+
+// SSE2 has no sign-extending loads, so widen by unpacking into the upper half and shifting down
+
+static inline __m128 load4Smp8(const int8_t *s)
+{
+	int32_t smp32;
+	memcpy(&smp32, s, 4);
+
+	__m128i smp = _mm_cvtsi32_si128(smp32);
+	smp = _mm_unpacklo_epi8(smp, smp);
+	smp = _mm_unpacklo_epi16(smp, smp);
+
+	return _mm_cvtepi32_ps(_mm_srai_epi32(smp, 24));
+}
+
+static inline __m128 load4Smp16(const int16_t *s)
+{
+	__m128i smp = _mm_loadl_epi64((const __m128i *)s);
+	smp = _mm_unpacklo_epi16(smp, smp);
+
+	return _mm_cvtepi32_ps(_mm_srai_epi32(smp, 16));
+}
+
+static inline void load8Smp8(const int8_t *s, __m128 *fLo, __m128 *fHi)
+{
+	__m128i smp = _mm_loadl_epi64((const __m128i *)s);
+	smp = _mm_unpacklo_epi8(smp, smp);
+
+	*fLo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(smp, smp), 24));
+	*fHi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(smp, smp), 24));
+}
+
+static inline void load8Smp16(const int16_t *s, __m128 *fLo, __m128 *fHi)
+{
+	const __m128i smp = _mm_loadu_si128((const __m128i *)s);
+
+	*fLo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(smp, smp), 16));
+	*fHi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(smp, smp), 16));
+}
+
+static inline float cubicIntrp8bit(const int8_t *s, const float *t)
+{
+	return hsum128(_mm_mul_ps(load4Smp8(&s[-1]), _mm_loadu_ps(t))) * (1.0f / 128.0f);
+}
+
+static inline float cubicIntrp16bit(const int16_t *s, const float *t)
+{
+	return hsum128(_mm_mul_ps(load4Smp16(&s[-1]), _mm_loadu_ps(t))) * (1.0f / 32768.0f);
+}
+
+static inline float sinc8Intrp8bit(const int8_t *s, const float *t)
+{
+	__m128 fLo, fHi;
+	load8Smp8(&s[-3], &fLo, &fHi);
+
+	const __m128 fSum = _mm_add_ps(_mm_mul_ps(fLo, _mm_loadu_ps(&t[0])), _mm_mul_ps(fHi, _mm_loadu_ps(&t[4])));
+	return hsum128(fSum) * (1.0f / 128.0f);
+}
+
+static inline float sinc8Intrp16bit(const int16_t *s, const float *t)
+{
+	__m128 fLo, fHi;
+	load8Smp16(&s[-3], &fLo, &fHi);
+
+	const __m128 fSum = _mm_add_ps(_mm_mul_ps(fLo, _mm_loadu_ps(&t[0])), _mm_mul_ps(fHi, _mm_loadu_ps(&t[4])));
+	return hsum128(fSum) * (1.0f / 32768.0f);
+}
+
+static inline float sinc16Intrp8bit(const int8_t *s, const float *t)
+{
+	__m128 fLo1, fHi1, fLo2, fHi2;
+	load8Smp8(&s[-7], &fLo1, &fHi1);
+	load8Smp8(&s[ 1], &fLo2, &fHi2);
+
+	const __m128 fSum1 = _mm_add_ps(_mm_mul_ps(fLo1, _mm_loadu_ps(&t[ 0])), _mm_mul_ps(fHi1, _mm_loadu_ps(&t[ 4])));
+	const __m128 fSum2 = _mm_add_ps(_mm_mul_ps(fLo2, _mm_loadu_ps(&t[ 8])), _mm_mul_ps(fHi2, _mm_loadu_ps(&t[12])));
+	return hsum128(_mm_add_ps(fSum1, fSum2)) * (1.0f / 128.0f);
+}
+
+static inline float sinc16Intrp16bit(const int16_t *s, const float *t)
+{
+	__m128 fLo1, fHi1, fLo2, fHi2;
+	load8Smp16(&s[-7], &fLo1, &fHi1);
+	load8Smp16(&s[ 1], &fLo2, &fHi2);
+
+	const __m128 fSum1 = _mm_add_ps(_mm_mul_ps(fLo1, _mm_loadu_ps(&t[ 0])), _mm_mul_ps(fHi1, _mm_loadu_ps(&t[ 4])));
+	const __m128 fSum2 = _mm_add_ps(_mm_mul_ps(fLo2, _mm_loadu_ps(&t[ 8])), _mm_mul_ps(fHi2, _mm_loadu_ps(&t[12])));
+	return hsum128(_mm_add_ps(fSum1, fSum2)) * (1.0f / 32768.0f);
+}
+
+#else // plain C
+
+#define CUBIC_SPLINE_DOT(s, t) \
+	((s[-1] * t[0]) + \
+	 ( s[0] * t[1]) + \
+	 ( s[1] * t[2]) + \
+	 ( s[2] * t[3]))
+
+#define WINDOWED_SINC8_DOT(s, t) \
+	((s[-3] * t[0]) + \
+	 (s[-2] * t[1]) + \
+	 (s[-1] * t[2]) + \
+	 ( s[0] * t[3]) + \
+	 ( s[1] * t[4]) + \
+	 ( s[2] * t[5]) + \
+	 ( s[3] * t[6]) + \
+	 ( s[4] * t[7]))
+
+#define WINDOWED_SINC16_DOT(s, t) \
+	((s[-7] * t[0]) + \
+	 (s[-6] * t[1]) + \
+	 (s[-5] * t[2]) + \
+	 (s[-4] * t[3]) + \
+	 (s[-3] * t[4]) + \
+	 (s[-2] * t[5]) + \
+	 (s[-1] * t[6]) + \
+	 ( s[0] * t[7]) + \
+	 ( s[1] * t[8]) + \
+	 ( s[2] * t[9]) + \
+	 ( s[3] * t[10]) + \
+	 ( s[4] * t[11]) + \
+	 ( s[5] * t[12]) + \
+	 ( s[6] * t[13]) + \
+	 ( s[7] * t[14]) + \
+	 ( s[8] * t[15]))
+
+static inline float cubicIntrp8bit(const int8_t *s, const float *t) { return CUBIC_SPLINE_DOT(s, t) * (1.0f / 128.0f); }
+static inline float cubicIntrp16bit(const int16_t *s, const float *t) { return CUBIC_SPLINE_DOT(s, t) * (1.0f / 32768.0f); }
+static inline float sinc8Intrp8bit(const int8_t *s, const float *t) { return WINDOWED_SINC8_DOT(s, t) * (1.0f / 128.0f); }
+static inline float sinc8Intrp16bit(const int16_t *s, const float *t) { return WINDOWED_SINC8_DOT(s, t) * (1.0f / 32768.0f); }
+static inline float sinc16Intrp8bit(const int8_t *s, const float *t) { return WINDOWED_SINC16_DOT(s, t) * (1.0f / 128.0f); }
+static inline float sinc16Intrp16bit(const int16_t *s, const float *t) { return WINDOWED_SINC16_DOT(s, t) * (1.0f / 32768.0f); }
+
+#endif
@@ -10,6 +10,9 @@
 #include <math.h>
 #include "ft2_windowed_sinc.h"
 #include "../ft2_video.h" // showErrorMsgBox()
+#ifdef HAS_PRECOMPUTED_SINC
+#include "ft2_windowed_sinc_data.h" // generated by ft2-sincgen (see CMakeLists.txt)
+#endif
 
 #define MY_PI 3.14159265358979323846264338327950288
 
@@ -20,6 +23,10 @@ float *fKaiserSinc_16 = NULL, *fDownSample1_16 = NULL, *fDownSample2_16 = NULL;
 // set based on selected sinc interpolator (8 point or 16 point)
 float *fKaiserSinc = NULL, *fDownSample1 = NULL, *fDownSample2 = NULL;
 
+#ifndef HAS_PRECOMPUTED_SINC
+
+static float *fSincTables; // all six tables, in one block (SINC_TABLES_SIZE)
+
 static double Izero(double y) // Compute Bessel function Izero(y) using a series approximation
 {
 	double s = 1.0, ds = 1.0, d = 0.0;
@@ -68,23 +75,43 @@ static void getSinc(uint32_t numTaps, float *fLUTPtr, const double beta, const d
 	}
 }
 
-bool calcWindowedSincTables(void)
-{ 
-	fKaiserSinc_8  = (float *)malloc(8*SINC_PHASES * sizeof (float));
-	fDownSample1_8 = (float *)malloc(8*SINC_PHASES * sizeof (float));
-	fDownSample2_8 = (float *)malloc(8*SINC_PHASES * sizeof (float));
+#endif
 
-	fKaiserSinc_16  = (float *)malloc(16*SINC_PHASES * sizeof (float));
-	fDownSample1_16 = (float *)malloc(16*SINC_PHASES * sizeof (float));
-	fDownSample2_16 = (float *)malloc(16*SINC_PHASES * sizeof (float));
+static void setTablePointers(float *fData)
+{
+	fKaiserSinc_8   = &fData[0*8*SINC_PHASES];
+	fDownSample1_8  = &fData[1*8*SINC_PHASES];
+	fDownSample2_8  = &fData[2*8*SINC_PHASES];
+	fKaiserSinc_16  = &fData[3*8*SINC_PHASES];
+	fDownSample1_16 = &fData[(3*8*SINC_PHASES) + (1*16*SINC_PHASES)];
+	fDownSample2_16 = &fData[(3*8*SINC_PHASES) + (2*16*SINC_PHASES)];
+}
 
-	if (fKaiserSinc_8  == NULL || fDownSample1_8  == NULL || fDownSample2_8  == NULL ||
-		fKaiserSinc_16 == NULL || fDownSample1_16 == NULL || fDownSample2_16 == NULL)
+#ifdef HAS_PRECOMPUTED_SINC
+
+bool calcWindowedSincTables(void) // the tables were generated at build time (ft2_sinc_gen.c)
+{
+	setTablePointers((float *)fSincTableData);
+	return true;
+}
+
+void freeWindowedSincTables(void)
+{
+}
+
+#else
+
+bool calcWindowedSincTables(void)
+{
+	fSincTables = (float *)malloc(SINC_TABLES_SIZE * sizeof (float));
+	if (fSincTables == NULL)
 	{
 		showErrorMsgBox("Not enough memory!");
 		return false;
 	}
 
+	setTablePointers(fSincTables);
+
 	getSinc(8, fKaiserSinc_8, 9.6377, 1.0);
 	getSinc(8, fDownSample1_8, 8.5, 0.5);
 	getSinc(8, fDownSample2_8, 7.3, 0.425);
@@ -98,39 +125,14 @@ bool calcWindowedSincTables(void)
 
 void freeWindowedSincTables(void)
 {
-	if (fKaiserSinc_8 != NULL)
-	{
-		free(fKaiserSinc_8);
-		fKaiserSinc_8 = NULL;
-	}
-
-	if (fDownSample1_8 != NULL)
-	{
-		free(fDownSample1_8);
-		fDownSample1_8 = NULL;
-	}
-
-	if (fDownSample2_8 != NULL)
-	{
-		free(fDownSample2_8);
-		fDownSample2_8 = NULL;
-	}
-
-	if (fKaiserSinc_16 != NULL)
-	{
-		free(fKaiserSinc_16);
-		fKaiserSinc_16 = NULL;
-	}
-
-	if (fDownSample1_16 != NULL)
+	if (fSincTables != NULL)
 	{
-		free(fDownSample1_16);
-		fDownSample1_16 = NULL;
+		free(fSincTables);
+		fSincTables = NULL;
 	}
 
-	if (fDownSample2_16 != NULL)
-	{
-		free(fDownSample2_16);
-		fDownSample2_16 = NULL;
-	}
+	fKaiserSinc_8 = fDownSample1_8 = fDownSample2_8 = NULL;
+	fKaiserSinc_16 = fDownSample1_16 = fDownSample2_16 = NULL;
 }
+
+#endif
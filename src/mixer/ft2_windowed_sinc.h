@@ -16,10 +16,17 @@
 #define SINC16_FSHIFT (MIXER_FRAC_BITS-(SINC_PHASES_BITS+SINC16_WIDTH_BITS))
 #define SINC16_FMASK ((16*SINC_PHASES)-16)
 
+// the 8-point tables followed by the 16-point tables (Kaiser, downsample 1, downsample 2), in floats
+#define SINC_TABLES_SIZE ((3*8*SINC_PHASES) + (3*16*SINC_PHASES))
+
 extern float *fKaiserSinc_8, *fDownSample1_8, *fDownSample2_8;
 extern float *fKaiserSinc_16, *fDownSample1_16, *fDownSample2_16;
 
 extern float *fKaiserSinc, *fDownSample1, *fDownSample2;
 
+/* Computes the tables on startup (the Bessel function series makes this take a while),
+** or just sets up the pointers if they were generated at build time (HAS_PRECOMPUTED_SINC).
+** fKaiserSinc_8 points to the start of all the tables (SINC_TABLES_SIZE floats).
+*/
 bool calcWindowedSincTables(void);
 void freeWindowedSincTables(void);
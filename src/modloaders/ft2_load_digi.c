@@ -44,9 +44,9 @@ digiHdr_t;
 #pragma pack(pop)
 #endif
 
-static void readPatternNote(FILE *f, note_t *p);
+static void readPatternNote(MEMFILE *f, note_t *p);
 
-bool loadDIGI(FILE *f, uint32_t filesize)
+bool loadDIGI(MEMFILE *f, uint32_t filesize)
 {
 	int16_t i, j, k;
 	sample_t *s;
@@ -61,7 +61,7 @@ bool loadDIGI(FILE *f, uint32_t filesize)
 	}
 
 	memset(&hdr, 0, sizeof (hdr));
-	if (fread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
+	if (mread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
 	{
 		loaderMsgBox("Error: This file is either not a module, or is not supported.");
 		return false;
@@ -103,8 +103,8 @@ bool loadDIGI(FILE *f, uint32_t filesize)
 			uint16_t pattSize;
 			uint8_t bitMasks[64];
 
-			fread(&pattSize, 2, 1, f); pattSize = SWAP16(pattSize);
-			fread(bitMasks, 1, 64, f);
+			mread(&pattSize, 2, 1, f); pattSize = SWAP16(pattSize);
+			mread(bitMasks, 1, 64, f);
 
 			for (j = 0; j < 64; j++)
 			{
@@ -225,7 +225,7 @@ bool loadDIGI(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		int32_t bytesRead = (int32_t)fread(s->dataPtr, 1, s->length, f);
+		int32_t bytesRead = (int32_t)mread(s->dataPtr, 1, s->length, f);
 		if (bytesRead < s->length)
 		{
 			int32_t bytesToClear = s->length - bytesRead;
@@ -236,10 +236,10 @@ bool loadDIGI(FILE *f, uint32_t filesize)
 	return true;
 }
 
-static void readPatternNote(FILE *f, note_t *p)
+static void readPatternNote(MEMFILE *f, note_t *p)
 {
 	uint8_t bytes[4];
-	fread(bytes, 1, 4, f);
+	mread(bytes, 1, 4, f);
 
 	// period to note
 	uint16_t period = ((bytes[0] & 0x0F) << 8) | bytes[1];
@@ -55,7 +55,7 @@ static uint8_t pattBuff[12288];
 
 static int8_t countS3MChannels(uint16_t antPtn);
 
-bool loadS3M(FILE *f, uint32_t filesize)
+bool loadS3M(MEMFILE *f, uint32_t filesize)
 {
 	uint8_t alastnfo[32], alastefx[32], alastvibnfo[32], s3mLastGInstr[32];
 	int16_t ii, kk, tmp;
@@ -74,7 +74,7 @@ bool loadS3M(FILE *f, uint32_t filesize)
 	}
 
 	memset(&hdr, 0, sizeof (hdr));
-	if (fread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
+	if (mread(&hdr, 1, sizeof (hdr), f) != sizeof (hdr))
 	{
 		loaderMsgBox("Error: This file is either not a module, or is not supported.");
 		return false;
@@ -88,7 +88,7 @@ bool loadS3M(FILE *f, uint32_t filesize)
 	}
 
 	memset(songTmp.orders, 255, 256); // pad by 255
-	if (fread(songTmp.orders, hdr.numOrders, 1, f) != 1)
+	if (mread(songTmp.orders, hdr.numOrders, 1, f) != 1)
 	{
 		loaderMsgBox("General I/O error during loading! Is the file in use?");
 		return false;
@@ -134,7 +134,7 @@ bool loadS3M(FILE *f, uint32_t filesize)
 	for (int32_t i = 0; i < hdr.numSamples; i++)
 	{
 		uint16_t offset;
-		if (fread(&offset, 2, 1, f) != 1)
+		if (mread(&offset, 2, 1, f) != 1)
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -147,7 +147,7 @@ bool loadS3M(FILE *f, uint32_t filesize)
 	for (int32_t i = 0; i < hdr.numPatterns; i++)
 	{
 		uint16_t offset;
-		if (fread(&offset, 2, 1, f) != 1)
+		if (mread(&offset, 2, 1, f) != 1)
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -169,11 +169,11 @@ bool loadS3M(FILE *f, uint32_t filesize)
 		memset(alastvibnfo, 0, sizeof (alastvibnfo));
 		memset(s3mLastGInstr, 0, sizeof (s3mLastGInstr));
 
-		fseek(f, patternOffsets[i], SEEK_SET);
-		if (feof(f))
+		mseek(f, patternOffsets[i], SEEK_SET);
+		if (meof(f))
 			continue;
 
-		if (fread(&j, 2, 1, f) != 1)
+		if (mread(&j, 2, 1, f) != 1)
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -187,7 +187,7 @@ bool loadS3M(FILE *f, uint32_t filesize)
 				return false;
 			}
 
-			fread(pattBuff, j, 1, f);
+			mread(pattBuff, j, 1, f);
 
 			k = 0;
 			kk = 0;
@@ -507,9 +507,9 @@ bool loadS3M(FILE *f, uint32_t filesize)
 		if (sampleOffsets[i] == 0)
 			continue;
 
-		fseek(f, sampleOffsets[i], SEEK_SET);
+		mseek(f, sampleOffsets[i], SEEK_SET);
 
-		if (fread(&smpHdr, 1, sizeof (smpHdr), f) != sizeof (smpHdr))
+		if (mread(&smpHdr, 1, sizeof (smpHdr), f) != sizeof (smpHdr))
 		{
 			loaderMsgBox("Not enough memory!");
 			return false;
@@ -587,15 +587,15 @@ bool loadS3M(FILE *f, uint32_t filesize)
 				if (hasLoop)
 					s->flags |= LOOP_FWD;
 
-				fseek(f, offsetInFile, SEEK_SET);
+				mseek(f, offsetInFile, SEEK_SET);
 
 				if (hdr.version == 1)
 				{
-					fseek(f, lengthInFile, SEEK_CUR); // sample not supported
+					mseek(f, lengthInFile, SEEK_CUR); // sample not supported
 				}
 				else
 				{
-					if (fread(s->dataPtr, SAMPLE_LENGTH_BYTES(s), 1, f) != 1)
+					if (mread(s->dataPtr, SAMPLE_LENGTH_BYTES(s), 1, f) != 1)
 					{
 						loaderMsgBox("General I/O error during loading! Is the file in use?");
 						return false;
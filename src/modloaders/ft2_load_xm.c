@@ -12,8 +12,20 @@
 #include "../ft2_sample_ed.h"
 #include "../ft2_tables.h"
 #include "../ft2_sysreqs.h"
+#include "../ft2_parallel.h"
+
+// sample data in the file that is delta decoded in parallel after all instruments are read
+typedef struct smpDecodeJob_t
+{
+	int8_t *dst;
+	const int8_t *src;
+	int32_t length; // as stored in the file (in samples)
+	uint8_t flags;
+} smpDecodeJob_t;
 
 static uint8_t packedPattData[65536];
+static int32_t numSmpDecodeJobs;
+static smpDecodeJob_t smpDecodeJobs[MAX_INST * MAX_SMP_PER_INST];
 
 /* ModPlug Tracker & OpenMPT supports up to 32 samples per instrument for XMs -  we don't.
 ** For such modules, we use a temporary array here to store the extra sample data lengths
@@ -21,14 +33,15 @@ static uint8_t packedPattData[65536];
 */
 static uint32_t extraSampleLengths[32-MAX_SMP_PER_INST];
 
-static bool loadInstrHeader(FILE *f, uint16_t i);
-static bool loadInstrSample(FILE *f, uint16_t i);
+static bool loadInstrHeader(MEMFILE *f, uint16_t i);
+static bool loadInstrSample(MEMFILE *f, uint16_t i);
 static void unpackPatt(uint8_t *dst, uint8_t *src, uint16_t len, int32_t antChn);
-static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion);
+static bool loadPatterns(MEMFILE *f, uint16_t antPtn, uint16_t xmVersion);
 static void unpackPatt(uint8_t *dst, uint8_t *src, uint16_t len, int32_t antChn);
-static void loadADPCMSample(FILE *f, sample_t *s); // ModPlug Tracker
+static void loadADPCMSample(MEMFILE *f, sample_t *s); // ModPlug Tracker
+static void decodeSamples(void);
 
-bool loadXM(FILE *f, uint32_t filesize)
+bool loadXM(MEMFILE *f, uint32_t filesize)
 {
 	xmHdr_t h;
 
@@ -38,7 +51,7 @@ bool loadXM(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	if (fread(&h, 1, sizeof (h), f) != sizeof (h))
+	if (mread(&h, 1, sizeof (h), f) != sizeof (h))
 	{
 		loaderMsgBox("Error: This file is either not a module, or is not supported.");
 		return false;
@@ -74,8 +87,8 @@ bool loadXM(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	fseek(f, 60 + h.headerSize, SEEK_SET);
-	if (filesize != 336 && feof(f)) // 336 in length at this point = empty XM
+	mseek(f, 60 + h.headerSize, SEEK_SET);
+	if (filesize != 336 && meof(f)) // 336 in length at this point = empty XM
 	{
 		loaderMsgBox("Error loading XM: The module is empty!");
 		return false;
@@ -84,9 +97,11 @@ bool loadXM(FILE *f, uint32_t filesize)
 	memcpy(songTmp.name, h.name, 20);
 	songTmp.name[20] = '\0';
 
+	numSmpDecodeJobs = 0;
+
 	songTmp.songLength = h.numOrders;
 	songTmp.songLoopStart = h.songLoopStart;
-	songTmp.numChannels = (uint8_t)h.numChannels;
+	songTmp.numChannels = h.numChannels;
 	songTmp.BPM = h.BPM;
 	songTmp.speed = h.speed;
 	tmpLinearPeriodsFlag = h.flags & 1;
@@ -146,6 +161,8 @@ bool loadXM(FILE *f, uint32_t filesize)
 		}
 	}
 
+	decodeSamples();
+
 	// if we temporarily loaded more than 128 instruments, clear the extra allocated memory
 	if (h.numInstr > MAX_INST)
 	{
@@ -176,7 +193,7 @@ bool loadXM(FILE *f, uint32_t filesize)
 	if (songTmp.numChannels > MAX_CHANNELS)
 	{
 		songTmp.numChannels = MAX_CHANNELS;
-		loaderMsgBox("Warning: Module contains >32 channels. The extra channels will be discarded!");
+		loaderMsgBox("Warning: Module contains >%d channels. The extra channels will be discarded!", MAX_CHANNELS);
 	}
 
 	if (h.numInstr > MAX_INST)
@@ -188,7 +205,7 @@ bool loadXM(FILE *f, uint32_t filesize)
 	return true;
 }
 
-static bool loadInstrHeader(FILE *f, uint16_t i)
+static bool loadInstrHeader(MEMFILE *f, uint16_t i)
 {
 	uint32_t readSize;
 	xmInsHdr_t ih;
@@ -199,8 +216,8 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 	memset(extraSampleLengths, 0, sizeof (extraSampleLengths));
 	memset(&ih, 0, sizeof (ih));
 
-	fread(&readSize, 4, 1, f);
-	fseek(f, -4, SEEK_CUR);
+	mread(&readSize, 4, 1, f);
+	mseek(f, -4, SEEK_CUR);
 
 	// yes, some XMs can have a header size of 0, and it usually means 263 bytes (INSTR_HEADER_SIZE)
 	if (readSize == 0 || readSize > INSTR_HEADER_SIZE)
@@ -212,11 +229,11 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 		return false;
 	}
 
-	fread(&ih, readSize, 1, f); // read instrument header
+	mread(&ih, readSize, 1, f); // read instrument header
 
 	// FT2 bugfix: skip instrument header data if instrSize is above INSTR_HEADER_SIZE
 	if (ih.instrSize > INSTR_HEADER_SIZE)
-		fseek(f, ih.instrSize-INSTR_HEADER_SIZE, SEEK_CUR);
+		mseek(f, ih.instrSize-INSTR_HEADER_SIZE, SEEK_CUR);
 
 	if (ih.numSamples < 0 || ih.numSamples > 32)
 	{
@@ -267,7 +284,7 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 		if (sampleHeadersToRead > MAX_SMP_PER_INST)
 			sampleHeadersToRead = MAX_SMP_PER_INST;
 
-		if (fread(ih.smp, sampleHeadersToRead * sizeof (xmSmpHdr_t), 1, f) != 1)
+		if (mread(ih.smp, sampleHeadersToRead * sizeof (xmSmpHdr_t), 1, f) != 1)
 		{
 			loaderMsgBox("General I/O error during loading!");
 			return false;
@@ -279,8 +296,8 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 			const int32_t samplesToSkip = ih.numSamples-MAX_SMP_PER_INST;
 			for (int32_t j = 0; j < samplesToSkip; j++)
 			{
-				fread(&extraSampleLengths[j], 4, 1, f); // used for skipping data in loadInstrSample()
-				fseek(f, sizeof (xmSmpHdr_t)-4, SEEK_CUR);
+				mread(&extraSampleLengths[j], 4, 1, f); // used for skipping data in loadInstrSample()
+				mseek(f, sizeof (xmSmpHdr_t)-4, SEEK_CUR);
 			}
 		}
 
@@ -315,7 +332,7 @@ static bool loadInstrHeader(FILE *f, uint16_t i)
 	return true;
 }
 
-static bool loadInstrSample(FILE *f, uint16_t i)
+static bool loadInstrSample(MEMFILE *f, uint16_t i)
 {
 	if (instrTmp[i] == NULL)
 		return true; // empty instrument, let's just pretend it got loaded successfully
@@ -331,7 +348,7 @@ static bool loadInstrSample(FILE *f, uint16_t i)
 		for (uint16_t j = 0; j < k; j++, s++)
 		{
 			if (s->length > 0)
-				fseek(f, s->length, SEEK_CUR);
+				mseek(f, s->length, SEEK_CUR);
 		}
 	}
 	else
@@ -363,33 +380,65 @@ static bool loadInstrSample(FILE *f, uint16_t i)
 				if (s->length > MAX_SAMPLE_LEN)
 					s->length = MAX_SAMPLE_LEN;
 
-				if (!allocateSmpData(s, s->length, sample16Bit))
-				{
-					loaderMsgBox("Not enough memory!");
-					return false;
-				}
+				const int32_t sampleLengthInBytes = SAMPLE_LENGTH_BYTES(s);
 
-				if (adpcmSample)
+				/* If all of the sample data is in the file, decode it straight from there into the final
+				** buffer. This is done later on for all samples at once (see decodeSamples()).
+				*/
+				const int8_t *smpDataInFile = NULL;
+				if (!adpcmSample)
+					smpDataInFile = (const int8_t *)mreadptr(f, sampleLengthInBytes);
+
+				if (smpDataInFile != NULL)
 				{
-					loadADPCMSample(f, s);
+					const int32_t lengthToDecode = s->length;
+					if (stereoSample) // downmixed to mono in delta2SampFrom()
+					{
+						s->length >>= 1;
+						s->loopStart >>= 1;
+						s->loopLength >>= 1;
+					}
+
+					if (!allocateSmpData(s, s->length, sample16Bit))
+					{
+						loaderMsgBox("Not enough memory!");
+						return false;
+					}
+
+					smpDecodeJob_t *job = &smpDecodeJobs[numSmpDecodeJobs++];
+					job->dst = s->dataPtr;
+					job->src = smpDataInFile;
+					job->length = lengthToDecode;
+					job->flags = s->flags;
+
+					if (sampleLengthInBytes < lengthInFile)
+						mseek(f, lengthInFile-sampleLengthInBytes, SEEK_CUR);
 				}
 				else
 				{
-					const int32_t sampleLengthInBytes = SAMPLE_LENGTH_BYTES(s);
-					fread(s->dataPtr, 1, sampleLengthInBytes, f);
-
-					if (sampleLengthInBytes < lengthInFile)
-						fseek(f, lengthInFile-sampleLengthInBytes, SEEK_CUR);
-
-					delta2Samp(s->dataPtr, s->length, s->flags);
+					if (!allocateSmpData(s, s->length, sample16Bit))
+					{
+						loaderMsgBox("Not enough memory!");
+						return false;
+					}
 
-					if (stereoSample) // stereo sample - already downmixed to mono in delta2samp()
+					if (adpcmSample)
 					{
-						s->length >>= 1;
-						s->loopStart >>= 1;
-						s->loopLength >>= 1;
+						loadADPCMSample(f, s);
+					}
+					else // the file is cut off
+					{
+						mread(s->dataPtr, 1, sampleLengthInBytes, f);
+						delta2Samp(s->dataPtr, s->length, s->flags);
 
-						reallocateSmpData(s, s->length, sample16Bit); // dealloc unused memory
+						if (stereoSample) // stereo sample - already downmixed to mono in delta2samp()
+						{
+							s->length >>= 1;
+							s->loopStart >>= 1;
+							s->loopLength >>= 1;
+
+							reallocateSmpData(s, s->length, sample16Bit); // dealloc unused memory
+						}
 					}
 				}
 			}
@@ -407,14 +456,14 @@ static bool loadInstrSample(FILE *f, uint16_t i)
 		for (i = 0; i < samplesToSkip; i++)
 		{
 			if (extraSampleLengths[i] > 0)
-				fseek(f, extraSampleLengths[i], SEEK_CUR); 
+				mseek(f, extraSampleLengths[i], SEEK_CUR); 
 		}
 	}
 
 	return true;
 }
 
-static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion)
+static bool loadPatterns(MEMFILE *f, uint16_t antPtn, uint16_t xmVersion)
 {
 	uint8_t tmpLen;
 	xmPatHdr_t ph;
@@ -422,39 +471,39 @@ static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion)
 	bool pattLenWarn = false;
 	for (uint16_t i = 0; i < antPtn; i++)
 	{
-		if (fread(&ph.headerSize, 4, 1, f) != 1)
+		if (mread(&ph.headerSize, 4, 1, f) != 1)
 			goto pattCorrupt;
 
-		if (fread(&ph.type, 1, 1, f) != 1)
+		if (mread(&ph.type, 1, 1, f) != 1)
 			goto pattCorrupt;
 
 		ph.numRows = 0;
 		if (xmVersion == 0x0102)
 		{
-			if (fread(&tmpLen, 1, 1, f) != 1)
+			if (mread(&tmpLen, 1, 1, f) != 1)
 				goto pattCorrupt;
 
-			if (fread(&ph.dataSize, 2, 1, f) != 1)
+			if (mread(&ph.dataSize, 2, 1, f) != 1)
 				goto pattCorrupt;
 
 			ph.numRows = tmpLen + 1; // +1 in v1.02
 
 			if (ph.headerSize > 8)
-				fseek(f, ph.headerSize - 8, SEEK_CUR);
+				mseek(f, ph.headerSize - 8, SEEK_CUR);
 		}
 		else
 		{
-			if (fread(&ph.numRows, 2, 1, f) != 1)
+			if (mread(&ph.numRows, 2, 1, f) != 1)
 				goto pattCorrupt;
 
-			if (fread(&ph.dataSize, 2, 1, f) != 1)
+			if (mread(&ph.dataSize, 2, 1, f) != 1)
 				goto pattCorrupt;
 
 			if (ph.headerSize > 9)
-				fseek(f, ph.headerSize - 9, SEEK_CUR);
+				mseek(f, ph.headerSize - 9, SEEK_CUR);
 		}
 
-		if (feof(f))
+		if (meof(f))
 			goto pattCorrupt;
 
 		patternNumRowsTmp[i] = ph.numRows;
@@ -472,7 +521,7 @@ static bool loadPatterns(FILE *f, uint16_t antPtn, uint16_t xmVersion)
 				return false;
 			}
 
-			if (fread(packedPattData, 1, ph.dataSize, f) != ph.dataSize)
+			if (mread(packedPattData, 1, ph.dataSize, f) != ph.dataSize)
 				goto pattCorrupt;
 
 			unpackPatt((uint8_t *)patternTmp[i], packedPattData, patternNumRowsTmp[i], songTmp.numChannels);
@@ -576,10 +625,10 @@ static void unpackPatt(uint8_t *dst, uint8_t *src, uint16_t len, int32_t antChn)
 	}
 }
 
-static void loadADPCMSample(FILE *f, sample_t *s) // ModPlug Tracker
+static void loadADPCMSample(MEMFILE *f, sample_t *s) // ModPlug Tracker
 {
 	int8_t deltaLUT[16];
-	fread(deltaLUT, 1, 16, f);
+	mread(deltaLUT, 1, 16, f);
 
 	int8_t *dataPtr = s->dataPtr;
 	const int32_t dataLength = (s->length + 1) / 2;
@@ -587,7 +636,7 @@ static void loadADPCMSample(FILE *f, sample_t *s) // ModPlug Tracker
 	int8_t currSample = 0;
 	for (int32_t i = 0; i < dataLength; i++)
 	{
-		const uint8_t nibbles = (uint8_t)fgetc(f);
+		const uint8_t nibbles = (uint8_t)mgetc(f);
 
 		currSample += deltaLUT[nibbles & 0x0F];
 		*dataPtr++ = currSample;
@@ -596,3 +645,34 @@ static void loadADPCMSample(FILE *f, sample_t *s) // ModPlug Tracker
 		*dataPtr++ = currSample;
 	}
 }
+
+static int compareJobLength(const void *a, const void *b)
+{
+	const smpDecodeJob_t *jobA = (const smpDecodeJob_t *)a;
+	const smpDecodeJob_t *jobB = (const smpDecodeJob_t *)b;
+
+	const int32_t lengthA = SAMPLE_LENGTH_BYTES(jobA);
+	const int32_t lengthB = SAMPLE_LENGTH_BYTES(jobB);
+
+	return (lengthA < lengthB) - (lengthA > lengthB); // biggest first
+}
+
+static void decodeSampleJob(void *userData, int32_t jobIndex)
+{
+	const smpDecodeJob_t *job = &((const smpDecodeJob_t *)userData)[jobIndex];
+	delta2SampFrom(job->dst, job->src, job->length, job->flags);
+}
+
+/* The samples are independent of each other, so they are decoded on all CPU cores.
+** The source data is in the module file (still opened by the module loader).
+*/
+static void decodeSamples(void)
+{
+	if (numSmpDecodeJobs == 0)
+		return;
+
+	qsort(smpDecodeJobs, numSmpDecodeJobs, sizeof (smpDecodeJob_t), compareJobLength);
+	runParallelJobs(decodeSampleJob, smpDecodeJobs, numSmpDecodeJobs);
+
+	numSmpDecodeJobs = 0;
+}
@@ -3,6 +3,7 @@
 #include <crtdbg.h>
 #endif
 
+#include <stdio.h> // sprintf()
 #include <stdint.h>
 #include <stdbool.h>
 #include <math.h> // modf()
@@ -29,6 +30,13 @@ static hpc_t scopeHpc;
 static volatile scope_t scope[MAX_CHANNELS];
 static SDL_Thread *scopeThread;
 
+// per-voice mixing cost overlay (CTRL+SHIFT+P)
+#define VOICE_PROFILE_FRAMES 30 // update interval in video frames
+
+static uint32_t voiceProfileFrames;
+static uint64_t lastVoiceTime64[MAX_CHANNELS], lastVoiceProfileTime64;
+static float fVoiceLoad[MAX_CHANNELS], fMaxVoiceLoad; // in percent of one CPU core
+
 lastChInstr_t lastChInstr[MAX_CHANNELS]; // global
 
 int32_t getSamplePosition(uint8_t ch)
@@ -65,6 +73,22 @@ void stopAllScopes(void)
 	while (scopesDisplayingFlag);
 }
 
+// used by freeRetiredSmpData() (ft2_sample_ed.c), audio thread must be locked (no scope triggers)
+bool isSmpDataUsedByScopes(const int8_t *dataPtr)
+{
+	// wait for scopes to finish updating (they write back their own copy of the scope state)
+	while (scopesUpdatingFlag);
+
+	volatile scope_t *sc = scope;
+	for (int32_t i = 0; i < MAX_CHANNELS; i++, sc++)
+	{
+		if (sc->active && (sc->base8 == dataPtr || sc->base16 == (const int16_t *)dataPtr))
+			return true;
+	}
+
+	return false;
+}
+
 // toggle mute
 static void setChannel(int32_t chNr, bool on)
 {
@@ -122,11 +146,20 @@ static void drawScopeNumber(uint16_t scopeXOffs, uint16_t scopeYOffs, uint8_t ch
 	}
 }
 
+static int32_t getNumScopes(void) // scopes are only shown for the first MAX_SCOPES channels
+{
+	return (song.numChannels > MAX_SCOPES) ? MAX_SCOPES : song.numChannels;
+}
+
 static void redrawScope(int32_t ch)
 {
 	int32_t i;
 
-	int32_t chansPerRow = (uint32_t)song.numChannels >> 1;
+	const int32_t numScopes = getNumScopes();
+	if (ch >= numScopes)
+		return;
+
+	int32_t chansPerRow = (uint32_t)numScopes >> 1;
 	int32_t chanLookup = chansPerRow - 1;
 	const uint16_t *scopeLens = scopeLenTab[chanLookup];
 
@@ -136,7 +169,7 @@ static void redrawScope(int32_t ch)
 	uint16_t y = 94;
 
 	uint16_t scopeLen = 0; // prevent compiler warning
-	for (i = 0; i < song.numChannels; i++)
+	for (i = 0; i < numScopes; i++)
 	{
 		scopeLen = scopeLens[i];
 
@@ -177,6 +210,80 @@ void refreshScopes(void)
 		scope[i].wasCleared = false;
 }
 
+void toggleVoiceProfiler(void)
+{
+	for (int32_t i = 0; i < MAX_CHANNELS; i++)
+	{
+		lastVoiceTime64[i] = audioStats.voiceTime64[i];
+		fVoiceLoad[i] = 0.0f;
+	}
+
+	fMaxVoiceLoad = 0.0f;
+	voiceProfileFrames = 0;
+	lastVoiceProfileTime64 = SDL_GetPerformanceCounter();
+
+	audioStats.profileVoices = !audioStats.profileVoices;
+	refreshScopes();
+}
+
+static void updateVoiceProfile(void)
+{
+	if (++voiceProfileFrames < VOICE_PROFILE_FRAMES)
+		return;
+
+	voiceProfileFrames = 0;
+
+	const uint64_t time64 = SDL_GetPerformanceCounter();
+	if (time64 <= lastVoiceProfileTime64)
+		return;
+
+	const double dMul = 100.0 / (time64 - lastVoiceProfileTime64);
+	lastVoiceProfileTime64 = time64;
+
+	fMaxVoiceLoad = 0.0f;
+	for (int32_t i = 0; i < MAX_CHANNELS; i++)
+	{
+		const uint64_t voiceTime64 = audioStats.voiceTime64[i];
+
+		fVoiceLoad[i] = (float)((voiceTime64 - lastVoiceTime64[i]) * dMul);
+		if (fVoiceLoad[i] > fMaxVoiceLoad)
+			fMaxVoiceLoad = fVoiceLoad[i];
+
+		lastVoiceTime64[i] = voiceTime64;
+	}
+}
+
+// bar relative to the heaviest channel, plus the CPU load in percent if the scope is wide enough
+static void drawVoiceProfile(int32_t ch, uint16_t scopeXOffs, uint16_t scopeYOffs, uint16_t scopeDrawLen)
+{
+	char text[16];
+
+	if (fMaxVoiceLoad > 0.0f)
+	{
+		const uint16_t barLen = (uint16_t)((fVoiceLoad[ch] / fMaxVoiceLoad) * scopeDrawLen);
+		if (barLen > 0)
+			fillRect(scopeXOffs, scopeYOffs + (SCOPE_HEIGHT-2), barLen, 2, PAL_MOUSEPT);
+	}
+
+	sprintf(text, "%.1f%%", fVoiceLoad[ch]);
+
+	uint16_t textW = 0;
+	for (const char *textPtr = text; *textPtr != '\0'; textPtr++)
+		textW += charWidth(*textPtr) + 1;
+
+	if (textW+17 <= scopeDrawLen) // leave room for the channel number
+	{
+		uint16_t x = scopeXOffs + (scopeDrawLen - textW);
+		for (const char *textPtr = text; *textPtr != '\0'; textPtr++)
+		{
+			charOutOutlined(x, scopeYOffs + 1, PAL_MOUSEPT, *textPtr);
+			x += charWidth(*textPtr) + 1;
+		}
+	}
+
+	scope[ch].wasCleared = false; // inactive scopes must be cleared again next frame
+}
+
 static void channelMode(int32_t chn)
 {
 	int32_t i;
@@ -250,7 +357,7 @@ bool testScopesMouseDown(void)
 		if (mouse.y > 130 && mouse.y < 134)
 			return true;
 
-		int32_t chansPerRow = (uint32_t)song.numChannels >> 1;
+		int32_t chansPerRow = (uint32_t)getNumScopes() >> 1;
 		const uint16_t *scopeLens = scopeLenTab[chansPerRow-1];
 
 		// find out if we clicked inside a scope
@@ -402,14 +509,19 @@ static void updateScopes(void)
 void drawScopes(void)
 {
 	scopesDisplayingFlag = true;
-	int32_t chansPerRow = (uint32_t)song.numChannels >> 1;
+	const int32_t numScopes = getNumScopes();
+	int32_t chansPerRow = (uint32_t)numScopes >> 1;
 
 	const uint16_t *scopeLens = scopeLenTab[chansPerRow-1];
 	uint16_t scopeXOffs = 3;
 	uint16_t scopeYOffs = 95;
 	int16_t scopeLineY = 112;
 
-	for (int32_t i = 0; i < song.numChannels; i++)
+	const bool voiceProfilerShown = audioStats.profileVoices;
+	if (voiceProfilerShown)
+		updateVoiceProfile();
+
+	for (int32_t i = 0; i < numScopes; i++)
 	{
 		// if we reached the last scope on the row, go to first scope on the next row
 		if (i == chansPerRow)
@@ -463,6 +575,9 @@ void drawScopes(void)
 		if (config.multiRecChn[i])
 			blit(scopeXOffs + 1, scopeYOffs + 31, bmp.scopeRec, 13, 4);
 
+		if (voiceProfilerShown)
+			drawVoiceProfile(i, scopeXOffs, scopeYOffs, scopeDrawLen);
+
 		scopeXOffs += scopeDrawLen+3; // align x to next scope
 	}
 
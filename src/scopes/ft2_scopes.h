@@ -23,7 +23,9 @@
 
 int32_t getSamplePosition(uint8_t ch);
 void stopAllScopes(void);
+bool isSmpDataUsedByScopes(const int8_t *dataPtr);
 void refreshScopes(void);
+void toggleVoiceProfiler(void);
 bool testScopesMouseDown(void);
 void drawScopes(void);
 void drawScopeFramework(void);
@@ -19,7 +19,7 @@ static int32_t block2sampSize(const int64_t in);
 static int16_t fixedMath16_16(const int32_t in, const int64_t numerator, const int32_t denominator);
 static void filterCoeff(const int16_t sample1, const int16_t sample2, int16_t* sampCoeff1, int16_t* sampCoeff2, const int8_t filterType);
 
-bool loadBRR(FILE* f, uint32_t filesize)
+bool loadBRR(MEMFILE* f, uint32_t filesize)
 {
     sample_t* s = &tmpSmp;
     char* brrBuffer;
@@ -37,7 +37,7 @@ bool loadBRR(FILE* f, uint32_t filesize)
 
     fileLength = (int32_t)filesize;
 
-    if (fread(brrBuffer, 1, filesize, f) != filesize)
+    if (mread(brrBuffer, 1, filesize, f) != filesize)
     {
         okBoxThreadSafe(0, "System message", "General I/O error during loading! Is the file in use?", NULL);
         free(brrBuffer);
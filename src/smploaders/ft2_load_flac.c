@@ -7,19 +7,9 @@
 
 #ifdef HAS_LIBFLAC
 
-// hide POSIX warning for fileno()
-#ifdef _MSC_VER
-#pragma warning(disable: 4996)
-#endif
-
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
-#ifndef _WIN32
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <unistd.h>
-#endif
 #include "../ft2_header.h"
 #include "../ft2_audio.h"
 #include "../ft2_sample_ed.h"
@@ -46,7 +36,7 @@ static void metadata_callback(const FLAC__StreamDecoder *decoder, const FLAC__St
 static FLAC__StreamDecoderWriteStatus write_callback(const FLAC__StreamDecoder *decoder, const FLAC__Frame *frame, const FLAC__int32 *const buffer[], void *client_data);
 static void error_callback(const FLAC__StreamDecoder *decoder, FLAC__StreamDecoderErrorStatus status, void *client_data);
 
-bool loadFLAC(FILE *f, uint32_t filesize)
+bool loadFLAC(MEMFILE *f, uint32_t filesize)
 {
 	s = &tmpSmp;
 
@@ -108,13 +98,11 @@ error:
 
 static FLAC__StreamDecoderReadStatus read_callback(const FLAC__StreamDecoder *decoder, FLAC__byte buffer[], size_t *bytes, void *client_data)
 {
-	FILE *file = (FILE *)client_data;
+	MEMFILE *file = (MEMFILE *)client_data;
 	if (*bytes > 0)
 	{
-		*bytes = fread(buffer, sizeof (FLAC__byte), *bytes, file);
-		if (ferror(file))
-			return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
-		else if (*bytes == 0)
+		*bytes = mread(buffer, sizeof (FLAC__byte), *bytes, file);
+		if (*bytes == 0)
 			return FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
 		else
 			return FLAC__STREAM_DECODER_READ_STATUS_CONTINUE;
@@ -129,12 +117,12 @@ static FLAC__StreamDecoderReadStatus read_callback(const FLAC__StreamDecoder *de
 
 static FLAC__StreamDecoderSeekStatus seek_callback(const FLAC__StreamDecoder *decoder, FLAC__uint64 absolute_byte_offset, void *client_data)
 {
-	FILE *file = (FILE *)client_data;
+	MEMFILE *file = (MEMFILE *)client_data;
 
 	if (absolute_byte_offset > INT32_MAX)
 		return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
 
-	if (fseek(file, (int32_t)absolute_byte_offset, SEEK_SET) < 0)
+	if (mseek(file, (int32_t)absolute_byte_offset, SEEK_SET) < 0)
 		return FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
 	else
 		return FLAC__STREAM_DECODER_SEEK_STATUS_OK;
@@ -144,8 +132,8 @@ static FLAC__StreamDecoderSeekStatus seek_callback(const FLAC__StreamDecoder *de
 
 static FLAC__StreamDecoderTellStatus tell_callback(const FLAC__StreamDecoder *decoder, FLAC__uint64 *absolute_byte_offset, void *client_data)
 {
-	FILE *file = (FILE *)client_data;
-	int32_t pos = ftell(file);
+	MEMFILE *file = (MEMFILE *)client_data;
+	int32_t pos = mtell(file);
 
 	if (pos < 0)
 	{
@@ -162,26 +150,18 @@ static FLAC__StreamDecoderTellStatus tell_callback(const FLAC__StreamDecoder *de
 
 static FLAC__StreamDecoderLengthStatus length_callback(const FLAC__StreamDecoder *decoder, FLAC__uint64 *stream_length, void *client_data)
 {
-	FILE *file = (FILE *)client_data;
-	struct stat filestats;
+	MEMFILE *file = (MEMFILE *)client_data;
 
-	if (fstat(fileno(file), &filestats) != 0)
-	{
-		return FLAC__STREAM_DECODER_LENGTH_STATUS_ERROR;
-	}
-	else
-	{
-		*stream_length = (FLAC__uint64)filestats.st_size;
-		return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
-	}
+	*stream_length = (FLAC__uint64)file->size;
+	return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
 
 	(void)decoder;
 }
 
 static FLAC__bool eof_callback(const FLAC__StreamDecoder *decoder, void *client_data)
 {
-	FILE *file = (FILE *)client_data;
-	return feof(file) ? true : false;
+	MEMFILE *file = (MEMFILE *)client_data;
+	return meof(file) ? true : false;
 
 	(void)decoder;
 }
@@ -14,7 +14,7 @@
 #include "../ft2_sysreqs.h"
 #include "../ft2_sample_loader.h"
 
-bool loadIFF(FILE *f, uint32_t filesize)
+bool loadIFF(MEMFILE *f, uint32_t filesize)
 {
 	char hdr[4+1];
 	uint32_t length, volume, loopStart, loopLength, sampleRate;
@@ -26,8 +26,8 @@ bool loadIFF(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	fseek(f, 8, SEEK_SET);
-	fread(hdr, 1, 4, f);
+	mseek(f, 8, SEEK_SET);
+	mread(hdr, 1, 4, f);
 	hdr[4] = '\0';
 	bool sample16Bit = !strncmp(hdr, "16SV", 4);
 
@@ -35,12 +35,12 @@ bool loadIFF(FILE *f, uint32_t filesize)
 	uint32_t bodyPtr = 0, bodyLen = 0;
 	uint32_t namePtr = 0, nameLen = 0;
 
-	fseek(f, 12, SEEK_SET);
-	while (!feof(f) && (uint32_t)ftell(f) < filesize-12)
+	mseek(f, 12, SEEK_SET);
+	while (!meof(f) && (uint32_t)mtell(f) < filesize-12)
 	{
 		uint32_t blockName, blockSize;
-		fread(&blockName, 4, 1, f); if (feof(f)) break;
-		fread(&blockSize, 4, 1, f); if (feof(f)) break;
+		mread(&blockName, 4, 1, f); if (meof(f)) break;
+		mread(&blockSize, 4, 1, f); if (meof(f)) break;
 
 		blockName = SWAP32(blockName);
 		blockSize = SWAP32(blockSize);
@@ -49,21 +49,21 @@ bool loadIFF(FILE *f, uint32_t filesize)
 		{
 			case 0x56484452: // VHDR
 			{
-				vhdrPtr = ftell(f);
+				vhdrPtr = mtell(f);
 				vhdrLen = blockSize;
 			}
 			break;
 
 			case 0x4E414D45: // NAME
 			{
-				namePtr = ftell(f);
+				namePtr = mtell(f);
 				nameLen = blockSize;
 			}
 			break;
 
 			case 0x424F4459: // BODY
 			{
-				bodyPtr = ftell(f);
+				bodyPtr = mtell(f);
 				bodyLen = blockSize;
 			}
 			break;
@@ -71,7 +71,7 @@ bool loadIFF(FILE *f, uint32_t filesize)
 			default: break;
 		}
 
-		fseek(f, blockSize + (blockSize & 1), SEEK_CUR);
+		mseek(f, blockSize + (blockSize & 1), SEEK_CUR);
 	}
 
 	if (vhdrPtr == 0 || vhdrLen < 20 || bodyPtr == 0)
@@ -87,20 +87,20 @@ bool loadIFF(FILE *f, uint32_t filesize)
 	if (bodyPtr+bodyLen > (uint32_t)filesize)
 		bodyLen = filesize - bodyPtr;
 
-	fseek(f, vhdrPtr, SEEK_SET);
-	fread(&loopStart,  4, 1, f); loopStart = SWAP32(loopStart);
-	fread(&loopLength, 4, 1, f); loopLength = SWAP32(loopLength);
-	fseek(f, 4, SEEK_CUR);
-	fread(&sampleRate, 2, 1, f); sampleRate = SWAP16(sampleRate);
-	fseek(f, 1, SEEK_CUR);
+	mseek(f, vhdrPtr, SEEK_SET);
+	mread(&loopStart,  4, 1, f); loopStart = SWAP32(loopStart);
+	mread(&loopLength, 4, 1, f); loopLength = SWAP32(loopLength);
+	mseek(f, 4, SEEK_CUR);
+	mread(&sampleRate, 2, 1, f); sampleRate = SWAP16(sampleRate);
+	mseek(f, 1, SEEK_CUR);
 
-	if (fgetc(f) != 0) // sample type
+	if (mgetc(f) != 0) // sample type
 	{
 		loaderMsgBox("Error loading sample: The sample is not supported!");
 		return false;
 	}
 
-	fread(&volume, 4, 1, f); volume = SWAP32(volume);
+	mread(&volume, 4, 1, f); volume = SWAP32(volume);
 	if (volume > 65535)
 		volume = 65535;
 
@@ -124,8 +124,8 @@ bool loadIFF(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	fseek(f, bodyPtr, SEEK_SET);
-	if (fread(s->dataPtr, length << sample16Bit, 1, f) != 1)
+	mseek(f, bodyPtr, SEEK_SET);
+	if (mread(s->dataPtr, length << sample16Bit, 1, f) != 1)
 	{
 		loaderMsgBox("General I/O error during loading! Is the file in use?");
 		return false;
@@ -148,12 +148,12 @@ bool loadIFF(FILE *f, uint32_t filesize)
 	// set name
 	if (namePtr != 0 && nameLen > 0)
 	{
-		fseek(f, namePtr, SEEK_SET);
+		mseek(f, namePtr, SEEK_SET);
 
 		if (nameLen > 22)
 			nameLen = 22;
 
-		fread(s->name, 1, nameLen, f);
+		mread(s->name, 1, nameLen, f);
 		s->name[22] = '\0';
 
 		smpFilenameSet = true;
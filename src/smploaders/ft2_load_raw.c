@@ -11,7 +11,7 @@
 #include "../ft2_sysreqs.h"
 #include "../ft2_sample_loader.h"
 
-bool loadRAW(FILE *f, uint32_t filesize)
+bool loadRAW(MEMFILE *f, uint32_t filesize)
 {
 	sample_t *s = &tmpSmp;
 
@@ -21,7 +21,7 @@ bool loadRAW(FILE *f, uint32_t filesize)
 		return false;
 	}
 
-	if (fread(s->dataPtr, filesize, 1, f) != 1)
+	if (mread(s->dataPtr, filesize, 1, f) != 1)
 	{
 		okBoxThreadSafe(0, "System message", "General I/O error during loading! Is the file in use?", NULL);
 		return false;
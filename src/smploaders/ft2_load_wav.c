@@ -20,9 +20,9 @@ enum
 	WAV_FORMAT_IEEE_FLOAT = 3
 };
 
-static bool wavIsStereo(FILE *f);
+static bool wavIsStereo(MEMFILE *f);
 
-bool loadWAV(FILE *f, uint32_t filesize)
+bool loadWAV(MEMFILE *f, uint32_t filesize)
 {
 	uint8_t *audioDataU8;
 	int16_t *audioDataS16, *ptr16;
@@ -47,28 +47,28 @@ bool loadWAV(FILE *f, uint32_t filesize)
 	uint32_t smplPtr = 0, smplLen = 0;
 
 	// look for wanted chunks and set up pointers + lengths
-	fseek(f, 12, SEEK_SET);
+	mseek(f, 12, SEEK_SET);
 
 	uint32_t bytesRead = 0;
-	while (!feof(f) && bytesRead < filesize-12)
+	while (!meof(f) && bytesRead < filesize-12)
 	{
 		uint32_t chunkID, chunkSize;
-		fread(&chunkID, 4, 1, f); if (feof(f)) break;
-		fread(&chunkSize, 4, 1, f); if (feof(f)) break;
+		mread(&chunkID, 4, 1, f); if (meof(f)) break;
+		mread(&chunkSize, 4, 1, f); if (meof(f)) break;
 
-		uint32_t endOfChunk = (ftell(f) + chunkSize) + (chunkSize & 1);
+		uint32_t endOfChunk = (mtell(f) + chunkSize) + (chunkSize & 1);
 		switch (chunkID)
 		{
 			case 0x20746D66: // "fmt "
 			{
-				fmtPtr = ftell(f);
+				fmtPtr = mtell(f);
 				fmtLen = chunkSize;
 			}
 			break;
 
 			case 0x61746164: // "data"
 			{
-				dataPtr = ftell(f);
+				dataPtr = mtell(f);
 				dataLen = chunkSize;
 			}
 			break;
@@ -77,20 +77,20 @@ bool loadWAV(FILE *f, uint32_t filesize)
 			{
 				if (chunkSize >= 4)
 				{
-					fread(&chunkID, 4, 1, f);
+					mread(&chunkID, 4, 1, f);
 					if (chunkID == 0x4F464E49) // "INFO"
 					{
 						bytesRead = 0;
-						while (!feof(f) && bytesRead < chunkSize)
+						while (!meof(f) && bytesRead < chunkSize)
 						{
-							fread(&chunkID, 4, 1, f);
-							fread(&chunkSize, 4, 1, f);
+							mread(&chunkID, 4, 1, f);
+							mread(&chunkSize, 4, 1, f);
 
 							switch (chunkID)
 							{
 								case 0x4D414E49: // "INAM"
 								{
-									inamPtr = ftell(f);
+									inamPtr = mtell(f);
 									inamLen = chunkSize;
 								}
 								break;
@@ -107,14 +107,14 @@ bool loadWAV(FILE *f, uint32_t filesize)
 
 			case 0x61727478: // "xtra"
 			{
-				xtraPtr = ftell(f);
+				xtraPtr = mtell(f);
 				xtraLen = chunkSize;
 			}
 			break;
 
 			case 0x6C706D73: // "smpl"
 			{
-				smplPtr = ftell(f);
+				smplPtr = mtell(f);
 				smplLen = chunkSize;
 			}
 			break;
@@ -123,7 +123,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 		}
 
 		bytesRead += (chunkSize + (chunkSize & 1));
-		fseek(f, endOfChunk, SEEK_SET);
+		mseek(f, endOfChunk, SEEK_SET);
 	}
 
 	// we need at least "fmt " and "data" - check if we found them sanely
@@ -134,12 +134,12 @@ bool loadWAV(FILE *f, uint32_t filesize)
 	}
 
 	// ---- READ "fmt " CHUNK ----
-	fseek(f, fmtPtr, SEEK_SET);
-	fread(&audioFormat, 2, 1, f);
-	fread(&numChannels, 2, 1, f);
-	fread(&sampleRate,  4, 1, f);
-	fseek(f, 6, SEEK_CUR); // unneeded
-	fread(&bitsPerSample, 2, 1, f);
+	mseek(f, fmtPtr, SEEK_SET);
+	mread(&audioFormat, 2, 1, f);
+	mread(&numChannels, 2, 1, f);
+	mread(&sampleRate,  4, 1, f);
+	mseek(f, 6, SEEK_CUR); // unneeded
+	mread(&bitsPerSample, 2, 1, f);
 	sampleLength = dataLen;
 	// ---------------------------
 
@@ -176,7 +176,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 	}
 
 	// ---- READ SAMPLE DATA ----
-	fseek(f, dataPtr, SEEK_SET);
+	mseek(f, dataPtr, SEEK_SET);
 
 	int16_t stereoSampleLoadMode = -1;
 	if (wavIsStereo(f))
@@ -190,7 +190,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		if (fread(s->dataPtr, sampleLength, 1, f) != 1)
+		if (mread(s->dataPtr, sampleLength, 1, f) != 1)
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -250,7 +250,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		if (fread(s->dataPtr, sampleLength, 2, f) != 2)
+		if (mread(s->dataPtr, sampleLength, 2, f) != 2)
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -312,7 +312,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		if (fread(&s->dataPtr[sampleLength], sampleLength, 3, f) != 3)
+		if (mread(&s->dataPtr[sampleLength], sampleLength, 3, f) != 3)
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -390,7 +390,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		if (fread(s->dataPtr, sampleLength, sizeof (int32_t), f) != sizeof (int32_t))
+		if (mread(s->dataPtr, sampleLength, sizeof (int32_t), f) != sizeof (int32_t))
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -460,7 +460,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		if (fread(s->dataPtr, sampleLength, sizeof (float), f) != sizeof (float))
+		if (mread(s->dataPtr, sampleLength, sizeof (float), f) != sizeof (float))
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -527,7 +527,7 @@ bool loadWAV(FILE *f, uint32_t filesize)
 			return false;
 		}
 
-		if (fread(s->dataPtr, sampleLength, sizeof (double), f) != sizeof (double))
+		if (mread(s->dataPtr, sampleLength, sizeof (double), f) != sizeof (double))
 		{
 			loaderMsgBox("General I/O error during loading! Is the file in use?");
 			return false;
@@ -603,16 +603,16 @@ bool loadWAV(FILE *f, uint32_t filesize)
 	{
 		uint32_t numLoops, loopType, loopStart, loopEnd;
 
-		fseek(f, smplPtr+28, SEEK_SET); // seek to first wanted byte
+		mseek(f, smplPtr+28, SEEK_SET); // seek to first wanted byte
 
-		fread(&numLoops, 4, 1, f);
+		mread(&numLoops, 4, 1, f);
 		if (numLoops == 1)
 		{
-			fseek(f, 4+4, SEEK_CUR); // skip "samplerData" and "identifier"
+			mseek(f, 4+4, SEEK_CUR); // skip "samplerData" and "identifier"
 
-			fread(&loopType, 4, 1, f);
-			fread(&loopStart, 4, 1, f);
-			fread(&loopEnd, 4, 1, f);
+			mread(&loopType, 4, 1, f);
+			mread(&loopStart, 4, 1, f);
+			mread(&loopEnd, 4, 1, f);
 
 			loopEnd++;
 			if (loopEnd <= sampleLength)
@@ -631,13 +631,13 @@ bool loadWAV(FILE *f, uint32_t filesize)
 		uint16_t tmpPan, tmpVol;
 		uint32_t xtraFlags;
 
-		fseek(f, xtraPtr, SEEK_SET);
-		fread(&xtraFlags, 4, 1, f); // flags
+		mseek(f, xtraPtr, SEEK_SET);
+		mread(&xtraFlags, 4, 1, f); // flags
 
 		// panning (0..256)
 		if (xtraFlags & 0x20) // set panning flag
 		{
-			fread(&tmpPan, 2, 1, f);
+			mread(&tmpPan, 2, 1, f);
 			if (tmpPan > 255)
 				tmpPan = 255;
 
@@ -646,11 +646,11 @@ bool loadWAV(FILE *f, uint32_t filesize)
 		else
 		{
 			// don't read panning, skip it
-			fseek(f, 2, SEEK_CUR);
+			mseek(f, 2, SEEK_CUR);
 		}
 
 		// volume (0..256)
-		fread(&tmpVol, 2, 1, f);
+		mread(&tmpVol, 2, 1, f);
 		if (tmpVol > 256)
 			tmpVol = 256;
 
@@ -661,11 +661,11 @@ bool loadWAV(FILE *f, uint32_t filesize)
 	// ---- READ "INAM" chunk ----
 	if (inamPtr != 0 && inamLen > 0)
 	{
-		fseek(f, inamPtr, SEEK_SET);
+		mseek(f, inamPtr, SEEK_SET);
 		if (inamLen > 22)
 			inamLen = 22;
 
-		fread(s->name, 1, inamLen, f);
+		mread(s->name, 1, inamLen, f);
 		s->name[22] = '\0';
 
 		smpFilenameSet = true;
@@ -674,39 +674,39 @@ bool loadWAV(FILE *f, uint32_t filesize)
 	return true;
 }
 
-static bool wavIsStereo(FILE *f)
+static bool wavIsStereo(MEMFILE *f)
 {
 	uint16_t numChannels;
 	uint32_t chunkID, chunkSize;
 
-	uint32_t oldPos = ftell(f);
+	uint32_t oldPos = mtell(f);
 
-	fseek(f, 0, SEEK_END);
-	int32_t filesize = ftell(f);
+	mseek(f, 0, SEEK_END);
+	int32_t filesize = mtell(f);
 
 	if (filesize < 12)
 	{
-		fseek(f, oldPos, SEEK_SET);
+		mseek(f, oldPos, SEEK_SET);
 		return false;
 	}
 
-	fseek(f, 12, SEEK_SET);
+	mseek(f, 12, SEEK_SET);
 
 	uint32_t fmtPtr = 0;
 	uint32_t fmtLen = 0;
 
 	int32_t bytesRead = 0;
-	while (!feof(f) && bytesRead < filesize-12)
+	while (!meof(f) && bytesRead < filesize-12)
 	{
-		fread(&chunkID, 4, 1, f); if (feof(f)) break;
-		fread(&chunkSize, 4, 1, f); if (feof(f)) break;
+		mread(&chunkID, 4, 1, f); if (meof(f)) break;
+		mread(&chunkSize, 4, 1, f); if (meof(f)) break;
 
-		int32_t endOfChunk = (ftell(f) + chunkSize) + (chunkSize & 1);
+		int32_t endOfChunk = (mtell(f) + chunkSize) + (chunkSize & 1);
 		switch (chunkID)
 		{
 			case 0x20746D66: // "fmt "
 			{
-				fmtPtr = ftell(f);
+				fmtPtr = mtell(f);
 				fmtLen = chunkSize;
 			}
 			break;
@@ -715,18 +715,18 @@ static bool wavIsStereo(FILE *f)
 		}
 
 		bytesRead += (chunkSize + (chunkSize & 1));
-		fseek(f, endOfChunk, SEEK_SET);
+		mseek(f, endOfChunk, SEEK_SET);
 	}
 
 	if (fmtPtr == 0 || fmtLen < 4)
 	{
-		fseek(f, oldPos, SEEK_SET);
+		mseek(f, oldPos, SEEK_SET);
 		return false;
 	}
 
-	fseek(f, fmtPtr + 2, SEEK_SET);
-	fread(&numChannels, 2, 1, f);
+	mseek(f, fmtPtr + 2, SEEK_SET);
+	mread(&numChannels, 2, 1, f);
 
-	fseek(f, oldPos, SEEK_SET);
+	mseek(f, oldPos, SEEK_SET);
 	return (numChannels == 2);
 }
@@ -0,0 +1,74 @@
+/* Windowed-sinc table generator (ft2-sincgen, built and run by CMakeLists.txt)
+**
+** Computes the tables with the same code the program uses on startup (mixer/ft2_windowed_sinc.c),
+** and writes them out as a C header. The program is then built with HAS_PRECOMPUTED_SINC, and
+** calcWindowedSincTables() only has to set up the table pointers. Hexadecimal float literals
+** are used, so the tables are bit-exact.
+**
+** Usage: ft2-sincgen <output.h>
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include "../mixer/ft2_windowed_sinc.h"
+
+// calcWindowedSincTables() needs this (normally found in ft2_video.c)
+void showErrorMsgBox(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+
+	fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: ft2-sincgen <output.h>\n");
+		return 1;
+	}
+
+	if (!calcWindowedSincTables())
+		return 1;
+
+	FILE *f = fopen(argv[1], "w");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Error: Couldn't create \"%s\"!\n", argv[1]);
+		freeWindowedSincTables();
+		return 1;
+	}
+
+	fprintf(f, "// generated by ft2-sincgen (src/tools/ft2_sinc_gen.c), do not edit\n\n");
+	fprintf(f, "#pragma once\n\n");
+	fprintf(f, "static const float fSincTableData[%d] =\n{\n", SINC_TABLES_SIZE);
+
+	const float *fData = fKaiserSinc_8; // start of all the tables
+	for (int32_t i = 0; i < SINC_TABLES_SIZE; i += 8)
+	{
+		fprintf(f, "\t");
+		for (int32_t j = 0; j < 8; j++)
+			fprintf(f, "%af,", (double)fData[i+j]);
+
+		fprintf(f, "\n");
+	}
+
+	fprintf(f, "};\n");
+
+	const bool writeError = (ferror(f) != 0);
+	if (fclose(f) != 0 || writeError)
+	{
+		fprintf(stderr, "Error: Couldn't write \"%s\"!\n", argv[1]);
+		freeWindowedSincTables();
+		return 1;
+	}
+
+	freeWindowedSincTables();
+	return 0;
+}